@@ -0,0 +1,279 @@
+// Copyright 2024 Marchetti S. César A. All Rights Reserved.
+
+#include "AbilitySystem/AbilityAssetManifest.h"
+#include "Engine/AssetManager.h"
+#include "Engine/StreamableManager.h"
+#include "Materials/MaterialInterface.h"
+#include "AbilitySystemGlobals.h"
+#include "GameplayCueManager.h"
+#include "GameplayCueSet.h"
+#if WITH_EDITOR
+#include "AssetRegistry/AssetRegistryModule.h"
+#endif
+
+DEFINE_LOG_CATEGORY_STATIC(LogAbilityAssetManifest, Log, All);
+
+int32 UAbilityAssetPreloadSubsystem::NumWorlds = 0;
+
+UAbilityAssetManifest::UAbilityAssetManifest()
+{
+	CategoryName = TEXT("Game");
+
+	DecalMaterials.Add(EOverlapAbilityShape::Sphere, TSoftObjectPtr<UMaterialInterface>(FSoftObjectPath(TEXT("/Game/Materials/Decals/M_Decal_Circle_Gradient.M_Decal_Circle_Gradient"))));
+	DecalMaterials.Add(EOverlapAbilityShape::Box, TSoftObjectPtr<UMaterialInterface>(FSoftObjectPath(TEXT("/Game/Materials/Decals/M_Decal_Square_Gradient.M_Decal_Square_Gradient"))));
+	DecalMaterials.Add(EOverlapAbilityShape::Capsule, TSoftObjectPtr<UMaterialInterface>(FSoftObjectPath(TEXT("/Game/Materials/Decals/M_Decal_Square_Gradient.M_Decal_Square_Gradient"))));
+
+	//Circular decals, the inner radius and half angle come from the visualization params.
+	DecalMaterials.Add(EOverlapAbilityShape::Cone, TSoftObjectPtr<UMaterialInterface>(FSoftObjectPath(TEXT("/Game/Materials/Decals/M_Decal_Circle_Gradient.M_Decal_Circle_Gradient"))));
+	DecalMaterials.Add(EOverlapAbilityShape::Ring, TSoftObjectPtr<UMaterialInterface>(FSoftObjectPath(TEXT("/Game/Materials/Decals/M_Decal_Circle_Gradient.M_Decal_Circle_Gradient"))));
+	DecalMaterials.Add(EOverlapAbilityShape::Sector, TSoftObjectPtr<UMaterialInterface>(FSoftObjectPath(TEXT("/Game/Materials/Decals/M_Decal_Circle_Gradient.M_Decal_Circle_Gradient"))));
+}
+
+void UAbilityAssetManifest::PreloadSharedAssets()
+{
+	TArray<FSoftObjectPath> Paths;
+	for (const auto& it : DecalMaterials)
+	{
+		if (!it.Value.IsNull())
+		{
+			Paths.Add(it.Value.ToSoftObjectPath());
+		}
+	}
+	RequestAsyncLoad(MoveTemp(Paths));
+}
+
+void UAbilityAssetManifest::PreloadAllAbilities()
+{
+	TArray<FSoftObjectPath> Paths;
+	for (const FAbilityAssetManifestEntry& Entry : Entries)
+	{
+		GatherEntryAssets(Entry, Paths);
+	}
+	RequestAsyncLoad(MoveTemp(Paths));
+}
+
+void UAbilityAssetManifest::PreloadAbilityAssets(const UBaseOverlapAbility* Ability)
+{
+	//Visualization and cues are never shown on a dedicated server
+	if (!Ability || IsRunningDedicatedServer())
+	{
+		return;
+	}
+
+	FAbilityAssetManifestEntry Entry;
+	Ability->GetAssetManifestEntry(Entry);
+
+	TArray<FSoftObjectPath> Paths;
+	GatherEntryAssets(Entry, Paths);
+	RequestAsyncLoad(MoveTemp(Paths));
+}
+
+UMaterialInterface* UAbilityAssetManifest::GetDecalMaterial(EOverlapAbilityShape Shape)
+{
+	if (const TObjectPtr<UMaterialInterface>* Resolved = ResolvedDecalMaterials.Find(Shape))
+	{
+		return *Resolved;
+	}
+
+	const TSoftObjectPtr<UMaterialInterface>* SoftMaterial = DecalMaterials.Find(Shape);
+	if (!SoftMaterial || SoftMaterial->IsNull())
+	{
+		return nullptr;
+	}
+
+	UMaterialInterface* Material = SoftMaterial->Get();
+	if (!Material)
+	{
+		UE_LOG(LogAbilityAssetManifest, Warning, TEXT("UAbilityAssetManifest::GetDecalMaterial: %s was not preloaded, loading it synchronously"), *SoftMaterial->ToString());
+		Material = SoftMaterial->LoadSynchronous();
+	}
+
+	if (Material)
+	{
+		ResolvedDecalMaterials.Add(Shape, Material);
+	}
+
+	return Material;
+}
+
+FSoftObjectPath UAbilityAssetManifest::FindGameplayCueNotifyPath(const FGameplayTag& CueTag)
+{
+	if (!CueTag.IsValid())
+	{
+		return FSoftObjectPath();
+	}
+
+	UGameplayCueManager* const CueManager = UAbilitySystemGlobals::Get().GetGameplayCueManager();
+	UGameplayCueSet* const CueSet = CueManager ? CueManager->GetRuntimeCueSet() : nullptr;
+	if (!CueSet)
+	{
+		return FSoftObjectPath();
+	}
+
+	const int32* Index = CueSet->GameplayCueDataMap.Find(CueTag);
+	if (!Index || !CueSet->GameplayCueData.IsValidIndex(*Index))
+	{
+		return FSoftObjectPath();
+	}
+
+	return CueSet->GameplayCueData[*Index].GameplayCueNotifyObj;
+}
+
+void UAbilityAssetManifest::GatherEntryAssets(const FAbilityAssetManifestEntry& Entry, TArray<FSoftObjectPath>& OutPaths) const
+{
+	if (const TSoftObjectPtr<UMaterialInterface>* SoftMaterial = DecalMaterials.Find(Entry.Shape))
+	{
+		if (!SoftMaterial->IsNull())
+		{
+			OutPaths.Add(SoftMaterial->ToSoftObjectPath());
+		}
+	}
+
+	const FSoftObjectPath CuePath = FindGameplayCueNotifyPath(Entry.GameplayCueTag);
+	if (CuePath.IsValid())
+	{
+		OutPaths.Add(CuePath);
+	}
+
+	for (const FSoftObjectPath& Path : Entry.AdditionalAssets)
+	{
+		if (Path.IsValid())
+		{
+			OutPaths.Add(Path);
+		}
+	}
+}
+
+void UAbilityAssetManifest::RequestAsyncLoad(TArray<FSoftObjectPath>&& Paths)
+{
+	//Paths are only marked as requested once they can actually be requested, early calls are retried by the next preload.
+	if (!UAssetManager::IsInitialized())
+	{
+		return;
+	}
+
+	Paths.RemoveAll([this](const FSoftObjectPath& Path)
+	{
+		bool bAlreadyRequested = false;
+		RequestedPaths.Add(Path, &bAlreadyRequested);
+		return bAlreadyRequested;
+	});
+
+	if (Paths.IsEmpty())
+	{
+		return;
+	}
+
+	TSharedPtr<FStreamableHandle> Handle = UAssetManager::GetStreamableManager().RequestAsyncLoad(MoveTemp(Paths), FStreamableDelegate::CreateUObject(this, &UAbilityAssetManifest::ResolveDecalMaterials));
+	if (Handle.IsValid())
+	{
+		Handles.Add(Handle);
+	}
+}
+
+void UAbilityAssetManifest::ReleaseAssets()
+{
+	for (const TSharedPtr<FStreamableHandle>& Handle : Handles)
+	{
+		Handle->ReleaseHandle();
+	}
+
+	Handles.Empty();
+	RequestedPaths.Empty();
+	ResolvedDecalMaterials.Empty();
+}
+
+void UAbilityAssetManifest::ResolveDecalMaterials()
+{
+	for (const auto& it : DecalMaterials)
+	{
+		if (UMaterialInterface* Material = it.Value.Get())
+		{
+			ResolvedDecalMaterials.Add(it.Key, Material);
+		}
+	}
+}
+
+#if WITH_EDITOR
+void UAbilityAssetManifest::RebuildEntries()
+{
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+	AssetRegistry.SearchAllAssets(true);
+
+	TSet<FTopLevelAssetPath> DerivedClasses;
+	AssetRegistry.GetDerivedClassNames({ UBaseOverlapAbility::StaticClass()->GetClassPathName() }, {}, DerivedClasses);
+
+	Entries.Reset();
+	for (const FTopLevelAssetPath& ClassPath : DerivedClasses)
+	{
+		const FString ClassName = ClassPath.GetAssetName().ToString();
+		if (ClassName.StartsWith(TEXT("SKEL_")) || ClassName.StartsWith(TEXT("REINST_")))
+		{
+			continue;
+		}
+
+		UClass* const Class = TSoftClassPtr<UBaseOverlapAbility>(FSoftObjectPath(ClassPath)).LoadSynchronous();
+		if (!Class || Class->HasAnyClassFlags(CLASS_Abstract | CLASS_Deprecated | CLASS_NewerVersionExists))
+		{
+			continue;
+		}
+
+		GetDefault<UBaseOverlapAbility>(Class)->GetAssetManifestEntry(Entries.AddDefaulted_GetRef());
+	}
+
+	Entries.Sort([](const FAbilityAssetManifestEntry& A, const FAbilityAssetManifestEntry& B)
+	{
+		return A.AbilityClass.ToString() < B.AbilityClass.ToString();
+	});
+
+	TryUpdateDefaultConfigFile();
+	UE_LOG(LogAbilityAssetManifest, Log, TEXT("UAbilityAssetManifest::RebuildEntries: %d overlap abilities written to the manifest"), Entries.Num());
+}
+
+static FAutoConsoleCommand RebuildAbilityAssetManifestCommand(
+	TEXT("AbilitySystem.AssetManifest.Rebuild"),
+	TEXT("Rebuilds the ability asset manifest from every overlap ability class and saves it to DefaultGame.ini. Run it before cooking."),
+	FConsoleCommandDelegate::CreateLambda([]()
+		{
+			UAbilityAssetManifest::Get().RebuildEntries();
+		}));
+#endif
+
+bool UAbilityAssetPreloadSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	return !IsRunningDedicatedServer() && Super::ShouldCreateSubsystem(Outer);
+}
+
+void UAbilityAssetPreloadSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	NumWorlds++;
+}
+
+void UAbilityAssetPreloadSubsystem::Deinitialize()
+{
+	if (--NumWorlds == 0)
+	{
+		UAbilityAssetManifest::Get().ReleaseAssets();
+	}
+
+	Super::Deinitialize();
+}
+
+void UAbilityAssetPreloadSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	UAbilityAssetManifest& Manifest = UAbilityAssetManifest::Get();
+	Manifest.PreloadSharedAssets();
+	if (Manifest.bPreloadAllOnMapLoad)
+	{
+		Manifest.PreloadAllAbilities();
+	}
+}
+
+bool UAbilityAssetPreloadSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
@@ -0,0 +1,124 @@
+// Copyright 2024 Marchetti S. César A. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DeveloperSettings.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "GameplayTagContainer.h"
+#include "AbilitySystem/Abilities/BaseOverlapAbility.h"
+#include "AbilityAssetManifest.generated.h"
+
+class UMaterialInterface;
+struct FStreamableHandle;
+
+/** Assets an ability class needs to show its visualization and cues.*/
+USTRUCT(BlueprintType)
+struct CAMERAPLAY_API FAbilityAssetManifestEntry
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Manifest")
+	TSoftClassPtr<UBaseOverlapAbility> AbilityClass;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Manifest")
+	EOverlapAbilityShape Shape = EOverlapAbilityShape::Sphere;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Manifest")
+	FGameplayTag GameplayCueTag;
+
+	/** Any other asset the ability resolves at first use.*/
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Manifest")
+	TArray<FSoftObjectPath> AdditionalAssets;
+};
+
+/**
+*	Visualization and cue assets of the overlap abilities.
+*	Assets are requested asynchronously when an ability is granted and at map load, lookups are then served from a resolved table so aiming an ability never loads synchronously.
+*	Entries are rebuilt in the editor with AbilitySystem.AssetManifest.Rebuild and saved to DefaultGame.ini.
+*/
+UCLASS(Config = Game, DefaultConfig, meta = (DisplayName = "Ability Asset Manifest"))
+class CAMERAPLAY_API UAbilityAssetManifest : public UDeveloperSettings
+{
+	GENERATED_BODY()
+
+public:
+
+	UAbilityAssetManifest();
+
+	static UAbilityAssetManifest& Get() { return *GetMutableDefault<UAbilityAssetManifest>(); }
+
+	/** Requests the decal materials of every shape.*/
+	void PreloadSharedAssets();
+
+	/** Requests the assets of every ability in the manifest.*/
+	void PreloadAllAbilities();
+
+	/** Requests the assets of this ability. Built from the ability itself, so it doesn't depend on the manifest being up to date.*/
+	void PreloadAbilityAssets(const UBaseOverlapAbility* Ability);
+
+	/** Decal material of the shape. Loads synchronously, with a warning, if it wasn't preloaded.*/
+	UMaterialInterface* GetDecalMaterial(EOverlapAbilityShape Shape);
+
+	/** Path of the notify bound to the cue tag in the runtime cue set. Invalid if the cue manager doesn't know it.*/
+	static FSoftObjectPath FindGameplayCueNotifyPath(const FGameplayTag& CueTag);
+
+	/** Releases every requested asset, so they can be unloaded with the world that needed them. The next preload requests them again.*/
+	void ReleaseAssets();
+
+#if WITH_EDITOR
+	/** Rebuilds the entries from every overlap ability class known to the asset registry and saves them to the default config.*/
+	void RebuildEntries();
+#endif
+
+	UPROPERTY(Config, EditAnywhere, Category = "Visualization")
+	TMap<EOverlapAbilityShape, TSoftObjectPtr<UMaterialInterface>> DecalMaterials;
+
+	UPROPERTY(Config, EditAnywhere, Category = "Abilities")
+	TArray<FAbilityAssetManifestEntry> Entries;
+
+	/** Preload the assets of every ability in the manifest at map load, instead of waiting for them to be granted.*/
+	UPROPERTY(Config, EditAnywhere, Category = "Abilities")
+	bool bPreloadAllOnMapLoad = false;
+
+private:
+
+	void GatherEntryAssets(const FAbilityAssetManifestEntry& Entry, TArray<FSoftObjectPath>& OutPaths) const;
+
+	void RequestAsyncLoad(TArray<FSoftObjectPath>&& Paths);
+
+	void ResolveDecalMaterials();
+
+	/** Decal materials that finished loading.*/
+	UPROPERTY(Transient)
+	TMap<EOverlapAbilityShape, TObjectPtr<UMaterialInterface>> ResolvedDecalMaterials;
+
+	/** Paths already requested, so granting the same ability again doesn't queue new loads.*/
+	TSet<FSoftObjectPath> RequestedPaths;
+
+	/** Keep the loaded assets alive until the last game world is torn down, see ReleaseAssets.*/
+	TArray<TSharedPtr<FStreamableHandle>> Handles;
+};
+
+/** Requests the shared ability assets, and optionally the whole manifest, when a game world begins play. Releases them when the last game world is torn down.*/
+UCLASS()
+class CAMERAPLAY_API UAbilityAssetPreloadSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+protected:
+
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+
+	/** Game worlds alive, several in multiplayer PIE. They share the manifest.*/
+	static int32 NumWorlds;
+};
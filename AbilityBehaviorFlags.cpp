@@ -0,0 +1,33 @@
+// Copyright 2024 Marchetti S. César A. All Rights Reserved.
+
+#include "AbilitySystem/AbilityBehaviorFlags.h"
+#include "AbilitySystem/GlobalTags.h"
+
+EAbilityBehaviorFlags AbilityBehaviorFlags::FromTags(const FGameplayTagContainer& Tags)
+{
+	EAbilityBehaviorFlags Flags = EAbilityBehaviorFlags::None;
+	if (Tags.IsEmpty())
+	{
+		return Flags;
+	}
+
+	auto AddFlag = [&Tags, &Flags](const FGameplayTag& Tag, EAbilityBehaviorFlags Flag)
+	{
+		if (Tags.HasTag(Tag))
+		{
+			Flags |= Flag;
+		}
+	};
+
+	AddFlag(UGlobalTags::Ability_SpawnBatch(), EAbilityBehaviorFlags::SpawnBatch);
+	AddFlag(UGlobalTags::Ability_Targeting_IndividualTargeting(), EAbilityBehaviorFlags::IndividualTargeting);
+	AddFlag(UGlobalTags::Ability_DisableMultipleSpawn(), EAbilityBehaviorFlags::DisableMultipleSpawn);
+	AddFlag(UGlobalTags::Ability_Targeting_Start_Actor_Avatar(), EAbilityBehaviorFlags::StartAtAvatar);
+	AddFlag(UGlobalTags::Ability_DisableAngleSpanModifiers(), EAbilityBehaviorFlags::DisableAngleSpanModifiers);
+	AddFlag(UGlobalTags::Ability_DisableExpiration(), EAbilityBehaviorFlags::DisableExpiration);
+	AddFlag(UGlobalTags::Ability_Device_Trap_Enviroment(), EAbilityBehaviorFlags::TrapEnviroment);
+	AddFlag(UGlobalTags::Ability_Device_Mine(), EAbilityBehaviorFlags::DeviceMine);
+	AddFlag(UGlobalTags::Ability_Device_Trap(), EAbilityBehaviorFlags::DeviceTrap);
+
+	return Flags;
+}
@@ -0,0 +1,31 @@
+// Copyright 2024 Marchetti S. César A. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+
+/**
+*	Behavior tags that are checked in hot paths, as bit flags.
+*	Resolved once when the ability tags are set so per snapshot and per hit checks are a single bit test instead of a tag container search.
+*/
+enum class EAbilityBehaviorFlags : uint32
+{
+	None						= 0,
+	SpawnBatch					= 1 << 0,
+	IndividualTargeting			= 1 << 1,
+	DisableMultipleSpawn		= 1 << 2,
+	StartAtAvatar				= 1 << 3,
+	DisableAngleSpanModifiers	= 1 << 4,
+	DisableExpiration			= 1 << 5,
+	TrapEnviroment				= 1 << 6,
+	DeviceMine					= 1 << 7,
+	DeviceTrap					= 1 << 8,
+};
+ENUM_CLASS_FLAGS(EAbilityBehaviorFlags);
+
+namespace AbilityBehaviorFlags
+{
+	/** Maps the behavior tags in the container to their flags.*/
+	CAMERAPLAY_API EAbilityBehaviorFlags FromTags(const FGameplayTagContainer& Tags);
+}
@@ -4,6 +4,7 @@
 #include "Bounty/BaseBountyComponent.h"
 #include "Bounty/BountyObjectData.h"
 #include "AbilitySystem/AbilitySystemComponents/BaseAbilitySystemComponent.h"
+#include "AbilitySystem/ModifiedAbilityCache.h"
 #include "AbilitySystem/GameplayData/GameplayDataSubsystem.h"
 #include "AbilitySystem/GameplayData/GameplayDataAbility.h"
 #include "AbilitySystem/GameplayData/GameplayDataAbilityModifier.h"
@@ -117,19 +118,22 @@ void UAbilityBountyObject::GenerateModifiers()
 {
 	if (const int32 ModifierAmount = BountyObjectData->GetMagnitudeByName(FName("ModifierAmount"), GetBountyLevel()); ModifierAmount > 0)
 	{
-		FModifiedAbility NewModifiedAbility = GetModifiedAbilityForGeneration();		
+		//Each pick is looked up with the tags picked so far, bounties rolling the same picks share the modified abilities.
+		TArray<FGameplayTag> PickedModifierTags;
+		TSharedRef<const FModifiedAbility> NewModifiedAbility = FModifiedAbilityCache::Get(AbilityClass, AbilityLevel, MakeArrayView(PickedModifierTags));
 		TArray<FGameplayTag> IgnoredModifiers;
 		GetIgnoredModifiers(IgnoredModifiers);
 
 		for (int32 Mod = 0; Mod < ModifierAmount; Mod++)
 		{
-			UGameplayDataAbilityModifier* SelectedModifier = GetGameplayDataSubsystem()->GetRandomValidModifierForAbility(NewModifiedAbility, IgnoredModifiers);
+			UGameplayDataAbilityModifier* SelectedModifier = GetGameplayDataSubsystem()->GetRandomValidModifierForAbility(*NewModifiedAbility, IgnoredModifiers);
 			if(!SelectedModifier)
 			{
 				break;
 			}
 
-			NewModifiedAbility.ApplyModifier(SelectedModifier);
+			PickedModifierTags.Add(SelectedModifier->ModifierTag);
+			NewModifiedAbility = FModifiedAbilityCache::Get(AbilityClass, AbilityLevel, MakeArrayView(PickedModifierTags));
 			const int32 ModifierLevel = FMath::Max(
 				GetAbilitySystemComponent()->GetAbilityModifierLevel(SelectedModifier->ModifierTag),
 				BountyObjectData->GetMagnitudeByName(FName("ModifierLevel"),
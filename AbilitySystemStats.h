@@ -0,0 +1,8 @@
+// Copyright 2024 Marchetti S. César A. All Rights Reserved.
+
+#pragma once
+
+#include "Stats/Stats.h"
+
+/** Performance counters for the ability system hot paths. Use "stat AbilitySystemPerf" to see them.*/
+DECLARE_STATS_GROUP(TEXT("AbilitySystem Performance"), STATGROUP_AbilitySystemPerf, STATCAT_Advanced);
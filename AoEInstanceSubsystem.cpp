@@ -0,0 +1,279 @@
+// Copyright 2024 Marchetti S. César A. All Rights Reserved.
+
+#include "AbilitySystem/CollisionActors/AoEInstanceSubsystem.h"
+#include "AbilitySystem/AbilitySystemStats.h"
+#include "AbilitySystem/AbilitySystemComponents/BaseAbilitySystemComponent.h"
+#include "Engine/World.h"
+#include "Kismet/KismetSystemLibrary.h"
+
+DECLARE_CYCLE_STAT(TEXT("AoE Instances Tick"), STAT_AoEInstancesTick, STATGROUP_AbilitySystemPerf);
+DECLARE_DWORD_COUNTER_STAT(TEXT("AoE Instances"), STAT_AoEInstances, STATGROUP_AbilitySystemPerf);
+
+int32 EnableAoEInstances = 1;
+static FAutoConsoleVariableRef CVarEnableAoEInstances(TEXT("AbilitySystem.AoEInstances"), EnableAoEInstances, TEXT("Run instant and periodic areas of classes with bAllowActorlessInstances as actorless instances on the server. Values are 0 or 1, applied on the next activation."), ECVF_Default);
+
+bool UAoEInstanceSubsystem::IsEnabled()
+{
+	return EnableAoEInstances != 0;
+}
+
+void UAoEInstanceSubsystem::Deinitialize()
+{
+	//Give the instigators their data back. No executor step runs here, it could spawn an executor while the world is torn down.
+	for (TArray<FAoEInstance>* InstanceArray : { &Instances, &PendingInstances })
+	{
+		for (FAoEInstance& Instance : *InstanceArray)
+		{
+			ReleaseInstigatorData(Instance);
+		}
+	}
+
+	Instances.Empty();
+	PendingInstances.Empty();
+	Executors.Empty();
+	FreeExecutors.Empty();
+
+	Super::Deinitialize();
+}
+
+TStatId UAoEInstanceSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UAoEInstanceSubsystem, STATGROUP_Tickables);
+}
+
+void UAoEInstanceSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (Instances.IsEmpty())
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_AoEInstancesTick);
+
+	const float Now = GetWorldTime();
+	bTicking = true;
+
+	//Step in spawn order and compact released instances away.
+	int32 NumKept = 0;
+	for (int32 i = 0; i < Instances.Num(); i++)
+	{
+		if (!StepInstance(Instances[i], Now))
+		{
+			if (NumKept != i)
+			{
+				Instances[NumKept] = MoveTemp(Instances[i]);
+			}
+			NumKept++;
+		}
+	}
+	Instances.SetNum(NumKept);
+
+	bTicking = false;
+
+	if (!PendingInstances.IsEmpty())
+	{
+		Instances.Append(MoveTemp(PendingInstances));
+		PendingInstances.Reset();
+	}
+
+	SET_DWORD_STAT(STAT_AoEInstances, Instances.Num());
+}
+
+bool UAoEInstanceSubsystem::SpawnAoEInstance(TSubclassOf<ABaseCollisionActor> Class, const FTransform& Transform, AActor* Owner, APawn* Instigator, const FCollisionActorIndividualData& InIndividualData, const FCollisionActorSharedData& InSharedData, const FGameplayEffectContainerSpec& InEffectContainerSpec)
+{
+	UWorld* World = GetWorld();
+	if (!Class || !World || World->GetNetMode() == NM_Client)
+	{
+		return false;
+	}
+
+	if (!Class.GetDefaultObject()->CanRunActorless(InEffectContainerSpec))
+	{
+		return false;
+	}
+
+	FAoEInstance Instance;
+	Instance.Class = Class;
+	Instance.Owner = Owner;
+	Instance.Instigator = Instigator;
+	Instance.Transform = Transform;
+
+	//Same order as spawning the actor and preactivating it.
+	const float Now = GetWorldTime();
+	float ActivationDelay = 0.f;
+	RunOnExecutor(Instance, [&](ABaseCollisionActor* Executor)
+	{
+		Executor->SetEffectContainerSpec(InEffectContainerSpec);
+		Executor->SetIndividualData(InIndividualData);
+		Executor->SetSharedData(InSharedData);
+		ActivationDelay = Executor->BeginAoEInstance();
+	});
+	Instance.ActivateTime = Now + ActivationDelay;
+
+	//Instant areas apply their effects right away, like the actor would on its first activation.
+	if (StepInstance(Instance, Now))
+	{
+		return true;
+	}
+
+	//Instances stepping now can't be moved, new ones wait until the tick is over.
+	(bTicking ? PendingInstances : Instances).Add(MoveTemp(Instance));
+	return true;
+}
+
+int32 UAoEInstanceSubsystem::GetNumInstances() const
+{
+	return Instances.Num() + PendingInstances.Num();
+}
+
+bool UAoEInstanceSubsystem::StepInstance(FAoEInstance& Instance, float Now)
+{
+	if (Instance.Phase == EAoEInstancePhase::Preactivation)
+	{
+		if (Now < Instance.ActivateTime)
+		{
+			return false;
+		}
+
+		float FirstPeriodDelay = 0.f;
+		RunOnExecutor(Instance, [&FirstPeriodDelay](ABaseCollisionActor* Executor)
+		{
+			Executor->FinishActivateAoEInstance();
+			FirstPeriodDelay = Executor->Duration.LifeSpan != 0.f ? Executor->StaggerFirstPeriodDelay() : 0.f;
+		});
+		Instance.Phase = EAoEInstancePhase::Active;
+
+		if (Instance.Duration.LifeSpan == 0.f)
+		{
+			DeactivateInstance(Instance, Now, 0.5f);
+			return false;
+		}
+
+		//The timers of InitializePersistentElements and InitExpirationTimer.
+		Instance.NextPeriodTime = Now + FirstPeriodDelay;
+		Instance.ExpireTime = Instance.Duration.LifeSpan > 0.f && !EnumHasAnyFlags(Instance.State.OwningAbilityFlags, EAbilityBehaviorFlags::DisableExpiration) ? Now + Instance.Duration.LifeSpan : -1.f;
+		return false;
+	}
+
+	if (Instance.Phase == EAoEInstancePhase::Active)
+	{
+		//Periods keep going after expiration until the last one, as with the actor.
+		while (Instance.State.ExecutedPeriods < Instance.State.MaximumPeriodsToExecute && Now >= Instance.NextPeriodTime)
+		{
+			RunOnExecutor(Instance, [](ABaseCollisionActor* Executor) { Executor->ExecuteAoEInstancePeriod(); });
+			Instance.NextPeriodTime += Instance.Duration.Period;
+		}
+
+		if (!Instance.bExpired && Instance.ExpireTime >= 0.f && Now >= Instance.ExpireTime)
+		{
+			Instance.bExpired = true;
+		}
+
+		if (Instance.State.ExecutedPeriods >= Instance.State.MaximumPeriodsToExecute && (Instance.bExpired || Instance.ExpireTime < 0.f))
+		{
+			DeactivateInstance(Instance, Now, 0.25f);
+		}
+
+		return false;
+	}
+
+	//Released a bit after deactivation, so other instances of the activation can still check the shared targets.
+	if (Now < Instance.ReleaseTime)
+	{
+		return false;
+	}
+
+	RunOnExecutor(Instance, [](ABaseCollisionActor* Executor) { Executor->ReleaseAoEInstance(); });
+	return true;
+}
+
+void UAoEInstanceSubsystem::DeactivateInstance(FAoEInstance& Instance, float Now, float ReleaseDelay)
+{
+	if (Instance.Phase == EAoEInstancePhase::Deactivated)
+	{
+		return;
+	}
+
+	RunOnExecutor(Instance, [](ABaseCollisionActor* Executor) { Executor->DeactivateAoEInstance(); });
+	Instance.Phase = EAoEInstancePhase::Deactivated;
+	Instance.ReleaseTime = Now + ReleaseDelay;
+}
+
+void UAoEInstanceSubsystem::ReleaseInstigatorData(FAoEInstance& Instance)
+{
+	//Same as ABaseCollisionActor::ReleaseInstigatorData, instances are never part of a volley.
+	if (UBaseAbilitySystemComponent* const BaseASC = Instance.State.InstigatorBaseASC)
+	{
+		BaseASC->CollisionActorIndividualData.Items.Remove(Instance.State.IndividualData);
+		BaseASC->CollisionActorIndividualData.MarkArrayDirty();
+		BaseASC->CollisionActorSharedData.DecreaseSharedDataCounter(Instance.State.SharedData.ID, GetWorldTime());
+	}
+
+	Instance.State.InstigatorASC = nullptr;
+	Instance.State.InstigatorBaseASC = nullptr;
+}
+
+template<typename StepType>
+void UAoEInstanceSubsystem::RunOnExecutor(FAoEInstance& Instance, StepType&& Step)
+{
+	ABaseCollisionActor* Executor = AcquireExecutor(Instance.Class);
+	if (!Executor)
+	{
+		return;
+	}
+
+	Executor->BindAoEInstance(Instance);
+	Step(Executor);
+	Executor->UnbindAoEInstance(Instance);
+
+	ReleaseExecutor(Executor);
+}
+
+ABaseCollisionActor* UAoEInstanceSubsystem::AcquireExecutor(UClass* Class)
+{
+	UWorld* World = GetWorld();
+	if (!Class || !World)
+	{
+		return nullptr;
+	}
+
+	TArray<ABaseCollisionActor*>& Free = FreeExecutors.FindOrAdd(Class);
+	while (!Free.IsEmpty())
+	{
+		ABaseCollisionActor* Executor = Free.Pop();
+		if (IsValid(Executor))
+		{
+			return Executor;
+		}
+	}
+
+	ABaseCollisionActor* Executor = World->SpawnActorDeferred<ABaseCollisionActor>(Class, FTransform::Identity, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+	if (!Executor)
+	{
+		return nullptr;
+	}
+
+	Executor->bActorlessExecutor = true;
+	Executor->FinishSpawning(FTransform::Identity);
+
+	//The shape is queried directly, the executor itself never collides, ticks, renders or replicates.
+	Executor->SetActorHiddenInGame(true);
+	Executor->SetActorEnableCollision(false);
+	Executor->SetActorTickEnabled(false);
+	Executor->SetNetDormancy(ENetDormancy::DORM_DormantAll);
+
+	Executors.Add(Executor);
+	return Executor;
+}
+
+void UAoEInstanceSubsystem::ReleaseExecutor(ABaseCollisionActor* Executor)
+{
+	FreeExecutors.FindOrAdd(Executor->GetClass()).Push(Executor);
+}
+
+float UAoEInstanceSubsystem::GetWorldTime() const
+{
+	return UKismetSystemLibrary::GetGameTimeInSeconds(GetWorld());
+}
@@ -0,0 +1,121 @@
+// Copyright 2024 Marchetti S. César A. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "AbilitySystem/CollisionActors/BaseCollisionActor.h"
+#include "AoEInstanceSubsystem.generated.h"
+
+class UAbilitySystemComponent;
+class UBaseAbilitySystemComponent;
+
+UENUM()
+enum class EAoEInstancePhase : uint8
+{
+	Preactivation,
+	Active,
+	Deactivated
+};
+
+/**
+*	Plain data record of an area of effect activation.
+*	The activation state is swapped into the executor of the class while one of its steps runs.
+*/
+USTRUCT()
+struct FAoEInstance
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TSubclassOf<ABaseCollisionActor> Class;
+
+	UPROPERTY()
+	TWeakObjectPtr<AActor> Owner;
+
+	UPROPERTY()
+	TWeakObjectPtr<APawn> Instigator;
+
+	FTransform Transform;
+
+	EAoEInstancePhase Phase = EAoEInstancePhase::Preactivation;
+
+	/** World times of the next step. ExpireTime is negative if the instance doesn't expire.*/
+	float ActivateTime = 0.f;
+	float NextPeriodTime = 0.f;
+	float ExpireTime = -1.f;
+	float ReleaseTime = 0.f;
+
+	bool bExpired = false;
+
+	/** Activation state, swapped as a whole with the one of the executor.*/
+	UPROPERTY()
+	FCollisionActorActivationState State;
+
+	/** Duration of the activation. Kept next to the state, it is a property of ABaseCollisionActor set from the activation block.*/
+	UPROPERTY()
+	FCollisionActorDuration Duration;
+};
+
+/**
+*	Runs instant and periodic areas of effect on the server without spawning an actor per activation.
+*	Instances are data records stepped by this subsystem with the same targeting, duration and effect application as ABaseCollisionActor. Each step binds the instance to a hidden,
+*	non relevant executor of its class that queries its shape directly, so the activation costs no actor, no physics registration and no replication. Clients only receive the cues.
+*	Classes opt in with bAllowActorlessInstances, and AbilitySystem.AoEInstances turns the system off.
+*/
+UCLASS()
+class CAMERAPLAY_API UAoEInstanceSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	static bool IsEnabled();
+
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/**
+	*	Starts an actorless instance of the class, in place of spawning and preactivating a collision actor. Server only.
+	*	Returns false if the class or its effects can't run actorless, the caller spawns the actor then.
+	*/
+	bool SpawnAoEInstance(TSubclassOf<ABaseCollisionActor> Class, const FTransform& Transform, AActor* Owner, APawn* Instigator, const FCollisionActorIndividualData& InIndividualData, const FCollisionActorSharedData& InSharedData, const FGameplayEffectContainerSpec& InEffectContainerSpec);
+
+	int32 GetNumInstances() const;
+
+private:
+
+	/** Runs the steps that are due. Returns true once the instance has been released.*/
+	bool StepInstance(FAoEInstance& Instance, float Now);
+
+	void DeactivateInstance(FAoEInstance& Instance, float Now, float ReleaseDelay);
+
+	/** Removes the data of the instance from its instigator without running an executor step. Used on teardown.*/
+	void ReleaseInstigatorData(FAoEInstance& Instance);
+
+	/** Binds the instance to a free executor of its class, runs the step and unbinds it.*/
+	template<typename StepType>
+	void RunOnExecutor(FAoEInstance& Instance, StepType&& Step);
+
+	/** Executors are taken while a step runs, so a step that starts another instance of the same class gets its own.*/
+	ABaseCollisionActor* AcquireExecutor(UClass* Class);
+	void ReleaseExecutor(ABaseCollisionActor* Executor);
+
+	float GetWorldTime() const;
+
+	UPROPERTY()
+	TArray<FAoEInstance> Instances;
+
+	/** Instances started while ticking, added to Instances after it.*/
+	UPROPERTY()
+	TArray<FAoEInstance> PendingInstances;
+
+	UPROPERTY()
+	TArray<TObjectPtr<ABaseCollisionActor>> Executors;
+
+	/** Executors not running a step, per class. Referenced by Executors.*/
+	TMap<TObjectKey<UClass>, TArray<ABaseCollisionActor*>> FreeExecutors;
+
+	bool bTicking = false;
+};
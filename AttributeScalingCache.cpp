@@ -0,0 +1,175 @@
+// Copyright 2024 Marchetti S. César A. All Rights Reserved.
+
+#include "AbilitySystem/AttributeScalingCache.h"
+#include "AbilitySystemComponent.h"
+#include "AbilitySystemBlueprintLibrary.h"
+#include "AbilitySystem/AbilitySystemStats.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Attribute Scaling Cache Hits"), STAT_AttributeScalingCacheHits, STATGROUP_AbilitySystemPerf);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Attribute Scaling Cache Misses"), STAT_AttributeScalingCacheMisses, STATGROUP_AbilitySystemPerf);
+
+int32 AttributeScalingCacheEnabled = 1;
+static FAutoConsoleVariableRef CVarAttributeScalingCacheEnabled(TEXT("AbilitySystem.AttributeScalingCache"), AttributeScalingCacheEnabled, TEXT("Memoize attribute scaled values per ability system component. Values are 0 or 1."), ECVF_Default);
+
+static FAutoConsoleCommand AttributeScalingCacheStatsCommand(TEXT("AbilitySystem.AttributeScalingCache.Stats"), TEXT("Logs the attribute scaling cache hit rate."), FConsoleCommandDelegate::CreateStatic(&FAttributeScalingCache::LogStats));
+
+TMap<TObjectKey<UAbilitySystemComponent>, TUniquePtr<FAttributeScalingCache>> FAttributeScalingCache::Caches;
+uint64 FAttributeScalingCache::TotalHits = 0;
+uint64 FAttributeScalingCache::TotalMisses = 0;
+
+float FAttributeScalingCache::ScaleValueWithAttribute(UAbilitySystemComponent* ASC, const FGameplayTagContainer& AbilityTags, float Value, const FGameplayAttribute& Attribute)
+{
+	//-1 is used in many cases as "infinite" and we dont want to apply attribute modifications to this type of attributes.
+	if (Value == -1 || !ASC)
+	{
+		return Value;
+	}
+
+	if (!AttributeScalingCacheEnabled || !IsInGameThread())
+	{
+		bool bSucc = false;
+		const float OutValue = UAbilitySystemBlueprintLibrary::EvaluateAttributeValueWithTagsAndBase(ASC, Attribute, AbilityTags, AbilityTags, Value, bSucc);
+		return bSucc ? OutValue : Value;
+	}
+
+	return FindOrAdd(ASC).Evaluate(ASC, AbilityTags, Value, Attribute);
+}
+
+FAttributeScalingCache* FAttributeScalingCache::Find(const UAbilitySystemComponent* ASC)
+{
+	const TUniquePtr<FAttributeScalingCache>* Cache = Caches.Find(ASC);
+	return Cache ? Cache->Get() : nullptr;
+}
+
+uint32 FAttributeScalingCache::GetEpoch(const UAbilitySystemComponent* ASC)
+{
+	const FAttributeScalingCache* Cache = Find(ASC);
+	return Cache ? Cache->Epoch : 0;
+}
+
+bool FAttributeScalingCache::IsEnabled()
+{
+	return AttributeScalingCacheEnabled != 0;
+}
+
+void FAttributeScalingCache::Invalidate()
+{
+	Values.Reset();
+	Epoch++;
+}
+
+FAttributeScalingCache& FAttributeScalingCache::FindOrAdd(UAbilitySystemComponent* ASC)
+{
+	if (FAttributeScalingCache* Cache = Find(ASC))
+	{
+		return *Cache;
+	}
+
+	//New ASCs are rare, drop the caches of the ones that were destroyed.
+	for (auto It = Caches.CreateIterator(); It; ++It)
+	{
+		if (!It.Key().ResolveObjectPtr())
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	FAttributeScalingCache& Cache = *Caches.Add(ASC, MakeUnique<FAttributeScalingCache>());
+
+	//Tag requirements on modifiers are evaluated against the owned tags too.
+	const TObjectKey<UAbilitySystemComponent> Key(ASC);
+	ASC->RegisterGenericGameplayTagEvent().AddWeakLambda(ASC, [Key](const FGameplayTag Tag, int32 Count)
+	{
+		if (const TUniquePtr<FAttributeScalingCache>* Found = Caches.Find(Key))
+		{
+			(*Found)->Invalidate();
+		}
+	});
+
+	return Cache;
+}
+
+float FAttributeScalingCache::Evaluate(UAbilitySystemComponent* ASC, const FGameplayTagContainer& AbilityTags, float Value, const FGameplayAttribute& Attribute)
+{
+	const uint32 Hash = GetKeyHash(Attribute, AbilityTags, Value);
+	if (const float* CachedValue = Values.FindByHash(Hash, FKeyView{ Attribute, AbilityTags, Value }))
+	{
+		TotalHits++;
+		INC_DWORD_STAT(STAT_AttributeScalingCacheHits);
+		return *CachedValue;
+	}
+
+	TotalMisses++;
+	INC_DWORD_STAT(STAT_AttributeScalingCacheMisses);
+
+	bool bSucc = false;
+	float OutValue = UAbilitySystemBlueprintLibrary::EvaluateAttributeValueWithTagsAndBase(ASC, Attribute, AbilityTags, AbilityTags, Value, bSucc);
+	if (!bSucc)
+	{
+		OutValue = Value;
+	}
+
+	//Evaluating creates the aggregator, so it can be watched from now on.
+	WatchAttribute(ASC, Attribute);
+	Values.AddByHash(Hash, FKey{ Attribute, AbilityTags, Value }, OutValue);
+	return OutValue;
+}
+
+void FAttributeScalingCache::WatchAttribute(UAbilitySystemComponent* ASC, const FGameplayAttribute& Attribute)
+{
+	if (WatchedAttributes.Contains(Attribute))
+	{
+		return;
+	}
+
+	WatchedAttributes.Add(Attribute);
+
+	//Aggregators get dirty when any modifier is added, removed or changed, even the ones that only apply for some tags and don't change the attribute value.
+	FAggregatorRef& AggregatorRef = ASC->ActiveGameplayEffects.FindOrCreateAttributeAggregator(Attribute);
+	if (FAggregator* Aggregator = AggregatorRef.Get())
+	{
+		const TObjectKey<UAbilitySystemComponent> Key(ASC);
+		Aggregator->OnDirty.AddWeakLambda(ASC, [Key](FAggregator* DirtyAggregator)
+		{
+			if (const TUniquePtr<FAttributeScalingCache>* Found = Caches.Find(Key))
+			{
+				(*Found)->Invalidate();
+			}
+		});
+	}
+
+	//Base value changes don't dirty the aggregator.
+	const TObjectKey<UAbilitySystemComponent> Key(ASC);
+	ASC->GetGameplayAttributeValueChangeDelegate(Attribute).AddWeakLambda(ASC, [Key](const FOnAttributeChangeData& Data)
+	{
+		if (const TUniquePtr<FAttributeScalingCache>* Found = Caches.Find(Key))
+		{
+			(*Found)->Invalidate();
+		}
+	});
+}
+
+uint32 FAttributeScalingCache::GetKeyHash(const FGameplayAttribute& Attribute, const FGameplayTagContainer& Tags, float Value)
+{
+	//Tag container equality doesn't depend on the order, so the hash can't either.
+	uint32 TagsHash = 0;
+	for (const FGameplayTag& Tag : Tags)
+	{
+		TagsHash += GetTypeHash(Tag);
+	}
+
+	return HashCombine(HashCombine(GetTypeHash(Attribute), GetTypeHash(Value)), TagsHash);
+}
+
+void FAttributeScalingCache::LogStats()
+{
+	const uint64 Lookups = TotalHits + TotalMisses;
+	int32 NumEntries = 0;
+	for (const auto& Pair : Caches)
+	{
+		NumEntries += Pair.Value->Values.Num();
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("Attribute scaling cache: %llu hits, %llu misses (%.1f%% hit rate). %d ASCs, %d cached values."),
+		TotalHits, TotalMisses, Lookups ? 100.0 * TotalHits / Lookups : 0.0, Caches.Num(), NumEntries);
+}
@@ -0,0 +1,101 @@
+// Copyright 2024 Marchetti S. César A. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AttributeSet.h"
+#include "GameplayTagContainer.h"
+#include "UObject/ObjectKey.h"
+
+class UAbilitySystemComponent;
+
+/**
+*	Memoized results of UAbilitySystemBlueprintLibrary::EvaluateAttributeValueWithTagsAndBase, one cache per ability system component.
+*	Entries are keyed by attribute, ability tags and base value. The whole cache of an ASC is invalidated when the aggregator of any cached attribute gets dirty or when the ASC owned tags change.
+*	Game thread only.
+*/
+class CAMERAPLAY_API FAttributeScalingCache
+{
+public:
+
+	/**
+	*	Scales the value with the attribute modifiers that apply for these ability tags. Values of -1 are used as "infinite" and are never scaled.
+	*	Returns the value unchanged when the attribute can't be evaluated on the ASC.
+	*/
+	static float ScaleValueWithAttribute(UAbilitySystemComponent* ASC, const FGameplayTagContainer& AbilityTags, float Value, const FGameplayAttribute& Attribute);
+
+	/** Cache for this ASC, null if it was never used or was removed.*/
+	static FAttributeScalingCache* Find(const UAbilitySystemComponent* ASC);
+
+	/** Changes every time the cached values of this ASC are invalidated. Data built from scaled values can store it to know when it's stale.*/
+	static uint32 GetEpoch(const UAbilitySystemComponent* ASC);
+
+	/** Whether or not values are being cached. Epochs don't change while the cache is disabled.*/
+	static bool IsEnabled();
+
+	/** Drops all cached values of this ASC.*/
+	void Invalidate();
+
+	/** Lookups since the start, across all ASCs.*/
+	static uint64 GetTotalHits() { return TotalHits; }
+	static uint64 GetTotalMisses() { return TotalMisses; }
+
+	/** Logs hit rate and cache sizes. Bound to AbilitySystem.AttributeScalingCache.Stats.*/
+	static void LogStats();
+
+private:
+
+	static FAttributeScalingCache& FindOrAdd(UAbilitySystemComponent* ASC);
+
+	float Evaluate(UAbilitySystemComponent* ASC, const FGameplayTagContainer& AbilityTags, float Value, const FGameplayAttribute& Attribute);
+
+	/** Binds to the aggregator of the attribute the first time it's cached.*/
+	void WatchAttribute(UAbilitySystemComponent* ASC, const FGameplayAttribute& Attribute);
+
+	struct FKey
+	{
+		FGameplayAttribute Attribute;
+		FGameplayTagContainer Tags;
+		float Value = 0.f;
+	};
+
+	/** Used to find entries without copying the tags.*/
+	struct FKeyView
+	{
+		const FGameplayAttribute& Attribute;
+		const FGameplayTagContainer& Tags;
+		float Value;
+
+		bool operator==(const FKey& Other) const
+		{
+			return Value == Other.Value && Attribute == Other.Attribute && Tags == Other.Tags;
+		}
+	};
+
+	friend bool operator==(const FKey& A, const FKey& B)
+	{
+		return A.Value == B.Value && A.Attribute == B.Attribute && A.Tags == B.Tags;
+	}
+
+	static uint32 GetKeyHash(const FGameplayAttribute& Attribute, const FGameplayTagContainer& Tags, float Value);
+
+	struct FKeyFuncs : BaseKeyFuncs<TPair<FKey, float>, FKey, false>
+	{
+		static const FKey& GetSetKey(const TPair<FKey, float>& Element) { return Element.Key; }
+		static bool Matches(const FKey& A, const FKey& B) { return A == B; }
+		static bool Matches(const FKey& A, const FKeyView& B) { return B == A; }
+		static uint32 GetKeyHash(const FKey& Key) { return FAttributeScalingCache::GetKeyHash(Key.Attribute, Key.Tags, Key.Value); }
+	};
+
+	TMap<FKey, float, FDefaultSetAllocator, FKeyFuncs> Values;
+
+	/** Attributes whose aggregator we are bound to.*/
+	TSet<FGameplayAttribute> WatchedAttributes;
+
+	uint32 Epoch = 0;
+
+	static TMap<TObjectKey<UAbilitySystemComponent>, TUniquePtr<FAttributeScalingCache>> Caches;
+
+	static uint64 TotalHits;
+	static uint64 TotalMisses;
+};
@@ -25,12 +25,33 @@
 #include "AbilitySystem/MyAbilitySystemGlobals.h"
 #include "AbilitySystem/GlobalTags.h"
 #include "AbilitySystem/ActorPool/ActorPoolManager.h"
+#include "AbilitySystem/ActorPool/CollisionActorPoolSubsystem.h"
+#include "AbilitySystem/CollisionActors/AoEInstanceSubsystem.h"
+#include "AbilitySystem/CollisionActors/CollisionActorVolley.h"
+#include "AbilitySystem/CollisionActors/CollisionActorScheduler.h"
 #include "AbilitySystem/AttributeSets/AbilityAttributeSet.h"
+#include "AbilitySystem/AttributeScalingCache.h"
+#include "AbilitySystem/ModifiedAbilityCache.h"
+#include "AbilitySystem/PeriodicStaggerSubsystem.h"
 #include "AbilitySystem/Targeting/TargetFunctionLibrary.h"
+#include "AbilitySystem/Targeting/TargetAcquisitionSubsystem.h"
+#include "AbilitySystem/AbilitySystemStats.h"
+#include "Engine/OverlapResult.h"
 #include "cameraplay/cameraplay.h"
 
 #include "SplineManager/SplineManagerInterface.h" //destructible actors
 
+DECLARE_CYCLE_STAT(TEXT("Collision Actor Incremental Overlaps"), STAT_CollisionActorIncrementalOverlaps, STATGROUP_AbilitySystemPerf);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Collision Actor Overlap Deltas"), STAT_CollisionActorOverlapDeltas, STATGROUP_AbilitySystemPerf);
+
+int32 IncrementalCollisionActorOverlaps = 1;
+static FAutoConsoleVariableRef CVarIncrementalCollisionActorOverlaps(TEXT("AbilitySystem.CollisionActor.IncrementalOverlaps"), IncrementalCollisionActorOverlaps, TEXT("Allow collision actors with bIncrementalOverlapTracking to diff their overlaps instead of using overlap events. Values are 0 or 1, applied on the next activation."), ECVF_Default);
+
+int32 FastCollisionActorRecycle = 1;
+static FAutoConsoleVariableRef CVarFastCollisionActorRecycle(TEXT("AbilitySystem.CollisionActor.FastRecycle"), FastCollisionActorRecycle, TEXT("Recycle collision actors with cached component lists and owned timer handles, skipping what the class doesn't use. Values are 0 or 1."), ECVF_Default);
+
+static FAutoConsoleCommandWithWorldAndArgs BenchmarkCollisionActorRecycleCommand(TEXT("AbilitySystem.CollisionActor.BenchmarkRecycle"), TEXT("Logs recycles per second of the generic and the fast recycle path. Arguments: Class path (first native collision actor class), Iterations (10000)."), FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&ABaseCollisionActor::BenchmarkRecycle));
+
 FName ABaseCollisionActor::ShapeComponentName(TEXT("Shape Component"));
 
 ABaseCollisionActor::ABaseCollisionActor(const FObjectInitializer& ObjectInitializer)
@@ -64,24 +85,13 @@ ABaseCollisionActor::ABaseCollisionActor(const FObjectInitializer& ObjectInitial
 	SetActorEnableCollision(false);
 
 	GameplayCueManager = nullptr;
-	bActive = false;
 	bPreactivated = false;
-	bRegisteredTargetInstance = false;
-	bSoftRegisteredTargetInstance = false;
 	NumPreallocatedInstances = 0;
 	bInRecycleQueue = false;		
-	bActorGameplayCueInitialized = false;
-	bPreactivationGameplayCueInitialized = false;
-	bPreviewGameplayCueInitialized = false;
-	bExecuteDeactivationCue = true;
 	bInterpolatingScale = false;
 	bSkipVariableInitialization = false;
 	bSynched = false;
-	bSkipGameplayCues = false;
 	bAttached = false;
-	bAllowRetargetting = false;
-	bAppliesPersistentEffects = false;
-	bDiscreteCollisionChecks = false;
 
 	PredictionRotationRateMultiplier = 1.25f;
 
@@ -95,6 +105,16 @@ void ABaseCollisionActor::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>&
 	DOREPLIFETIME(ABaseCollisionActor, bAbilityFromListenServer);
 }
 
+void ABaseCollisionActor::PostInitializeComponents()
+{
+	Super::PostInitializeComponents();
+
+	//Recycling resets these every deactivation, gather them once instead of searching the components each time.
+	GetComponents(RecycleTimelineComponents);
+	GetComponents(RecycleParticleComponents);
+	GetComponents(RecycleNiagaraComponents);
+}
+
 void ABaseCollisionActor::BeginPlay()
 {
 	Super::BeginPlay();
@@ -107,6 +127,16 @@ void ABaseCollisionActor::EndPlay(const EEndPlayReason::Type EndPlayReason)
 	Super::EndPlay(EndPlayReason);
 
 	Deactivate();
+	ReleasePeriodStagger();
+
+	if (LifecycleScheduleIndex != INDEX_NONE)
+	{
+		if (UCollisionActorSchedulerSubsystem* Scheduler = GetLifecycleScheduler())
+		{
+			Scheduler->ReleaseSchedule(LifecycleScheduleIndex);
+		}
+		LifecycleScheduleIndex = INDEX_NONE;
+	}
 }
 
 void ABaseCollisionActor::Tick(float Delta)
@@ -119,6 +149,16 @@ void ABaseCollisionActor::Tick(float Delta)
 
 	UpdateAttachment(Delta);
 
+	if (bTrackingOverlapsIncrementally)
+	{
+		IncrementalOverlapElapsedTime += Delta;
+		if (IncrementalOverlapElapsedTime >= IncrementalOverlapInterval)
+		{
+			IncrementalOverlapElapsedTime = 0.f;
+			UpdateIncrementalOverlaps();
+		}
+	}
+
 	if (!RequiresTick())
 	{
 		SetActorTickEnabled(false);
@@ -127,11 +167,17 @@ void ABaseCollisionActor::Tick(float Delta)
 
 bool ABaseCollisionActor::RequiresTick() const
 {
-	return bInterpolatingScale || bUpdateAttachmentOnTick || bInterpolatingRotation;
+	return bInterpolatingScale || bUpdateAttachmentOnTick || bInterpolatingRotation || bTrackingOverlapsIncrementally;
 }
 
 bool ABaseCollisionActor::IsNetRelevantFor(const AActor* RealViewer, const AActor* ViewTarget, const FVector& SrcLocation) const
 {
+	//Executors of actorless instances only exist on the server, clients get their cues.
+	if (bActorlessExecutor)
+	{
+		return false;
+	}
+
 	//Should be irrelevant when predicting for the owning client.
 	if (GetInstigatorBaseAbilitySystemComponent() && GetInstigatorBaseAbilitySystemComponent()->IsCollisionActorPredictionEnabled() && RealViewer->GetRemoteRole() != ENetRole::ROLE_Authority && (IsOwnedBy(ViewTarget) || IsOwnedBy(RealViewer)))
 	{
@@ -143,19 +189,7 @@ bool ABaseCollisionActor::IsNetRelevantFor(const AActor* RealViewer, const AActo
 
 float ABaseCollisionActor::ScaleValueWithAttribute(UAbilitySystemComponent* InASC, const FGameplayTagContainer& InAbilityTags, float Value, FGameplayAttribute Attribute) const
 {
-	//-1 is used in many cases as "infinite" and we dont want to apply attribute modifications to this type of attributes.
-	if (Value != -1 && InASC)
-	{
-		bool bSucc = false;
-		float OutValue = UAbilitySystemBlueprintLibrary::EvaluateAttributeValueWithTagsAndBase(InASC, Attribute, InAbilityTags, InAbilityTags, Value, bSucc);
-
-		if (bSucc)
-		{
-			return OutValue;
-		}
-	}
-
-	return Value;
+	return FAttributeScalingCache::ScaleValueWithAttribute(InASC, InAbilityTags, Value, Attribute);
 }
 
 FVector ABaseCollisionActor::GetActorBoneSocketLocation(AActor* InActor, FName Bone) const
@@ -184,17 +218,17 @@ FVector ABaseCollisionActor::GetActorBoneSocketLocation(AActor* InActor, FName B
 
 TSubclassOf<UGameplayAbility> ABaseCollisionActor::GetOwningAbilityClass()
 {
-	return IndividualData.AbilityClass;
+	return ActivationState.IndividualData.AbilityClass;
 }
 
 int32 ABaseCollisionActor::GetSharedDataID()
 {
-	return SharedData.ID;
+	return ActivationState.SharedData.ID;
 }
 
 int32 ABaseCollisionActor::GetActivationKey()
 {
-	return IndividualData.ActivationKey;
+	return ActivationState.IndividualData.ActivationKey;
 }
 
 void ABaseCollisionActor::InitializeSharedData(UAbilitySystemComponent* InASC, UGameplayAbility* InAbility, FCollisionActorSharedData& OutData) const
@@ -216,7 +250,11 @@ void ABaseCollisionActor::PreActivateCollisionActor(const FCollisionActorIndivid
 {
 	bPreactivated = true;
 
-	SetNetDormancy(ENetDormancy::DORM_Awake);
+	//Pooled and volley instances were already woken up when acquired.
+	if (NetDormancy != ENetDormancy::DORM_Awake)
+	{
+		SetNetDormancy(ENetDormancy::DORM_Awake);
+	}
 
 	SetIndividualData(InIndividualData);
 
@@ -244,7 +282,7 @@ void ABaseCollisionActor::PreActivateCollisionActor(const FCollisionActorIndivid
 
 void ABaseCollisionActor::OnSharedDataReplicatedBack(int32 SharedDataID)
 {
-	if (IndividualData.SharedDataID == SharedDataID)
+	if (ActivationState.IndividualData.SharedDataID == SharedDataID)
 	{
 		UE_LOG(CollisionActorLog, Log, TEXT("ABaseCollisionActor::OnSharedDataReplicatedBack : Collision Actor %s received shared data."), *GetName());
 
@@ -261,62 +299,89 @@ void ABaseCollisionActor::OnSharedDataReplicatedBack(int32 SharedDataID)
 
 void ABaseCollisionActor::InitializeVariablesFromSharedData()
 {
-	//Restore default values in case this is not a fresh spawn.
-	const ABaseCollisionActor* CDO = Cast<ABaseCollisionActor>(GetClass()->ClassDefaultObject);
+	if (!ActivationState.ActivationBlock.IsValid())
+	{
+		return;
+	}
 
-	Duration = CDO->Duration;
-	ScaleInterpolation = CDO->ScaleInterpolation;
-	RotationInterpolation = CDO->RotationInterpolation;
+	//Restore default values in case this is not a fresh spawn. The multipliers of the activation are already applied.
+	Duration = ActivationState.ActivationBlock->Duration;
+	ScaleInterpolation = ActivationState.ActivationBlock->ScaleInterpolation;
+	RotationInterpolation = ActivationState.ActivationBlock->RotationInterpolation;
 	if (RotationInterpolation.bAlternateRotationDirection)
 	{
-		RotationInterpolation.RotationRate *= FMath::Pow(-1.f, IndividualData.SpawnIndex);
+		RotationInterpolation.RotationRate *= FMath::Pow(-1.f, ActivationState.IndividualData.SpawnIndex);
 	}
 
-	Duration.LifeSpan *= SharedData.DurationMultiplier;
-	Duration.FirstPeriodDelay *= SharedData.PeriodMultiplier;
-	Duration.Period *= SharedData.PeriodMultiplier;
+	ActivationState.SharedData.AreaMultiplier = ActivationState.ActivationBlock->AreaMultiplier;
+}
 
-	//Scales area with avatar scale
-	if (OwningAbilityTags.HasTag(UGlobalTags::Ability_Device_Trap_Enviroment()))
+void ABaseCollisionActor::SetSharedData(const FCollisionActorSharedData& InSharedData)
+{
+	ActivationState.SharedData = InSharedData;
+
+	//Every actor of the volley shares the block, only the first one resolves it.
+	FCollisionActorActivationBlock::FKey BlockKey;
+	BlockKey.ASC = GetInstigatorAbilitySystemComponent();
+	BlockKey.CollisionActorClass = GetClass();
+	BlockKey.AbilityClass = ActivationState.IndividualData.AbilityClass.Get();
+	BlockKey.MainModifierAbilityClass = ActivationState.IndividualData.MainModifierAbilityClass.Get();
+	BlockKey.SharedDataID = ActivationState.SharedData.ID;
+	ActivationState.ActivationBlock = FCollisionActorActivationBlock::FindOrResolve(BlockKey, ActivationState.SharedData, [this](FCollisionActorActivationBlock& OutBlock) { ResolveActivationBlock(OutBlock); });
+
+	if (ActivationState.IndividualData.AbilityClass)
 	{
-		float AvatarScale = GetInstigator() != nullptr ? GetInstigator()->GetActorScale().X : GetOwner()->GetActorScale().X;
-		SharedData.AreaMultiplier *= AvatarScale;
+		ActivationState.OwningAbilityTags = ActivationState.ActivationBlock->OwningAbilityTags;
+		ActivationState.OwningAbilityFlags = ActivationState.ActivationBlock->OwningAbilityFlags;
+		ActivationState.SharedOwningAbilityTags = ActivationState.ActivationBlock->SharedOwningAbilityTags;
 	}
+
+	//We can now use tags to calculate attributes
+	InitializeVariablesFromSharedData();
 }
 
-void ABaseCollisionActor::SetSharedData(const FCollisionActorSharedData& InSharedData)
+void ABaseCollisionActor::ResolveActivationBlock(FCollisionActorActivationBlock& OutBlock) const
 {
-	SharedData = InSharedData;
-
-	if (IndividualData.AbilityClass)
+	if (ActivationState.IndividualData.AbilityClass)
 	{
 		//Init owning ability tags.
-		FModifiedAbility ModifiedAbility = FModifiedAbility(IndividualData.MainModifierAbilityClass ? IndividualData.MainModifierAbilityClass : IndividualData.AbilityClass, SharedData.AbilityLevel);
-		TArray<FGameplayTag> ModifierTags;
-		SharedData.ModifierTags.GetGameplayTagArray(ModifierTags);
-		for (const FGameplayTag& ModifierTag : ModifierTags)
-		{
-			ModifiedAbility.ApplyModifier(UBPL_AbilitySystem::FindAbilityModifier(ModifierTag));
-		}
+		const TSharedRef<const FModifiedAbility> ModifiedAbility = FModifiedAbilityCache::Get(ActivationState.IndividualData.MainModifierAbilityClass ? ActivationState.IndividualData.MainModifierAbilityClass : ActivationState.IndividualData.AbilityClass, ActivationState.SharedData.AbilityLevel, ActivationState.SharedData.ModifierTags);
 
-		if (ModifiedAbility.AffectedAbilitiesModifiedTags.Contains(IndividualData.AbilityClass))
+		if (const FGameplayTagContainer* ModifiedTags = ModifiedAbility->AffectedAbilitiesModifiedTags.Find(ActivationState.IndividualData.AbilityClass))
 		{
-			OwningAbilityTags = *ModifiedAbility.AffectedAbilitiesModifiedTags.Find(IndividualData.AbilityClass);
+			OutBlock.OwningAbilityTags = *ModifiedTags;
 		}
 		else
 		{
-			OwningAbilityTags = IndividualData.AbilityClass.GetDefaultObject()->AbilityTags;
-			UE_LOG(CollisionActorLog, Warning, TEXT("ABaseCollisionActor::SetSharedData: Could not generate tags for %s, falling back to CDO tags."), *IndividualData.AbilityClass.Get()->GetFName().ToString());
+			OutBlock.OwningAbilityTags = ActivationState.IndividualData.AbilityClass.GetDefaultObject()->AbilityTags;
+			UE_LOG(CollisionActorLog, Warning, TEXT("ABaseCollisionActor::ResolveActivationBlock: Could not generate tags for %s, falling back to CDO tags."), *ActivationState.IndividualData.AbilityClass.Get()->GetFName().ToString());
 		}
+
+		OutBlock.OwningAbilityFlags = AbilityBehaviorFlags::FromTags(OutBlock.OwningAbilityTags);
+		OutBlock.SharedOwningAbilityTags = FSharedGameplayTagContainer::Intern(OutBlock.OwningAbilityTags);
 	}
 
-	//We can now use tags to calculate attributes
-	InitializeVariablesFromSharedData();
+	const ABaseCollisionActor* CDO = Cast<ABaseCollisionActor>(GetClass()->ClassDefaultObject);
+
+	OutBlock.Duration = CDO->Duration;
+	OutBlock.Duration.LifeSpan *= ActivationState.SharedData.DurationMultiplier;
+	OutBlock.Duration.FirstPeriodDelay *= ActivationState.SharedData.PeriodMultiplier;
+	OutBlock.Duration.Period *= ActivationState.SharedData.PeriodMultiplier;
+	OutBlock.ScaleInterpolation = CDO->ScaleInterpolation;
+	OutBlock.RotationInterpolation = CDO->RotationInterpolation;
+
+	//Scales area with avatar scale
+	OutBlock.AreaMultiplier = ActivationState.SharedData.AreaMultiplier;
+	if (EnumHasAnyFlags(OutBlock.OwningAbilityFlags, EAbilityBehaviorFlags::TrapEnviroment))
+	{
+		float AvatarScale = GetInstigator() != nullptr ? GetInstigator()->GetActorScale().X : GetOwner()->GetActorScale().X;
+		OutBlock.AreaMultiplier *= AvatarScale;
+	}
 }
 
 void ABaseCollisionActor::SetIndividualData(const FCollisionActorIndividualData& InIndividualData)
 {
-	IndividualData = InIndividualData;
+	ActivationState.IndividualData = InIndividualData;
 
 	SetSourceAbilitySystemComponent();
 
@@ -331,18 +396,18 @@ void ABaseCollisionActor::SetIndividualData(const FCollisionActorIndividualData&
 		}
 
 		//Update context. Effect causer and instigator.
-		UBPL_AbilitySystem::SetInstigatorAndEffectCauserToContainerEffectContext(EffectContainerSpec, GetInstigator() != nullptr ? GetInstigator() : GetOwner(), this);
+		UBPL_AbilitySystem::SetInstigatorAndEffectCauserToContainerEffectContext(ActivationState.EffectContainerSpec, GetInstigator() != nullptr ? GetInstigator() : GetOwner(), this);
 	}
 
 	//Init targeting
-	bRegisteredTargetInstance = false;
+	ActivationState.bRegisteredTargetInstance = false;
 	RegisterSharedTargetInstance();
 }
 
 void ABaseCollisionActor::CallBeginActivate()
 {
 	//How long this collision actor has been going in the server.
-	float DeltaServerTime = IndividualData.ServerActivationTime - GetServerWorldTime();
+	float DeltaServerTime = ActivationState.IndividualData.ServerActivationTime - GetServerWorldTime();
 
 	//Set a timer to the moment the actor should activate.
 	if (DeltaServerTime <= 0.f)
@@ -353,12 +418,11 @@ void ABaseCollisionActor::CallBeginActivate()
 	else if (GetWorld())
 	{
 		CompensationActivationDelay = 0.f;
-		FTimerHandle PreactivationTimer;
-		GetWorld()->GetTimerManager().SetTimer(PreactivationTimer, this, &ABaseCollisionActor::BeginActivate, DeltaServerTime, false, DeltaServerTime);
+		SetLifecycleTimer(ECollisionActorScheduleEvent::BeginActivate, DeltaServerTime);
 	}
 	else
 	{
-		UE_LOG(CollisionActorLog, Log, TEXT("ABaseCollisionActor::CallBeginActivate: World was invalidated for %s."), *IndividualData.AbilityClass.Get()->GetFName().ToString());
+		UE_LOG(CollisionActorLog, Log, TEXT("ABaseCollisionActor::CallBeginActivate: World was invalidated for %s."), *ActivationState.IndividualData.AbilityClass.Get()->GetFName().ToString());
 		Deactivate();
 	}
 }
@@ -366,23 +430,23 @@ void ABaseCollisionActor::CallBeginActivate()
 void ABaseCollisionActor::BeginActivate()
 {
 	//Predicted actors apply their cues locally and skip the server cues.
-	bSkipGameplayCues = GetIsReplicated() && GetOwner()->IsOwnedBy(UGameplayStatics::GetPlayerController(this, 0)) && GetNetMode() != ENetMode::NM_ListenServer && GetNetMode() != ENetMode::NM_Standalone;
+	ActivationState.bSkipGameplayCues = GetIsReplicated() && GetOwner()->IsOwnedBy(UGameplayStatics::GetPlayerController(this, 0)) && GetNetMode() != ENetMode::NM_ListenServer && GetNetMode() != ENetMode::NM_Standalone;
 	
 	//Cache to know if we apply persistent effects.
-	bAppliesPersistentEffects = false;
+	ActivationState.bAppliesPersistentEffects = false;
 	
-	for (auto& it : EffectContainerSpec.TargetGameplayEffectSpecs)
+	for (auto& it : ActivationState.EffectContainerSpec.TargetGameplayEffectSpecs)
 	{
 		if (it.Data.Get()->Def->DurationPolicy == EGameplayEffectDurationType::Infinite)
 		{
-			bAppliesPersistentEffects = true;
+			ActivationState.bAppliesPersistentEffects = true;
 			break;
 		}
 	}
 	
 	//debug
 #if WITH_EDITOR
-	if (bSkipGameplayCues)
+	if (ActivationState.bSkipGameplayCues)
 	{
 		UE_LOG(CollisionActorLog, Log, TEXT("Skip GameplayCues for %s."), *GetName());
 	}
@@ -417,11 +481,11 @@ void ABaseCollisionActor::BeginActivate()
 
 		if (GetWorld())
 		{
-			GetWorld()->GetTimerManager().SetTimer(ActivationDelayTimerHandle, this, &ABaseCollisionActor::FinishActivate, Duration.ActivationDelay, false, Duration.ActivationDelay);
+			SetLifecycleTimer(ECollisionActorScheduleEvent::FinishActivate, Duration.ActivationDelay);
 		}
 		else
 		{
-			UE_LOG(CollisionActorLog, Log, TEXT("ABaseCollisionActor::BeginActivate: World was invalidated for %s."), *IndividualData.AbilityClass.Get()->GetFName().ToString());
+			UE_LOG(CollisionActorLog, Log, TEXT("ABaseCollisionActor::BeginActivate: World was invalidated for %s."), *ActivationState.IndividualData.AbilityClass.Get()->GetFName().ToString());
 			Deactivate();
 		}
 	}
@@ -435,8 +499,8 @@ void ABaseCollisionActor::FinishActivate()
 {
 	UE_LOG(CollisionActorLog, Log, TEXT("Activated %s"), *GetFName().ToString());
 
-	bActive = true;
-	StartTime = UKismetSystemLibrary::GetGameTimeInSeconds(this);
+	ActivationState.bActive = true;
+	ActivationState.StartTime = UKismetSystemLibrary::GetGameTimeInSeconds(this);
 
 	//Adjust transform for non delayed activations.
 	if (Duration.ActivationDelay == 0.f)
@@ -456,14 +520,7 @@ void ABaseCollisionActor::FinishActivate()
 	//Send Collision Actor Activated Event. Predicted client side versions dont send events.
 	if (GetIsReplicated())
 	{
-		//Send hit events	
-		FGameplayEventData Payload;
-		Payload.EventMagnitude = 1;
-		Payload.Instigator = GetInstigator() != nullptr ? GetInstigator() : GetOwner();
-		Payload.InstigatorTags = OwningAbilityTags;
-		Payload.OptionalObject = this;
-		Payload.ContextHandle = GetEffectContext();
-		SendGameplayEvent(GetInstigatorAbilitySystemComponent(), UGlobalTags::Event_CollisionActorActivate(), Payload);
+		SendCollisionActorEvent(UGlobalTags::Event_CollisionActorActivate());
 	}
 
 	if (Duration.LifeSpan == 0.f)
@@ -505,64 +562,34 @@ void ABaseCollisionActor::FinishActivate()
 	//Invalid world, we must deactivate.
 	if (!GetWorld())
 	{
-		UE_LOG(CollisionActorLog, Log, TEXT("ABaseCollisionActor::FinishActivate: World was invalidated for %s."), *IndividualData.AbilityClass.Get()->GetFName().ToString());
+		UE_LOG(CollisionActorLog, Log, TEXT("ABaseCollisionActor::FinishActivate: World was invalidated for %s."), *ActivationState.IndividualData.AbilityClass.Get()->GetFName().ToString());
 		Deactivate();
 	}
 }
 
 void ABaseCollisionActor::Deactivate(float PoolingDelay)
 {
-	if (bActive)
+	if (ActivationState.bActive)
 	{
 		UE_LOG(CollisionActorLog, Log, TEXT("Deactivated %s"), *GetFName().ToString());
 		OnCollisionActorDeactivate.Broadcast(this);
 
-		if (ShouldSendMultihitEventOnDeactivation() && GetInstigatorBaseAbilitySystemComponent())
-		{
-			TArray<TWeakObjectPtr<AActor>>* TotalTargets = GetInstigatorBaseAbilitySystemComponent()->GetSharedTargets(IndividualData.ActivationKey, GetIsReplicated());
-
-			if (TotalTargets && TotalTargets->Num())
-			{
-				int32 NumTargets = TotalTargets->Num();
-
-				if (NumTargets > 0)
-				{
-					FGameplayEventData Payload;
-					Payload.EventMagnitude = NumTargets;
-					Payload.Instigator = GetInstigator() != nullptr ? GetInstigator() : GetOwner();
-					Payload.Target = nullptr;
-					Payload.InstigatorTags = OwningAbilityTags;
-					Payload.ContextHandle = GetEffectContext();
-					Payload.OptionalObject = this;
-					SendGameplayEvent(GetInstigatorAbilitySystemComponent(), UGlobalTags::Event_MultiHit(), Payload);
-				}
-			}
-		}
-
-		//Send Collision Actor Deactivated Event
-		if (GetIsReplicated())
-		{
-			//Send hit events	
-			FGameplayEventData Payload;
-			Payload.EventMagnitude = 1;
-			Payload.Instigator = GetInstigator() != nullptr ? GetInstigator() : GetOwner();
-			Payload.InstigatorTags = OwningAbilityTags;
-			Payload.OptionalObject = this;
-			Payload.ContextHandle = GetEffectContext();
-			SendGameplayEvent(GetInstigatorAbilitySystemComponent(), UGlobalTags::Event_CollisionActorDeactivate(), Payload);
-		}
+		SendDeactivationEvents();
 
 		SoftUnregisterSharedTargetInstance();//Soft unregister. Hard unregister after the pooling. But this allows us to know when to send multihit event.
+		EndIncrementalOverlapTracking();
 		SetActorEnableCollision(false);
 		UnbindShapeCallbacks();
 		UninitializeTarget();
 		UninitializeAttachToActor();
 		SetActorTickEnabled(false);
 		RemoveGameplayCues();
+		ReleasePeriodStagger();
 
 		//Clear local target references
-		PreviousTargetedActors.Empty();
-		PreviousInteractableActors.Empty();
+		ActivationState.PreviousTargetedActors.Empty();
+		ActivationState.PreviousInteractableActors.Empty();
+		ActivationState.TargetHitHistory.Reset();
 
 		//Clear height interpolation values.
 		ClearHeightInterpolationData();
@@ -571,7 +598,7 @@ void ABaseCollisionActor::Deactivate(float PoolingDelay)
 		bSkipVariableInitialization = false;
 		bPreactivated = false;
 		bSynched = false;
-		bSkipGameplayCues = false;
+		ActivationState.bSkipGameplayCues = false;
 
 		//Remove bind if needed.
 		if (GetInstigatorBaseAbilitySystemComponent())
@@ -587,65 +614,72 @@ void ABaseCollisionActor::Deactivate(float PoolingDelay)
 		}
 		
 
-		// End timeline components
-		TInlineComponentArray<UTimelineComponent*> TimelineComponents(this);
-		for (UTimelineComponent* Timeline : TimelineComponents)
-		{
-			if (Timeline)
-			{
-				// May be too spammy, but want to call visibility to this. Maybe make this editor only?
-				if (Timeline->IsPlaying())
-				{
-					UE_LOG(CollisionActorLog, Warning, TEXT("Collision Actor %s had active timelines when it was recycled."), *GetName());
-				}
+		ClearRecycleState(IsFastRecycleEnabled());
 
-				Timeline->SetPlaybackPosition(0.f, false, false);
-				Timeline->Stop();
-			}
+		if (GetWorld())
+		{
+			//A zero delay pools on the next tick.
+			SetLifecycleTimer(ECollisionActorScheduleEvent::Pool, PoolingDelay);
 		}
-
-		//Clear latent actions
-		UWorld* MyWorld = GetWorld();
-		if (MyWorld)
+		else
 		{
-			GetWorld()->GetTimerManager().ClearAllTimersForObject(this);
+			Destroy();
+		}
 
-			if (MyWorld->GetLatentActionManager().GetNumActionsForObject(this))
-			{
-				//May be too spammy, but want ot call visibility to this. Maybe make this editor only?
-				UE_LOG(CollisionActorLog, Warning, TEXT("Collision Actor %s has active latent actions (Delays, etc) when it was recycled."), *GetName());
-			}
+		ActivationState.bActive = false;
+	}
+}
 
-			//End latent actions
-			MyWorld->GetLatentActionManager().RemoveActionsForObject(this);
+void ABaseCollisionActor::SendDeactivationEvents()
+{
+	if (ShouldSendMultihitEventOnDeactivation() && GetInstigatorBaseAbilitySystemComponent())
+	{
+		TArray<TWeakObjectPtr<AActor>>* TotalTargets = GetInstigatorBaseAbilitySystemComponent()->GetSharedTargets(ActivationState.IndividualData.ActivationKey, GetIsReplicated());
 
-			if (PoolingDelay == 0.f)
-			{
-				MyWorld->GetTimerManager().SetTimerForNextTick(FTimerDelegate::CreateUObject(this, &ABaseCollisionActor::PoolCollisionActor));
-			}
-			else
+		if (TotalTargets && TotalTargets->Num())
+		{
+			int32 NumTargets = TotalTargets->Num();
+
+			if (NumTargets > 0)
 			{
-				FTimerHandle PoolTimerHandle;
-				MyWorld->GetTimerManager().SetTimer(PoolTimerHandle, this, &ABaseCollisionActor::PoolCollisionActor, PoolingDelay, false, PoolingDelay);
+				FGameplayEventData Payload;
+				Payload.EventMagnitude = NumTargets;
+				Payload.Instigator = GetInstigator() != nullptr ? GetInstigator() : GetOwner();
+				Payload.Target = nullptr;
+				Payload.InstigatorTags = ActivationState.OwningAbilityTags;
+				Payload.ContextHandle = GetEffectContext();
+				Payload.OptionalObject = this;
+				SendGameplayEvent(GetInstigatorAbilitySystemComponent(), UGlobalTags::Event_MultiHit(), Payload);
 			}
 		}
-		else
-		{
-			Destroy();
-		}
+	}
 
-		bActive = false;
+	//Send Collision Actor Deactivated Event
+	if (GetIsReplicated())
+	{
+		SendCollisionActorEvent(UGlobalTags::Event_CollisionActorDeactivate());
 	}
 }
 
+void ABaseCollisionActor::SendCollisionActorEvent(FGameplayTag EventTag)
+{
+	FGameplayEventData Payload;
+	Payload.EventMagnitude = 1;
+	Payload.Instigator = GetInstigator() != nullptr ? GetInstigator() : GetOwner();
+	Payload.InstigatorTags = ActivationState.OwningAbilityTags;
+	Payload.OptionalObject = this;
+	Payload.ContextHandle = GetEffectContext();
+	SendGameplayEvent(GetInstigatorAbilitySystemComponent(), EventTag, Payload);
+}
+
 bool ABaseCollisionActor::IsCollisionActorActive() const
 {
-	return bActive;
+	return ActivationState.bActive;
 }
 
 bool ABaseCollisionActor::ShouldSendMultihitEventOnDeactivation() const
 {
-	return (Duration.Period <= 0 || bDiscreteCollisionChecks) && GetIsReplicated() && GetSharedTargetSoftRegisteredAmount() <= 1;
+	return (Duration.Period <= 0 || ActivationState.bDiscreteCollisionChecks) && GetIsReplicated() && GetSharedTargetSoftRegisteredAmount() <= 1;
 }
 
 void ABaseCollisionActor::Expire()
@@ -655,7 +689,7 @@ void ABaseCollisionActor::Expire()
 	OnCollisionActorExpired.Broadcast(this);
 
 	//Deactivate if period timer is invalid, otherwise it will deactivate on last period.
-	if (!AreaPeriodTimerHandle.IsValid() || (AreaPeriodTimerHandle.IsValid() && GetWorld() && !GetWorld()->GetTimerManager().IsTimerActive(AreaPeriodTimerHandle)))
+	if (!IsLifecycleTimerActive(ECollisionActorScheduleEvent::Period))
 	{
 		Deactivate(.25f);
 	}
@@ -663,25 +697,19 @@ void ABaseCollisionActor::Expire()
 
 void ABaseCollisionActor::InitExpirationTimer()
 {
-	if (OwningAbilityTags.HasTag(UGlobalTags::Ability_DisableExpiration()))
+	if (HasOwningAbilityFlag(EAbilityBehaviorFlags::DisableExpiration))
 	{
 		return;
 	}
 
 	ClearExpirationTimer();
 
-	if (GetWorld())
-	{
-		GetWorld()->GetTimerManager().SetTimer(DurationTimerHandle, this, &ABaseCollisionActor::Expire, Duration.LifeSpan, false, Duration.LifeSpan);
-	}
+	SetLifecycleTimer(ECollisionActorScheduleEvent::Expire, Duration.LifeSpan);
 }
 
 void ABaseCollisionActor::ClearExpirationTimer()
 {
-	if (GetWorld())
-	{
-		GetWorld()->GetTimerManager().ClearTimer(DurationTimerHandle);
-	}
+	ClearLifecycleTimer(ECollisionActorScheduleEvent::Expire);
 }
 
 void ABaseCollisionActor::Interpolate(float Delta)
@@ -708,13 +736,13 @@ float ABaseCollisionActor::GetNormalizedElapsedTime() const
 		return 0;
 	}
 
-	return abs(UKismetSystemLibrary::GetGameTimeInSeconds(this) - StartTime) / Duration.LifeSpan;
+	return abs(UKismetSystemLibrary::GetGameTimeInSeconds(this) - ActivationState.StartTime) / Duration.LifeSpan;
 }
 
 void ABaseCollisionActor::AdjustTransform()
 {
 	//Since we spawn all actors at once, for cases with activation time, that uses actor locations, the spawn location can change if the actor is moving, this corrects that.
-	switch (IndividualData.LocationType)
+	switch (ActivationState.IndividualData.LocationType)
 	{
 	case ECollisionActorSpawnLocationType::LiteralLocation:
 		SetActorLocation(GetActorLocation() + FVector(0, 0, 1));
@@ -723,13 +751,13 @@ void ABaseCollisionActor::AdjustTransform()
 		SetActorLocation(GetActorBoneSocketLocation(GetInstigator() != nullptr ? GetInstigator() : GetOwner(), Targeting.SpawnBoneName), false, nullptr, ETeleportType::ResetPhysics);
 		break;
 	case ECollisionActorSpawnLocationType::UseTarget:
-		if (IndividualData.TargetActor)
+		if (ActivationState.IndividualData.TargetActor)
 		{
-			SetActorLocation(GetActorBoneSocketLocation(IndividualData.TargetActor, Targeting.SpawnBoneName), false, nullptr, ETeleportType::ResetPhysics);
+			SetActorLocation(GetActorBoneSocketLocation(ActivationState.IndividualData.TargetActor, Targeting.SpawnBoneName), false, nullptr, ETeleportType::ResetPhysics);
 		}/*
 		else
 		{
-			SetActorLocation(IndividualData.TargetLocation, false, nullptr, ETeleportType::ResetPhysics);
+			SetActorLocation(ActivationState.IndividualData.TargetLocation, false, nullptr, ETeleportType::ResetPhysics);
 		}		*/
 		break;
 	default:
@@ -739,22 +767,22 @@ void ABaseCollisionActor::AdjustTransform()
 
 void ABaseCollisionActor::SetStartLocation()
 {
-	StartLocation = GetActorLocation();
+	ActivationState.StartLocation = GetActorLocation();
 
 	if (HasAuthority())
 	{
 		//Set spawn location as the Context Origin. This allow us to make calculations using distance to origin, distance travelled, etc.
-		UBPL_AbilitySystem::AddOriginPointToContainerEffectContext(EffectContainerSpec, StartLocation);
+		UBPL_AbilitySystem::AddOriginPointToContainerEffectContext(ActivationState.EffectContainerSpec, ActivationState.StartLocation);
 	}
 }
 
 void ABaseCollisionActor::InitializeScale()
 {
 	bInterpolatingScale = ScaleInterpolation.ScaleCurve != nullptr;	
-	CachedAdditiveScale = GetBaseAdditiveScale(SharedData.AbilityLevel);
-	FVector NewScale = bInterpolatingScale ? FVector(ScaleInterpolation.ScaleCurve->GetVectorValue(0.f) * ScaleInterpolation.ScaleCurveMultiplier + CachedAdditiveScale) : FVector(1);
-	NewScale += CachedAdditiveScale; //Apply additive scale
-	NewScale *= SharedData.AreaMultiplier; //Apply AOE multiplier to scale.
+	ActivationState.CachedAdditiveScale = GetBaseAdditiveScale(ActivationState.SharedData.AbilityLevel);
+	FVector NewScale = bInterpolatingScale ? FVector(ScaleInterpolation.ScaleCurve->GetVectorValue(0.f) * ScaleInterpolation.ScaleCurveMultiplier + ActivationState.CachedAdditiveScale) : FVector(1);
+	NewScale += ActivationState.CachedAdditiveScale; //Apply additive scale
+	NewScale *= ActivationState.SharedData.AreaMultiplier; //Apply AOE multiplier to scale.
 	SetCollisionActorScale(NewScale);
 }
 
@@ -766,8 +794,8 @@ FVector ABaseCollisionActor::GetBaseAdditiveScale_Implementation(int32 AbilityLe
 FVector ABaseCollisionActor::CalculateActorScale(float RelativeElapsedTime) const
 {
 	FVector CalculatedScale = ScaleInterpolation.ScaleCurve != nullptr ? ScaleInterpolation.ScaleCurve->GetVectorValue(RelativeElapsedTime) * ScaleInterpolation.ScaleCurveMultiplier : FVector(1);
-	CalculatedScale += CachedAdditiveScale;
-	CalculatedScale *= SharedData.AreaMultiplier;
+	CalculatedScale += ActivationState.CachedAdditiveScale;
+	CalculatedScale *= ActivationState.SharedData.AreaMultiplier;
 	return  CalculatedScale;
 }
 
@@ -798,13 +826,13 @@ void ABaseCollisionActor::SetCollisionActorScale(FVector NewScale)
 	SetActorScale3D(NewScale);
 		
 	//Update gameplay cue aswell, since they could be using scale
-	if (bActorGameplayCueInitialized)
+	if (ActivationState.bActorGameplayCueInitialized)
 	{
 		FGameplayCueParameters CueParams;
 		GetDefaultGameplayCueParams(CueParams);
 		
 		//Context is only valid on the server, so we cannot pass it along for GCs
-		GetGameplayCueManager()->HandleGameplayCue(this, ActorGameplayCue, EGameplayCueEvent::WhileActive, CueParams);
+		DispatchGameplayCue(this, ActorGameplayCue, EGameplayCueEvent::WhileActive, CueParams);
 	}
 }
 
@@ -867,21 +895,21 @@ void ABaseCollisionActor::InterpolateHeightToMatchFloor(float DeltaSeconds, floa
 		//Calculate distance using the hit result
 		float NewZ = FMath::FInterpTo(CurrentLocation.Z, ImpactPointZ + DesiredHeight, DeltaSeconds, InterpSpeed);
 	
-		PreviousInterpZValues.Add(NewZ);
+		ActivationState.PreviousInterpZValues.Add(NewZ);
 
 		//keep 7 values. This amount produces a good enough interpolation.
-		if (PreviousInterpZValues.Num() > 7)
+		if (ActivationState.PreviousInterpZValues.Num() > 7)
 		{
-			PreviousInterpZValues.RemoveAt(0);
+			ActivationState.PreviousInterpZValues.RemoveAt(0);
 		}
 		
 		float Sum = 0.f;
-		for (auto& it : PreviousInterpZValues)
+		for (auto& it : ActivationState.PreviousInterpZValues)
 		{
 			Sum += it;
 		}
 
-		float AverageZ = Sum / PreviousInterpZValues.Num();
+		float AverageZ = Sum / ActivationState.PreviousInterpZValues.Num();
 
 		SetActorLocation(FVector(GetActorLocation().X, GetActorLocation().Y, AverageZ));
 		//DrawDebugPoint(GetWorld(), GetShapeComponent()->GetComponentLocation(), 5.f, FColor::Red, false, 1.f, 0);
@@ -890,12 +918,12 @@ void ABaseCollisionActor::InterpolateHeightToMatchFloor(float DeltaSeconds, floa
 
 void ABaseCollisionActor::ClearHeightInterpolationData()
 {
-	PreviousInterpZValues.Empty();
+	ActivationState.PreviousInterpZValues.Empty();
 }
 
 AActor* ABaseCollisionActor::GetAttachTarget_Implementation() const
 {
-	return IndividualData.TargetActor;
+	return ActivationState.IndividualData.TargetActor;
 }
 
 void ABaseCollisionActor::InitializeAttachToActor()
@@ -948,31 +976,36 @@ void ABaseCollisionActor::InitializePersistentElements()
 	InitializeTarget();
 
 	//For interpolating scale, we want to force a period and threat it like periodic, to avoid constant collision checks for performance reasons.
-	bDiscreteCollisionChecks = false;
+	ActivationState.bDiscreteCollisionChecks = false;
 	if (bInterpolatingScale && Duration.Period <= 0.f)
 	{
 		Duration.Period = Duration.LifeSpan / 5.f; //Make sure to at least do 5 periods.
 		Duration.Period = FMath::Min(Duration.Period, 0.15f); //Make sure the period is at least 0.15f so the collision still feels continuous.
-		bDiscreteCollisionChecks = true;
+		ActivationState.bDiscreteCollisionChecks = true;
 	}	
 
 	if (Duration.Period > 0.f )
 	{
-		bAllowRetargetting = !bDiscreteCollisionChecks;
-		ExecutedPeriods = 0;
+		ActivationState.bAllowRetargetting = !ActivationState.bDiscreteCollisionChecks;
+		ActivationState.TargetHitHistory.RetargetInterval = Duration.Period;
+		ActivationState.ExecutedPeriods = 0;
 		SetActorEnableCollision(true);
-		MaximumPeriodsToExecute = FMath::TruncToInt((Duration.LifeSpan - Duration.FirstPeriodDelay) / Duration.Period) + 1;
+		ActivationState.MaximumPeriodsToExecute = FMath::TruncToInt((Duration.LifeSpan - Duration.FirstPeriodDelay) / Duration.Period) + 1;
 		
 		if (GetWorld())
 		{
-			GetWorld()->GetTimerManager().SetTimer(AreaPeriodTimerHandle, this, &ABaseCollisionActor::OnAreaOfEffectPeriod, Duration.Period, true, Duration.FirstPeriodDelay);
+			SetLifecycleTimer(ECollisionActorScheduleEvent::Period, StaggerFirstPeriodDelay(), Duration.Period);
 		}		
 		else
 		{
-			UE_LOG(CollisionActorLog, Log, TEXT("ABaseCollisionActor::InitializePersistentElements: World was invalidated for %s."), *IndividualData.AbilityClass.Get()->GetFName().ToString());
+			UE_LOG(CollisionActorLog, Log, TEXT("ABaseCollisionActor::InitializePersistentElements: World was invalidated for %s."), *ActivationState.IndividualData.AbilityClass.Get()->GetFName().ToString());
 			Deactivate();
 		}
 	}
+	else if (ShouldTrackOverlapsIncrementally())
+	{
+		BeginIncrementalOverlapTracking();
+	}
 	else
 	{
 		//Bind before enabling collision so we overlap something and can react through overlap events.
@@ -981,6 +1014,120 @@ void ABaseCollisionActor::InitializePersistentElements()
 	}
 }
 
+bool ABaseCollisionActor::ShouldTrackOverlapsIncrementally() const
+{
+	return bIncrementalOverlapTracking && IncrementalCollisionActorOverlaps && ShapeComp && GetWorld();
+}
+
+void ABaseCollisionActor::BeginIncrementalOverlapTracking()
+{
+	bTrackingOverlapsIncrementally = true;
+	IncrementalOverlapElapsedTime = 0.f;
+	TrackedOverlaps.Reset();
+
+	ShapeComp->SetGenerateOverlapEvents(false);
+	SetActorEnableCollision(true);
+
+	//Same as enabling collision with overlap events, whatever is already inside begins overlapping now.
+	UpdateIncrementalOverlaps();
+}
+
+void ABaseCollisionActor::UpdateIncrementalOverlaps()
+{
+	SCOPE_CYCLE_COUNTER(STAT_CollisionActorIncrementalOverlaps);
+
+	TArray<FOverlapResult> Overlaps;
+	FComponentQueryParams Params(SCENE_QUERY_STAT(CollisionActorIncrementalOverlaps), this);
+	GetWorld()->ComponentOverlapMulti(Overlaps, ShapeComp, ShapeComp->GetComponentLocation(), ShapeComp->GetComponentQuat(), Params);
+
+	TMap<TObjectKey<UPrimitiveComponent>, FTrackedOverlap> CurrentOverlaps;
+	CurrentOverlaps.Reserve(Overlaps.Num());
+	for (const FOverlapResult& Overlap : Overlaps)
+	{
+		UPrimitiveComponent* const Component = Overlap.GetComponent();
+		AActor* const Actor = Overlap.GetActor();
+
+		//Overlap events need both components to generate them.
+		if (Component && Actor && Actor != this && Component->GetGenerateOverlapEvents())
+		{
+			CurrentOverlaps.Add(Component, FTrackedOverlap{ Component, Actor });
+		}
+	}
+
+	TArray<FTrackedOverlap, TInlineAllocator<8>> Left;
+	for (const auto& it : TrackedOverlaps)
+	{
+		if (!CurrentOverlaps.Contains(it.Key))
+		{
+			Left.Add(it.Value);
+		}
+	}
+
+	TArray<FTrackedOverlap, TInlineAllocator<8>> Entered;
+	for (const auto& it : CurrentOverlaps)
+	{
+		if (!TrackedOverlaps.Contains(it.Key))
+		{
+			Entered.Add(it.Value);
+		}
+	}
+
+	TrackedOverlaps = MoveTemp(CurrentOverlaps);
+	INC_DWORD_STAT_BY(STAT_CollisionActorOverlapDeltas, Left.Num() + Entered.Num());
+
+	//The callbacks can deactivate the actor, which ends the tracking.
+	for (const FTrackedOverlap& it : Left)
+	{
+		AActor* const Actor = it.Actor.Get();
+		if (Actor)
+		{
+			OnEndOverlap(ShapeComp, Actor, it.Component.Get(), 0);
+		}
+
+		if (!bTrackingOverlapsIncrementally)
+		{
+			return;
+		}
+	}
+
+	for (const FTrackedOverlap& it : Entered)
+	{
+		UPrimitiveComponent* const Component = it.Component.Get();
+		AActor* const Actor = it.Actor.Get();
+		if (Component && Actor)
+		{
+			OnBeginOverlap(ShapeComp, Actor, Component, 0, false, FHitResult());
+		}
+
+		if (!bTrackingOverlapsIncrementally)
+		{
+			return;
+		}
+	}
+}
+
+void ABaseCollisionActor::EndIncrementalOverlapTracking()
+{
+	if (!bTrackingOverlapsIncrementally)
+	{
+		return;
+	}
+
+	bTrackingOverlapsIncrementally = false;
+
+	const TMap<TObjectKey<UPrimitiveComponent>, FTrackedOverlap> PreviousOverlaps = MoveTemp(TrackedOverlaps);
+	TrackedOverlaps.Reset();
+	for (const auto& it : PreviousOverlaps)
+	{
+		if (AActor* const Actor = it.Value.Actor.Get())
+		{
+			OnEndOverlap(ShapeComp, Actor, it.Value.Component.Get(), 0);
+		}
+	}
+
+	ShapeComp->SetGenerateOverlapEvents(true);
+}
+
 void ABaseCollisionActor::BindShapeCallbacks()
 {
 	if (!ShapeComp->OnComponentBeginOverlap.IsAlreadyBound(this, &ABaseCollisionActor::OnBeginOverlap))
@@ -1009,11 +1156,30 @@ void ABaseCollisionActor::UnbindShapeCallbacks()
 
 void ABaseCollisionActor::InitializeTarget()
 {	
+	//Homing actors spawned without a target acquire the nearest valid one in front of them.
+	if (!ActivationState.IndividualData.TargetActor && HomingAcquisitionRadius > 0.f)
+	{
+		ActivationState.IndividualData.TargetActor = FindHomingTarget(HomingAcquisitionRadius, HomingAcquisitionHalfAngle);
+	}
 }
 
 void ABaseCollisionActor::UninitializeTarget()
 {	
-	IndividualData.TargetActor = nullptr;
+	ActivationState.IndividualData.TargetActor = nullptr;
+}
+
+AActor* ABaseCollisionActor::FindHomingTarget(float MaxDistance, float HalfAngle)
+{
+	UTargetAcquisitionSubsystem* TargetAcquisition = GetWorld() ? GetWorld()->GetSubsystem<UTargetAcquisitionSubsystem>() : nullptr;
+	if (!TargetAcquisition)
+	{
+		return nullptr;
+	}
+
+	return TargetAcquisition->FindNearestTargetInCone(GetActorLocation(), GetActorForwardVector(), HalfAngle, MaxDistance, [this](AActor* Target)
+		{
+			return Target != this && Target != GetInstigator() && (ActivationState.bAllowRetargetting || !IsAlreadyTargeted(Target)) && Filter.FilterPassesForActor(Target);
+		});
 }
 
 void ABaseCollisionActor::OnAreaOfEffectPeriod()
@@ -1024,26 +1190,76 @@ void ABaseCollisionActor::OnAreaOfEffectPeriod()
 	TArray<AActor*> OverlappingActors;
 	ShapeComp->GetOverlappingActors(OverlappingActors);
 
+	ApplyAreaOfEffectPeriod(OverlappingActors);
+
+	//Either interrupt here or wait for expiration to make sure we completed all periods.
+	if (GetWorld() && ActivationState.ExecutedPeriods >= ActivationState.MaximumPeriodsToExecute)
+	{
+		ClearLifecycleTimer(ECollisionActorScheduleEvent::Period);
+		
+		if (!IsLifecycleTimerActive(ECollisionActorScheduleEvent::Expire))
+		{
+			Deactivate(.25f);
+		}
+	}
+}
+
+void ABaseCollisionActor::ApplyAreaOfEffectPeriod(const TArray<AActor*>& OverlappingActors)
+{
+	if (UPeriodicStaggerSubsystem* StaggerSubsystem = GetWorld() ? GetWorld()->GetSubsystem<UPeriodicStaggerSubsystem>() : nullptr)
+	{
+		StaggerSubsystem->AddPeriodicWork();
+	}
+
 	//Apply effects and send multihit event.
-	ApplyEffectToActorArray(OverlappingActors, nullptr, !bDiscreteCollisionChecks);
+	ApplyEffectToActorArray(OverlappingActors, nullptr, !ActivationState.bDiscreteCollisionChecks);
 	
 	//GameplayCues are already executed on finish activate, we want to skip the first tick if it happens on start.
-	if (!bDiscreteCollisionChecks && (!(Duration.FirstPeriodDelay == 0.f && ExecutedPeriods == 0)))
+	if (!ActivationState.bDiscreteCollisionChecks && (!(Duration.FirstPeriodDelay == 0.f && ActivationState.ExecutedPeriods == 0)))
 	{		
 		ExecuteGameplayCues();		
 	}	
 	
-	ExecutedPeriods++;
+	ActivationState.ExecutedPeriods++;
+}
 
-	//Either interrupt here or wait for expiration to make sure we completed all periods.
-	if (GetWorld() && ExecutedPeriods >= MaximumPeriodsToExecute)
+float ABaseCollisionActor::StaggerFirstPeriodDelay()
+{
+	ReleasePeriodStagger();
+
+	UWorld* World = GetWorld();
+	UPeriodicStaggerSubsystem* StaggerSubsystem = PeriodStaggerFrames > 0 && Duration.Period > 0.f && World && UPeriodicStaggerSubsystem::IsEnabled() ? World->GetSubsystem<UPeriodicStaggerSubsystem>() : nullptr;
+	if (!StaggerSubsystem)
 	{
-		GetWorld()->GetTimerManager().ClearTimer(AreaPeriodTimerHandle);
-		
-		if (!DurationTimerHandle.IsValid() || (DurationTimerHandle.IsValid() && !GetWorld()->GetTimerManager().IsTimerActive(DurationTimerHandle)))
+		return Duration.FirstPeriodDelay;
+	}
+
+	//Moving the periods before the activation or past the expiration would change the lifetime, and the amount of periods with it.
+	const float Tolerance = PeriodStaggerFrames * UPeriodicStaggerSubsystem::GetFrameTime();
+	const float LastPeriodDelay = Duration.FirstPeriodDelay + FMath::Max(ActivationState.MaximumPeriodsToExecute - 1, 0) * Duration.Period;
+	const float MinOffset = -FMath::Min(Duration.FirstPeriodDelay, Tolerance);
+	float MaxOffset = Tolerance;
+	if (Duration.LifeSpan > 0.f && !HasOwningAbilityFlag(EAbilityBehaviorFlags::DisableExpiration))
+	{
+		//The lifespan of predicted actors is shortened once activated.
+		const float LifeSpan = ShouldPredict() ? Duration.LifeSpan - GetPredictionDeltaTime() : Duration.LifeSpan;
+		MaxOffset = FMath::Clamp(LifeSpan - LastPeriodDelay, 0.f, Tolerance);
+	}
+
+	const double Now = World->GetTimeSeconds();
+	return Duration.FirstPeriodDelay + StaggerSubsystem->StaggerPeriodicSeries(Now + Duration.FirstPeriodDelay, Duration.Period, MinOffset, MaxOffset, Now + LastPeriodDelay + MaxOffset, &ActivationState.PeriodStaggerReservation);
+}
+
+void ABaseCollisionActor::ReleasePeriodStagger()
+{
+	if (ActivationState.PeriodStaggerReservation != INDEX_NONE)
+	{
+		//Released even if staggering was turned off since, the reservation is still counted.
+		if (UPeriodicStaggerSubsystem* StaggerSubsystem = GetWorld() ? GetWorld()->GetSubsystem<UPeriodicStaggerSubsystem>() : nullptr)
 		{
-			Deactivate(.25f);
+			StaggerSubsystem->ReleasePeriodicSeries(ActivationState.PeriodStaggerReservation);
 		}
+		ActivationState.PeriodStaggerReservation = INDEX_NONE;
 	}
 }
 
@@ -1084,7 +1300,7 @@ void ABaseCollisionActor::OnEndOverlap(UPrimitiveComponent* OverlappedComponent,
 {
 	UE_LOG(CollisionActorLog, Log, TEXT("End Overlap %s"), *OtherActor->GetFName().ToString());
 
-	if (bAppliesPersistentEffects)
+	if (ActivationState.bAppliesPersistentEffects)
 	{
 		if (GetPreviousTargets() && GetPreviousTargets()->Contains(OtherActor))
 		{
@@ -1102,11 +1318,11 @@ bool ABaseCollisionActor::ApplyEffectToActor(AActor * A, const FHitResult& Conte
 	}
 
 	//Apply effect on the authority
-	if (HasAuthority() && EffectContainerSpec.HasValidEffects() && GetInstigatorAbilitySystemComponent())
+	if (HasAuthority() && ActivationState.EffectContainerSpec.HasValidEffects() && GetInstigatorAbilitySystemComponent())
 	{
-		UBPL_AbilitySystem::AddHitToContainerEffectContext(EffectContainerSpec, ContextHitResult);
+		UBPL_AbilitySystem::AddHitToContainerEffectContext(ActivationState.EffectContainerSpec, ContextHitResult);
 
-		for (auto& it : EffectContainerSpec.TargetGameplayEffectSpecs)
+		for (auto& it : ActivationState.EffectContainerSpec.TargetGameplayEffectSpecs)
 		{
 			GetInstigatorAbilitySystemComponent()->ApplyGameplayEffectSpecToTarget(*it.Data.Get(), UAbilitySystemGlobals::GetAbilitySystemComponentFromActor(A));
 		}			
@@ -1118,17 +1334,13 @@ bool ABaseCollisionActor::ApplyEffectToActor(AActor * A, const FHitResult& Conte
 		FGameplayEventData Payload;
 		Payload.EventMagnitude = 1;
 		Payload.Instigator = GetInstigator() != nullptr ? GetInstigator() : GetOwner();
-		Payload.InstigatorTags = OwningAbilityTags;
-		if (ContextTags && ContextTags->Num())
-		{
-			Payload.InstigatorTags.AppendTags(*ContextTags);
-		}
+		Payload.InstigatorTags = GetOwningAbilityTagsWithContext(ContextTags).Get();
 
 		Payload.Target = A;
 		UAbilitySystemComponent* TargetASC = UAbilitySystemGlobals::GetAbilitySystemComponentFromActor(A);
 		if (TargetASC)
 		{
-			TargetASC->GetOwnedGameplayTags(Payload.TargetTags);
+			Payload.TargetTags = TargetASC->GetOwnedGameplayTags();
 		}
 		
 		Payload.ContextHandle = GetEffectContext();
@@ -1149,17 +1361,18 @@ bool ABaseCollisionActor::ApplyEffectToActor(AActor * A, const FHitResult& Conte
 		CueParams.EffectCauser = A;
 		if (ContextTags && ContextTags->Num())
 		{
-			CueParams.AggregatedSourceTags.AppendTags(*ContextTags);
+			CueParams.AggregatedSourceTags = GetOwningAbilityTagsWithContext(ContextTags).Get();
 		}
 
 		for (const FGameplayTag& Tag : HitTargetGameplayCues)
 		{
-			GetGameplayCueManager()->HandleGameplayCue(A, Tag, EGameplayCueEvent::Executed, CueParams);
+			DispatchGameplayCue(A, Tag, EGameplayCueEvent::Executed, CueParams);
 		}
 	}
 
 	//Save as already targeted.
 	AddPreviousTarget(A);
+	ActivationState.TargetHitHistory.RecordHit(A, GetRetargetTime());
 
 	return true;
 }
@@ -1195,11 +1408,7 @@ int32 ABaseCollisionActor::ApplyEffectToActorArray(const TArray<AActor*>& A, FGa
 				Payload.EventMagnitude = Amount;
 				Payload.Instigator = GetInstigator() != nullptr ? GetInstigator() : GetOwner();
 				Payload.Target = nullptr;
-				Payload.InstigatorTags = OwningAbilityTags;
-				if (ContextTags && ContextTags->Num())
-				{
-					Payload.InstigatorTags.AppendTags(*ContextTags);
-				}
+				Payload.InstigatorTags = GetOwningAbilityTagsWithContext(ContextTags).Get();
 				Payload.ContextHandle = GetEffectContext();
 				Payload.OptionalObject = this;
 				SendGameplayEvent(GetInstigatorAbilitySystemComponent(), UGlobalTags::Event_MultiHit(), Payload);
@@ -1224,7 +1433,7 @@ int32 ABaseCollisionActor::ApplyEffectToActorArray(const TArray<AActor*>& A, FGa
 
 bool ABaseCollisionActor::ApplyActorInteraction(AActor* A, UPrimitiveComponent* OverlappedComponent, const FHitResult& Hit)
 {
-	if (A && GetNetMode() != ENetMode::NM_DedicatedServer && bActive)
+	if (A && GetNetMode() != ENetMode::NM_DedicatedServer && ActivationState.bActive)
 	{	
 		ISplineManagerInterface::Execute_ApplyDamageToDestructibleSplineComponent(A, this, OverlappedComponent, Hit);		
 		AddPreviousInteractableTarget(A);
@@ -1238,7 +1447,7 @@ int32 ABaseCollisionActor::RemoveAppliedPersistentEffects(AActor* Actor)
 {
 	int32 Amount = 0;
 
-	if (bAppliesPersistentEffects)
+	if (ActivationState.bAppliesPersistentEffects)
 	{
 		UAbilitySystemComponent* InternalTargetASC = UAbilitySystemGlobals::GetAbilitySystemComponentFromActor(Actor);
 
@@ -1271,7 +1480,7 @@ int32 ABaseCollisionActor::RemoveAppliedPersistentEffects(AActor* Actor)
 bool ABaseCollisionActor::TransferPersistentEffects(AActor* Target)
 {
 	//if we are not the only collision actor overlapping this target, other one should take care of applying the effect.
-	if (bAppliesPersistentEffects && !OwningAbilityTags.HasTag(UGlobalTags::Ability_Targeting_IndividualTargeting()))
+	if (ActivationState.bAppliesPersistentEffects && !HasOwningAbilityFlag(EAbilityBehaviorFlags::IndividualTargeting))
 	{
 		//Get overlapping actors of the same class as this one, that overlaps target to remove and have the same key and apply the effect from them.
 		TArray<AActor*> OverlappingActors;
@@ -1282,7 +1491,7 @@ bool ABaseCollisionActor::TransferPersistentEffects(AActor* Target)
 			if (it && it != this)
 			{
 				ABaseCollisionActor* CA = Cast<ABaseCollisionActor>(it);
-				if (CA && CA->IndividualData.ActivationKey == IndividualData.ActivationKey)
+				if (CA && CA->ActivationState.IndividualData.ActivationKey == ActivationState.IndividualData.ActivationKey)
 				{
 					//Transfer the effect. Does not check for valid target, it should be valid.
 					CA->ApplyEffectToActor(Target, FHitResult());
@@ -1297,15 +1506,15 @@ bool ABaseCollisionActor::TransferPersistentEffects(AActor* Target)
 
 FGameplayEffectContextHandle ABaseCollisionActor::GetEffectContext() const
 {
-	if (EffectContainerSpec.HasValidEffects())
+	if (ActivationState.EffectContainerSpec.HasValidEffects())
 	{
-		return EffectContainerSpec.GetEffectContext();
+		return ActivationState.EffectContainerSpec.GetEffectContext();
 	}
 
 	if (GetInstigatorAbilitySystemComponent())
 	{
 		FGameplayEffectContextHandle Context = GetInstigatorAbilitySystemComponent()->MakeEffectContext();
-		Context.SetAbility(IndividualData.MainModifierAbilityClass ? IndividualData.MainModifierAbilityClass.GetDefaultObject() : IndividualData.AbilityClass.GetDefaultObject());
+		Context.SetAbility(ActivationState.IndividualData.MainModifierAbilityClass ? ActivationState.IndividualData.MainModifierAbilityClass.GetDefaultObject() : ActivationState.IndividualData.AbilityClass.GetDefaultObject());
 		return Context;
 	}
 
@@ -1314,15 +1523,15 @@ FGameplayEffectContextHandle ABaseCollisionActor::GetEffectContext() const
 
 FGameplayEffectContainerSpec& ABaseCollisionActor::GetEffectContainerSpec()
 {
-	return EffectContainerSpec;
+	return ActivationState.EffectContainerSpec;
 }
 
 void ABaseCollisionActor::SetEffectContainerSpec(const FGameplayEffectContainerSpec& NewSpec)
 {
 	if (GetIsReplicated() && HasAuthority())
 	{
-		EffectContainerSpec = NewSpec;
-		UBPL_AbilitySystem::SetInstigatorAndEffectCauserToContainerEffectContext(EffectContainerSpec, GetInstigator() != nullptr ? GetInstigator() : GetOwner(), this);
+		ActivationState.EffectContainerSpec = NewSpec;
+		UBPL_AbilitySystem::SetInstigatorAndEffectCauserToContainerEffectContext(ActivationState.EffectContainerSpec, GetInstigator() != nullptr ? GetInstigator() : GetOwner(), this);
 	}
 }
 
@@ -1338,12 +1547,19 @@ bool ABaseCollisionActor::IsValidTargetActor(AActor* Actor)
 	if (Actor)
 	{
 		//Is the target being targetted by this actor or others that share the target?
-		if (!bAllowRetargetting && IsAlreadyTargeted(Actor))
+		if (!ActivationState.bAllowRetargetting && IsAlreadyTargeted(Actor))
 		{
 			UE_LOG(CollisionActorLog, Verbose, TEXT("ABaseCollisionActor::IsValidTargetActor: Already targeted %s by"), *Actor->GetFName().ToString(), *GetFName().ToString());
 			return false;
 		}
 
+		//Retargetting is allowed once per period.
+		if (ActivationState.bAllowRetargetting && !ActivationState.TargetHitHistory.IsEligible(Actor, GetRetargetTime()))
+		{
+			UE_LOG(CollisionActorLog, Verbose, TEXT("ABaseCollisionActor::IsValidTargetActor: %s was already targeted this period by %s"), *Actor->GetFName().ToString(), *GetFName().ToString());
+			return false;
+		}
+
 		//Has target priority. Multiple AOE with shared targeting need to decide if they can target the actor or not.
 		if (!HasTargetPriority(Actor))
 		{
@@ -1394,7 +1610,7 @@ bool ABaseCollisionActor::IsValidInteractableActor(AActor* Actor, FVector Impact
 		}
 
 		//Is the target being targetted by this actor or others that share the target?
-		if (!bAllowRetargetting && IsInteractableActorAlreadyTargeted(Actor))
+		if (!ActivationState.bAllowRetargetting && IsInteractableActorAlreadyTargeted(Actor))
 		{
 			UE_LOG(CollisionActorLog, Verbose, TEXT("ABaseCollisionActor::IsValidInteractableActor: Already targeted %s by"), *Actor->GetFName().ToString(), *GetFName().ToString());
 			return false;
@@ -1428,19 +1644,19 @@ bool ABaseCollisionActor::IsAlreadyTargeted(AActor* Target)
 
 bool ABaseCollisionActor::IsInteractableActorAlreadyTargeted(AActor* Actor) const
 {
-	return PreviousInteractableActors.Contains(Actor);
+	return ActivationState.PreviousInteractableActors.Contains(Actor);
 }
 
 bool ABaseCollisionActor::HasTargetPriority(AActor* Target) const
 {
 	//We only care for priority when we apply persistent effects. This is mostly designed for AOEs with persistent effects that overlap.
-	if (!bAppliesPersistentEffects)
+	if (!ActivationState.bAppliesPersistentEffects)
 	{
 		return true;
 	}
 
 	//Individual targeting always has priority
-	if (OwningAbilityTags.HasTag(UGlobalTags::Ability_Targeting_IndividualTargeting()))
+	if (HasOwningAbilityFlag(EAbilityBehaviorFlags::IndividualTargeting))
 	{
 		return true;
 	}
@@ -1458,7 +1674,7 @@ bool ABaseCollisionActor::HasTargetPriority(AActor* Target) const
 		{
 			ABaseCollisionActor* CA = Cast<ABaseCollisionActor>(it);
 			
-			if (CA && CA->IndividualData.SpawnIndex < LowestIndex)
+			if (CA && CA->ActivationState.IndividualData.SpawnIndex < LowestIndex)
 			{
 				LowestIndexActor = it;
 			}
@@ -1609,9 +1825,9 @@ float ABaseCollisionActor::GetMaximumDirectionDeviationByLifetime(float InTime,
 TArray<TWeakObjectPtr<AActor>>* ABaseCollisionActor::GetPreviousTargets()
 {
 	//Shared Targetting goes through the ASC.
-	if (!OwningAbilityTags.HasTag(UGlobalTags::Ability_Targeting_IndividualTargeting()) && GetInstigatorBaseAbilitySystemComponent())
+	if (!HasOwningAbilityFlag(EAbilityBehaviorFlags::IndividualTargeting) && GetInstigatorBaseAbilitySystemComponent())
 	{	
-		return GetInstigatorBaseAbilitySystemComponent()->GetSharedTargets(IndividualData.ActivationKey, GetIsReplicated());				
+		return GetInstigatorBaseAbilitySystemComponent()->GetSharedTargets(ActivationState.IndividualData.ActivationKey, GetIsReplicated());				
 	}
 	
 	return GetLocalPreviousTargets();	
@@ -1619,7 +1835,7 @@ TArray<TWeakObjectPtr<AActor>>* ABaseCollisionActor::GetPreviousTargets()
 
 TArray<TWeakObjectPtr<AActor>>* ABaseCollisionActor::GetLocalPreviousTargets()
 {
-	return &PreviousTargetedActors;
+	return &ActivationState.PreviousTargetedActors;
 }
 
 TArray<AActor*> ABaseCollisionActor::GetPreviousTargetsHardReference()
@@ -1642,13 +1858,19 @@ TArray<AActor*> ABaseCollisionActor::GetPreviousTargetsHardReference()
 
 void ABaseCollisionActor::RegisterSharedTargetInstance()
 {	
-	if (!bRegisteredTargetInstance && !bSoftRegisteredTargetInstance )// && !OwningAbilityTags.HasTag(UGlobalTags::Ability_Targeting_IndividualTargeting()))
+	if (!ActivationState.bRegisteredTargetInstance && !ActivationState.bSoftRegisteredTargetInstance )// && !OwningAbilityTags.HasTag(UGlobalTags::Ability_Targeting_IndividualTargeting()))
 	{
-		if (GetInstigatorBaseAbilitySystemComponent())
+		if (bSharedTargetingRegisteredByVolley)
 		{
-			GetInstigatorBaseAbilitySystemComponent()->RegisterCollisionActorForSharedTargeting(IndividualData.ActivationKey, 1, GetIsReplicated());
-			bRegisteredTargetInstance = true;
-			bSoftRegisteredTargetInstance = true;
+			bSharedTargetingRegisteredByVolley = false;
+			ActivationState.bRegisteredTargetInstance = true;
+			ActivationState.bSoftRegisteredTargetInstance = true;
+		}
+		else if (GetInstigatorBaseAbilitySystemComponent())
+		{
+			GetInstigatorBaseAbilitySystemComponent()->RegisterCollisionActorForSharedTargeting(ActivationState.IndividualData.ActivationKey, 1, GetIsReplicated());
+			ActivationState.bRegisteredTargetInstance = true;
+			ActivationState.bSoftRegisteredTargetInstance = true;
 		}
 		else
 		{
@@ -1659,12 +1881,12 @@ void ABaseCollisionActor::RegisterSharedTargetInstance()
 
 void ABaseCollisionActor::UnregisterSharedTargetInstance()
 {
-	if (bRegisteredTargetInstance)
+	if (ActivationState.bRegisteredTargetInstance)
 	{
 		if (GetInstigatorBaseAbilitySystemComponent())
 		{
-			GetInstigatorBaseAbilitySystemComponent()->UnregisterCollisionActorForSharedTargeting(IndividualData.ActivationKey, 1, GetIsReplicated());
-			bRegisteredTargetInstance = false;
+			GetInstigatorBaseAbilitySystemComponent()->UnregisterCollisionActorForSharedTargeting(ActivationState.IndividualData.ActivationKey, 1, GetIsReplicated());
+			ActivationState.bRegisteredTargetInstance = false;
 		}
 		else
 		{
@@ -1675,12 +1897,12 @@ void ABaseCollisionActor::UnregisterSharedTargetInstance()
 
 void ABaseCollisionActor::SoftUnregisterSharedTargetInstance()
 {
-	if (bSoftRegisteredTargetInstance)
+	if (ActivationState.bSoftRegisteredTargetInstance)
 	{
 		if (GetInstigatorBaseAbilitySystemComponent())
 		{
-			GetInstigatorBaseAbilitySystemComponent()->SoftUnregisterCollisionActorForSharedTargeting(IndividualData.ActivationKey, 1, GetIsReplicated());
-			bSoftRegisteredTargetInstance = false;
+			GetInstigatorBaseAbilitySystemComponent()->SoftUnregisterCollisionActorForSharedTargeting(ActivationState.IndividualData.ActivationKey, 1, GetIsReplicated());
+			ActivationState.bSoftRegisteredTargetInstance = false;
 		}
 		else
 		{
@@ -1691,11 +1913,11 @@ void ABaseCollisionActor::SoftUnregisterSharedTargetInstance()
 
 int32 ABaseCollisionActor::GetSharedTargetRegisteredAmount() const
 {
-	if (bRegisteredTargetInstance)
+	if (ActivationState.bRegisteredTargetInstance)
 	{
 		if (GetInstigatorBaseAbilitySystemComponent())
 		{
-			return GetInstigatorBaseAbilitySystemComponent()->GetRegisteredCollisionActorsAmount(IndividualData.ActivationKey, GetIsReplicated());
+			return GetInstigatorBaseAbilitySystemComponent()->GetRegisteredCollisionActorsAmount(ActivationState.IndividualData.ActivationKey, GetIsReplicated());
 		}
 	}
 
@@ -1704,11 +1926,11 @@ int32 ABaseCollisionActor::GetSharedTargetRegisteredAmount() const
 
 int32 ABaseCollisionActor::GetSharedTargetSoftRegisteredAmount() const
 {
-	if (bSoftRegisteredTargetInstance)
+	if (ActivationState.bSoftRegisteredTargetInstance)
 	{
 		if (GetInstigatorBaseAbilitySystemComponent())
 		{
-			return GetInstigatorBaseAbilitySystemComponent()->GetSoftRegisteredCollisionActorsAmount(IndividualData.ActivationKey, GetIsReplicated());
+			return GetInstigatorBaseAbilitySystemComponent()->GetSoftRegisteredCollisionActorsAmount(ActivationState.IndividualData.ActivationKey, GetIsReplicated());
 		}
 	}
 
@@ -1721,11 +1943,11 @@ void ABaseCollisionActor::AddPreviousTarget(AActor* TargetToAdd)
 	{				
 		if (GetInstigatorBaseAbilitySystemComponent())
 		{
-			GetInstigatorBaseAbilitySystemComponent()->AddSharedTarget(IndividualData.ActivationKey, TargetToAdd, GetIsReplicated());
+			GetInstigatorBaseAbilitySystemComponent()->AddSharedTarget(ActivationState.IndividualData.ActivationKey, TargetToAdd, GetIsReplicated());
 		}	
 
 		//This is done in both cases, because it allows to track what targets were targeted by this actor.
-		PreviousTargetedActors.AddUnique(TargetToAdd);		
+		ActivationState.PreviousTargetedActors.AddUnique(TargetToAdd);		
 	}	
 }
 
@@ -1735,33 +1957,33 @@ void ABaseCollisionActor::AddPreviousTargets(TArray<TWeakObjectPtr<AActor>>& Tar
 	{				
 		if (GetInstigatorBaseAbilitySystemComponent())
 		{
-			GetInstigatorBaseAbilitySystemComponent()->AddSharedTargets(IndividualData.ActivationKey, TargetsToAdd, GetIsReplicated());
+			GetInstigatorBaseAbilitySystemComponent()->AddSharedTargets(ActivationState.IndividualData.ActivationKey, TargetsToAdd, GetIsReplicated());
 		}
 
-		PreviousTargetedActors.Append(TargetsToAdd);
+		ActivationState.PreviousTargetedActors.Append(TargetsToAdd);
 	}	
 }
 
 void ABaseCollisionActor::RemovePreviousTarget(AActor* TargetToRemove)
 {	
-	GetInstigatorBaseAbilitySystemComponent()->RemoveSharedTarget(IndividualData.ActivationKey, TargetToRemove, GetIsReplicated());
+	GetInstigatorBaseAbilitySystemComponent()->RemoveSharedTarget(ActivationState.IndividualData.ActivationKey, TargetToRemove, GetIsReplicated());
 	if (!TransferPersistentEffects(TargetToRemove))
 	{
 		//We remove the target if we cannot find a new CA that continues the effect.
-		PreviousTargetedActors.Remove(TargetToRemove);
+		ActivationState.PreviousTargetedActors.Remove(TargetToRemove);
 	}
 	else
 	{
-		PreviousTargetedActors.Remove(TargetToRemove);
+		ActivationState.PreviousTargetedActors.Remove(TargetToRemove);
 	}
 }
 
 void ABaseCollisionActor::ClearPreviousTargets()
 {
-	if (PreviousTargetedActors.Num() > 0)
+	if (ActivationState.PreviousTargetedActors.Num() > 0)
 	{	
 		//Local copy to avoid changing array elements while looping.
-		TArray<TWeakObjectPtr<AActor>> LocalTargets = PreviousTargetedActors;
+		TArray<TWeakObjectPtr<AActor>> LocalTargets = ActivationState.PreviousTargetedActors;
 		
 		for (auto iter(LocalTargets.CreateIterator()); iter; iter++)
 		{
@@ -1772,7 +1994,27 @@ void ABaseCollisionActor::ClearPreviousTargets()
 
 void ABaseCollisionActor::AddPreviousInteractableTarget(AActor* TargetToAdd)
 {
-	PreviousInteractableActors.Add(TargetToAdd);
+	ActivationState.PreviousInteractableActors.Add(TargetToAdd);
+}
+
+FSharedGameplayTagContainer ABaseCollisionActor::GetOwningAbilityTagsWithContext(const FGameplayTagContainer* ContextTags) const
+{
+	if (ContextTags && ContextTags->Num())
+	{
+		return FSharedGameplayTagContainer::Union(ActivationState.SharedOwningAbilityTags, FSharedGameplayTagContainer::Intern(*ContextTags));
+	}
+
+	return ActivationState.SharedOwningAbilityTags;
+}
+
+bool ABaseCollisionActor::HasOwningAbilityFlag(EAbilityBehaviorFlags Flag) const
+{
+	return EnumHasAnyFlags(ActivationState.OwningAbilityFlags, Flag);
+}
+
+float ABaseCollisionActor::GetRetargetTime() const
+{
+	return Duration.FirstPeriodDelay + ActivationState.ExecutedPeriods * Duration.Period;
 }
 
 void ABaseCollisionActor::SetInRecycleQueue_Implementation(bool NewValue)
@@ -1796,28 +2038,300 @@ void ABaseCollisionActor::ReuseAfterRecycle_Implementation()
 	//bPreactivated = true;
 }
 
-void ABaseCollisionActor::PoolCollisionActor()
+void ABaseCollisionActor::ClearRecycleState(bool bFastPath)
 {
-	/**
-	*	Wait one frame, so it is still valid for other actors of the same activation to check for shared targets.
-	*	This is important for instant AOES because they activate, and destroy before others activate, losing the allready targeted actors.
-	*	If one frame is not enough we may need to keep the actor alive for a longer period of time before pooling and unregistering it from targets.	
-	*/
-	UnregisterSharedTargetInstance();
-
-	//Remove data from replicated array.
-	if (HasAuthority() && GetInstigatorBaseAbilitySystemComponent() != nullptr)
+	auto StopTimeline = [this](UTimelineComponent* Timeline)
 	{
-		GetInstigatorBaseAbilitySystemComponent()->CollisionActorIndividualData.Items.Remove(IndividualData);
-		GetInstigatorBaseAbilitySystemComponent()->CollisionActorIndividualData.MarkArrayDirty();
-		GetInstigatorBaseAbilitySystemComponent()->CollisionActorSharedData.DecreaseSharedDataCounter(SharedData.ID, GetWorldTime());
+		if (Timeline)
+		{
+			// May be too spammy, but want to call visibility to this. Maybe make this editor only?
+			if (Timeline->IsPlaying())
+			{
+				UE_LOG(CollisionActorLog, Warning, TEXT("Collision Actor %s had active timelines when it was recycled."), *GetName());
+			}
+
+			Timeline->SetPlaybackPosition(0.f, false, false);
+			Timeline->Stop();
+		}
+	};
+
+	// End timeline components
+	if (!bFastPath)
+	{
+		TInlineComponentArray<UTimelineComponent*> TimelineComponents(this);
+		for (UTimelineComponent* Timeline : TimelineComponents)
+		{
+			StopTimeline(Timeline);
+		}
+	}
+	else if (bUsesTimelines)
+	{
+		for (UTimelineComponent* Timeline : RecycleTimelineComponents)
+		{
+			StopTimeline(Timeline);
+		}
+	}
+
+	UWorld* MyWorld = GetWorld();
+	if (!MyWorld)
+	{
+		return;
+	}
+
+	//Lifecycle steps on the scheduler aren't timers of this object.
+	if (LifecycleScheduleIndex != INDEX_NONE)
+	{
+		if (UCollisionActorSchedulerSubsystem* Scheduler = GetLifecycleScheduler())
+		{
+			Scheduler->ClearAllEvents(LifecycleScheduleIndex);
+		}
+	}
+
+	if (!bFastPath || bUsesExternalTimers)
+	{
+		MyWorld->GetTimerManager().ClearAllTimersForObject(this);
+	}
+	else
+	{
+		ClearOwnedTimers();
+	}
+
+	//Clear latent actions
+	if (!bFastPath || bUsesLatentActions)
+	{
+		if (MyWorld->GetLatentActionManager().GetNumActionsForObject(this))
+		{
+			//May be too spammy, but want ot call visibility to this. Maybe make this editor only?
+			UE_LOG(CollisionActorLog, Warning, TEXT("Collision Actor %s has active latent actions (Delays, etc) when it was recycled."), *GetName());
+		}
+
+		//End latent actions
+		MyWorld->GetLatentActionManager().RemoveActionsForObject(this);
+	}
+}
+
+void ABaseCollisionActor::ClearOwnedTimers()
+{
+	FTimerManager& TimerManager = GetWorld()->GetTimerManager();
+	TimerManager.ClearTimer(DurationTimerHandle);
+	TimerManager.ClearTimer(DeactivationDelayTimerHandle);
+	TimerManager.ClearTimer(ActivationDelayTimerHandle);
+	TimerManager.ClearTimer(PreactivationTimerHandle);
+	TimerManager.ClearTimer(RotationCompleteTimer);
+	TimerManager.ClearTimer(RotationSyncTimerHandle);
+	TimerManager.ClearTimer(AreaPeriodTimerHandle);
+	TimerManager.ClearTimer(ClearTargetsTimerHandle);
+	TimerManager.ClearTimer(PoolTimerHandle);
+}
+
+void ABaseCollisionActor::SetLifecycleTimer(ECollisionActorScheduleEvent Event, float Delay, float Period)
+{
+	UWorld* World = GetWorld();
+	if (!World)
+	{
+		return;
+	}
+
+	ClearLifecycleTimer(Event);
+
+	UCollisionActorSchedulerSubsystem* Scheduler = UCollisionActorSchedulerSubsystem::IsEnabled() ? GetLifecycleScheduler() : nullptr;
+	if (Scheduler)
+	{
+		if (LifecycleScheduleIndex == INDEX_NONE)
+		{
+			LifecycleScheduleIndex = Scheduler->AllocateSchedule(this);
+		}
+		Scheduler->SetEvent(LifecycleScheduleIndex, Event, Delay, Period);
+	}
+	else
+	{
+		//Same next tick behaviour as the scheduler for non positive delays.
+		const float FirstDelay = FMath::Max(Delay, UE_KINDA_SMALL_NUMBER);
+		World->GetTimerManager().SetTimer(GetLifecycleTimerHandle(Event), FTimerDelegate::CreateUObject(this, &ABaseCollisionActor::OnScheduledEvent, Event), Period > 0.f ? Period : FirstDelay, Period > 0.f, FirstDelay);
+	}
+}
+
+void ABaseCollisionActor::ClearLifecycleTimer(ECollisionActorScheduleEvent Event)
+{
+	//Clear both, the scheduler may have been toggled since the timer was set.
+	if (LifecycleScheduleIndex != INDEX_NONE)
+	{
+		if (UCollisionActorSchedulerSubsystem* Scheduler = GetLifecycleScheduler())
+		{
+			Scheduler->ClearEvent(LifecycleScheduleIndex, Event);
+		}
+	}
+
+	if (UWorld* World = GetWorld())
+	{
+		World->GetTimerManager().ClearTimer(GetLifecycleTimerHandle(Event));
+	}
+}
+
+bool ABaseCollisionActor::IsLifecycleTimerActive(ECollisionActorScheduleEvent Event)
+{
+	if (LifecycleScheduleIndex != INDEX_NONE)
+	{
+		const UCollisionActorSchedulerSubsystem* Scheduler = GetLifecycleScheduler();
+		if (Scheduler && Scheduler->IsEventPending(LifecycleScheduleIndex, Event))
+		{
+			return true;
+		}
+	}
+
+	const UWorld* World = GetWorld();
+	return World && World->GetTimerManager().IsTimerActive(GetLifecycleTimerHandle(Event));
+}
+
+void ABaseCollisionActor::OnScheduledEvent(ECollisionActorScheduleEvent Event)
+{
+	switch (Event)
+	{
+	case ECollisionActorScheduleEvent::BeginActivate:
+		BeginActivate();
+		break;
+	case ECollisionActorScheduleEvent::FinishActivate:
+		FinishActivate();
+		break;
+	case ECollisionActorScheduleEvent::Period:
+		OnAreaOfEffectPeriod();
+		break;
+	case ECollisionActorScheduleEvent::Expire:
+		Expire();
+		break;
+	case ECollisionActorScheduleEvent::Pool:
+		PoolCollisionActor();
+		break;
+	default:
+		break;
+	}
+}
+
+FTimerHandle& ABaseCollisionActor::GetLifecycleTimerHandle(ECollisionActorScheduleEvent Event)
+{
+	switch (Event)
+	{
+	case ECollisionActorScheduleEvent::BeginActivate:
+		return PreactivationTimerHandle;
+	case ECollisionActorScheduleEvent::FinishActivate:
+		return ActivationDelayTimerHandle;
+	case ECollisionActorScheduleEvent::Period:
+		return AreaPeriodTimerHandle;
+	case ECollisionActorScheduleEvent::Expire:
+		return DurationTimerHandle;
+	default:
+		return PoolTimerHandle;
 	}
+}
+
+UCollisionActorSchedulerSubsystem* ABaseCollisionActor::GetLifecycleScheduler() const
+{
+	UWorld* World = GetWorld();
+	return World ? World->GetSubsystem<UCollisionActorSchedulerSubsystem>() : nullptr;
+}
 
-	InstigatorASC = nullptr;
-	InstigatorBaseASC = nullptr;
+void ABaseCollisionActor::ReleaseReferencesForPool()
+{
+	ActivationState.EffectContainerSpec = FGameplayEffectContainerSpec();
+	ActivationState.OwningAbilityTags.Reset();
+	ActivationState.ActivationBlock.Reset();
+	ActivationState.PreviousTargetedActors.Empty();
+	ActivationState.PreviousInteractableActors.Empty();
+	ActivationState.PreviousInterpZValues.Empty();
+	ActivationState.TargetHitHistory.Reset();
+
+	ActivationState.InstigatorASC = nullptr;
+	ActivationState.InstigatorBaseASC = nullptr;
+	GameplayCueManager = nullptr;
+	SetOwner(nullptr);
+	SetInstigator(nullptr);
+}
+
+bool ABaseCollisionActor::IsFastRecycleEnabled()
+{
+	return FastCollisionActorRecycle != 0;
+}
 
-	IndividualData = FCollisionActorIndividualData();
-	SharedData = FCollisionActorSharedData();
+void ABaseCollisionActor::BenchmarkRecycle(const TArray<FString>& Args, UWorld* World)
+{
+	if (!World)
+	{
+		return;
+	}
+
+	UClass* Class = nullptr;
+	if (Args.Num() > 0)
+	{
+		Class = FSoftClassPath(Args[0]).TryLoadClass<ABaseCollisionActor>();
+	}
+	else
+	{
+		for (TObjectIterator<UClass> It; It; ++It)
+		{
+			if (It->IsChildOf(ABaseCollisionActor::StaticClass()) && !It->HasAnyClassFlags(CLASS_Abstract | CLASS_Deprecated | CLASS_NewerVersionExists))
+			{
+				Class = *It;
+				break;
+			}
+		}
+	}
+
+	if (!Class)
+	{
+		UE_LOG(CollisionActorLog, Warning, TEXT("ABaseCollisionActor::BenchmarkRecycle: No collision actor class to spawn."));
+		return;
+	}
+
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	ABaseCollisionActor* Actor = World->SpawnActor<ABaseCollisionActor>(Class, FTransform::Identity, SpawnParameters);
+	if (!Actor)
+	{
+		return;
+	}
+
+	const int32 Iterations = Args.Num() > 1 ? FMath::Max(1, FCString::Atoi(*Args[1])) : 10000;
+
+	//Same cleanup as a deactivation, with the particle reset of the next activation.
+	auto Measure = [Actor, Iterations](bool bFastPath)
+	{
+		const int32 PreviousFastRecycle = FastCollisionActorRecycle;
+		FastCollisionActorRecycle = bFastPath;
+
+		const double StartTime = FPlatformTime::Seconds();
+		for (int32 Iteration = 0; Iteration < Iterations; Iteration++)
+		{
+			Actor->ClearRecycleState(bFastPath);
+			Actor->ResetParticleSystems();
+		}
+		const double Elapsed = FPlatformTime::Seconds() - StartTime;
+
+		FastCollisionActorRecycle = PreviousFastRecycle;
+		return Iterations / FMath::Max(Elapsed, UE_DOUBLE_SMALL_NUMBER);
+	};
+
+	const double GenericRate = Measure(false);
+	const double FastRate = Measure(true);
+
+	UE_LOG(CollisionActorLog, Log, TEXT("Recycle benchmark %s, %d iterations: generic %.0f recycles/s, fast %.0f recycles/s (%.2fx). Timelines:%d LatentActions:%d ExternalTimers:%d"),
+		*Class->GetName(), Iterations, GenericRate, FastRate, FastRate / FMath::Max(GenericRate, UE_DOUBLE_SMALL_NUMBER), Actor->bUsesTimelines, Actor->bUsesLatentActions, Actor->bUsesExternalTimers);
+
+	Actor->Destroy();
+}
+
+void ABaseCollisionActor::PoolCollisionActor()
+{
+	/**
+	*	Wait one frame, so it is still valid for other actors of the same activation to check for shared targets.
+	*	This is important for instant AOES because they activate, and destroy before others activate, losing the allready targeted actors.
+	*	If one frame is not enough we may need to keep the actor alive for a longer period of time before pooling and unregistering it from targets.	
+	*/
+	UnregisterSharedTargetInstance();
+	ReleaseInstigatorData();
+
+	ActivationState.IndividualData = FCollisionActorIndividualData();
+	ActivationState.SharedData = FCollisionActorSharedData();
+	ActivationState.ActivationBlock.Reset();
 
 	//Destroy if we could not use the pool. Give time for VFX to finish.
 	if (GetWorld())
@@ -1828,6 +2342,15 @@ void ABaseCollisionActor::PoolCollisionActor()
 
 			if (HasAuthority() && GetNetMode() != ENetMode::NM_Client)
 			{
+				if (UCollisionActorPoolSubsystem::IsEnabled())
+				{
+					if (UCollisionActorPoolSubsystem* PoolSubsystem = GetWorld()->GetSubsystem<UCollisionActorPoolSubsystem>())
+					{
+						PoolSubsystem->ReleaseCollisionActor(this);
+						return;
+					}
+				}
+
 				UMyAbilitySystemGlobals* MyASG = Cast<UMyAbilitySystemGlobals>(IGameplayAbilitiesModule::Get().GetAbilitySystemGlobals());
 				if (MyASG)
 				{
@@ -1836,6 +2359,16 @@ void ABaseCollisionActor::PoolCollisionActor()
 				}
 			}
 		}
+
+		//Predicted and cosmetic instances are spawned locally, recycle them in the local pool instead of destroying them.
+		if (HasAuthority() && UCollisionActorPoolSubsystem::IsEnabled() && UCollisionActorPoolSubsystem::IsLocalCollisionActor(this))
+		{
+			if (UCollisionActorPoolSubsystem* PoolSubsystem = GetWorld()->GetSubsystem<UCollisionActorPoolSubsystem>())
+			{
+				PoolSubsystem->ReleaseCollisionActor(this);
+				return;
+			}
+		}
 	
 		SetLifeSpan(5.f);	
 	}
@@ -1845,16 +2378,343 @@ void ABaseCollisionActor::PoolCollisionActor()
 	}
 }
 
+void ABaseCollisionActor::ReleaseInstigatorData()
+{
+	//Remove data from replicated array.
+	if (HasAuthority() && GetInstigatorBaseAbilitySystemComponent() != nullptr)
+	{
+		if (VolleyID != INDEX_NONE)
+		{
+			GetInstigatorBaseAbilitySystemComponent()->CollisionActorVolleys.ReleaseInstance(VolleyID);
+		}
+		else
+		{
+			GetInstigatorBaseAbilitySystemComponent()->CollisionActorIndividualData.Items.Remove(ActivationState.IndividualData);
+			GetInstigatorBaseAbilitySystemComponent()->CollisionActorIndividualData.MarkArrayDirty();
+		}
+
+		GetInstigatorBaseAbilitySystemComponent()->CollisionActorSharedData.DecreaseSharedDataCounter(ActivationState.SharedData.ID, GetWorldTime());
+	}
+
+	ActivationState.InstigatorASC = nullptr;
+	ActivationState.InstigatorBaseASC = nullptr;
+	VolleyID = INDEX_NONE;
+	bSharedTargetingRegisteredByVolley = false;
+}
+
+int32 ABaseCollisionActor::SpawnVolley(UBaseAbilitySystemComponent* InASC, TSubclassOf<ABaseCollisionActor> Class, const FCollisionActorIndividualData& InIndividualData, TArrayView<const FTransform> Transforms, TArrayView<const int32> SpawnIndices, AActor* InOwner, APawn* InInstigator, const FGameplayEffectContainerSpec& InEffectContainerSpec, TArray<ABaseCollisionActor*>& OutActors)
+{
+	OutActors.Reset();
+
+	UWorld* World = InASC ? InASC->GetWorld() : nullptr;
+	if (!Class || !World || Transforms.IsEmpty() || Transforms.Num() != SpawnIndices.Num())
+	{
+		return INDEX_NONE;
+	}
+
+	UCollisionActorPoolSubsystem* PoolSubsystem = UCollisionActorPoolSubsystem::IsEnabled() ? World->GetSubsystem<UCollisionActorPoolSubsystem>() : nullptr;
+	if (PoolSubsystem)
+	{
+		PoolSubsystem->AcquireCollisionActors(Class, Transforms, InOwner, InInstigator, OutActors);
+	}
+	else
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.Owner = InOwner;
+		SpawnParams.Instigator = InInstigator;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+		for (const FTransform& Transform : Transforms)
+		{
+			OutActors.Add(World->SpawnActor<ABaseCollisionActor>(Class, Transform, SpawnParams));
+		}
+	}
+
+	FCollisionActorVolleyItem Volley;
+	Volley.IndividualData = InIndividualData;
+	for (int32 i = 0; i < OutActors.Num(); i++)
+	{
+		if (ABaseCollisionActor* Actor = OutActors[i])
+		{
+			Actor->SetEffectContainerSpec(InEffectContainerSpec);
+
+			FCollisionActorVolleyInstance& Instance = Volley.Instances.AddDefaulted_GetRef();
+			Instance.Actor = Actor;
+			Instance.SpawnIndex = SpawnIndices[i];
+		}
+	}
+
+	OutActors.RemoveAll([](const ABaseCollisionActor* Actor) { return Actor == nullptr; });
+	if (OutActors.IsEmpty())
+	{
+		return INDEX_NONE;
+	}
+
+	Volley.VolleyID = InASC->CollisionActorVolleys.AddVolley(Volley.IndividualData, CopyTemp(Volley.Instances));
+	PreActivateVolley(InASC, Volley);
+	return Volley.VolleyID;
+}
+
+void ABaseCollisionActor::PreActivateVolley(UBaseAbilitySystemComponent* InASC, FCollisionActorVolleyItem& Volley)
+{
+	if (!InASC)
+	{
+		return;
+	}
+
+	if (Volley.PreactivatedInstances.Num() != Volley.Instances.Num())
+	{
+		Volley.PreactivatedInstances.Init(false, Volley.Instances.Num());
+	}
+
+	//Instances whose actor hasn't replicated yet are left out, and preactivated by a later call once it has.
+	TArray<int32, TInlineAllocator<16>> ValidInstances;
+	for (int32 i = 0; i < Volley.Instances.Num(); i++)
+	{
+		if (!Volley.PreactivatedInstances[i] && IsValid(Volley.Instances[i].Actor))
+		{
+			ValidInstances.Add(i);
+		}
+	}
+
+	if (ValidInstances.IsEmpty())
+	{
+		return;
+	}
+
+	//One registration for the instances preactivated by this call, instead of one per instance in SetIndividualData.
+	const bool bReplicated = Volley.Instances[ValidInstances[0]].Actor->GetIsReplicated();
+	InASC->RegisterCollisionActorForSharedTargeting(Volley.IndividualData.ActivationKey, ValidInstances.Num(), bReplicated);
+
+	for (const int32 InstanceIndex : ValidInstances)
+	{
+		Volley.PreactivatedInstances[InstanceIndex] = true;
+
+		ABaseCollisionActor* Actor = Volley.Instances[InstanceIndex].Actor;
+		Actor->VolleyID = Volley.VolleyID;
+		Actor->bSharedTargetingRegisteredByVolley = true;
+		Actor->PreActivateCollisionActor(Volley.GetInstanceIndividualData(InstanceIndex));
+	}
+}
+
+bool ABaseCollisionActor::CanRunActorless(const FGameplayEffectContainerSpec& InEffectContainerSpec) const
+{
+	if (!bAllowActorlessInstances || !UAoEInstanceSubsystem::IsEnabled())
+	{
+		return false;
+	}
+
+	//Interpolations and incremental tracking need a live actor.
+	if (ScaleInterpolation.ScaleCurve != nullptr || RotationInterpolation.RotationRate != 0.f || bIncrementalOverlapTracking)
+	{
+		return false;
+	}
+
+	//Only instant and periodic areas, continuous ones react to overlap events.
+	if (Duration.LifeSpan != 0.f && Duration.Period <= 0.f)
+	{
+		return false;
+	}
+
+	//Looping cues are added and removed with the actor. Instances only send executed cues through the instigator, see DispatchGameplayCue.
+	if (PreactivationGameplayCue.IsValid() || (Duration.LifeSpan != 0.f && (ActorGameplayCue.IsValid() || PreviewGameplayCue.IsValid())))
+	{
+		return false;
+	}
+
+	//Persistent effects are removed when targets stop overlapping the actor.
+	for (auto& it : InEffectContainerSpec.TargetGameplayEffectSpecs)
+	{
+		if (it.Data.IsValid() && it.Data.Get()->Def->DurationPolicy == EGameplayEffectDurationType::Infinite)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void ABaseCollisionActor::BindAoEInstance(FAoEInstance& Instance)
+{
+	SetActorTransform(Instance.Transform, false, nullptr, ETeleportType::TeleportPhysics);
+	SetOwner(Instance.Owner.Get());
+	SetInstigator(Instance.Instigator.Get());
+	SwapAoEInstanceState(Instance);
+
+	Filter.InitializeFilterContext(GetInstigator() != nullptr ? GetInstigator() : GetOwner());
+}
+
+void ABaseCollisionActor::UnbindAoEInstance(FAoEInstance& Instance)
+{
+	Instance.Transform = GetActorTransform();
+	SwapAoEInstanceState(Instance);
+}
+
+void ABaseCollisionActor::SwapAoEInstanceState(FAoEInstance& Instance)
+{
+	Swap(ActivationState, Instance.State);
+	Swap(Duration, Instance.Duration);
+}
+
+float ABaseCollisionActor::BeginAoEInstance()
+{
+	//Same as BeginActivate for a server actor without prediction. The state of the instance starts from its defaults, and CanRunActorless already excluded persistent effects.
+	InitializeScale();
+
+	if (Duration.ActivationDelay > 0.f)
+	{
+		AdjustTransform();
+		InitializePreactivationGameplayCue();
+		return Duration.ActivationDelay;
+	}
+
+	return 0.f;
+}
+
+void ABaseCollisionActor::FinishActivateAoEInstance()
+{
+	ActivationState.bActive = true;
+	ActivationState.StartTime = UKismetSystemLibrary::GetGameTimeInSeconds(this);
+
+	if (Duration.ActivationDelay == 0.f)
+	{
+		AdjustTransform();
+	}
+
+	SetStartLocation();
+	RemovePreactivationGameplayCue();
+	InitializeActorGameplayCue();
+	ExecuteGameplayCues();
+
+	OnCollisionActorActivate.Broadcast(this);
+	SendCollisionActorEvent(UGlobalTags::Event_CollisionActorActivate());
+
+	if (Duration.LifeSpan == 0.f)
+	{
+		TArray<AActor*> OverlappingActors;
+		GetAoEInstanceOverlaps(OverlappingActors);
+		ApplyEffectToActorArray(OverlappingActors, nullptr, false);
+	}
+	else
+	{
+		InitializePreviewGameplayCue();
+
+		//Same period setup as InitializePersistentElements, the subsystem runs the timers.
+		ActivationState.bDiscreteCollisionChecks = false;
+		ActivationState.bAllowRetargetting = true;
+		ActivationState.TargetHitHistory.RetargetInterval = Duration.Period;
+		ActivationState.ExecutedPeriods = 0;
+		ActivationState.MaximumPeriodsToExecute = FMath::TruncToInt((Duration.LifeSpan - Duration.FirstPeriodDelay) / Duration.Period) + 1;
+	}
+}
+
+void ABaseCollisionActor::ExecuteAoEInstancePeriod()
+{
+	TArray<AActor*> OverlappingActors;
+	GetAoEInstanceOverlaps(OverlappingActors);
+	ApplyAreaOfEffectPeriod(OverlappingActors);
+}
+
+void ABaseCollisionActor::DeactivateAoEInstance()
+{
+	if (ActivationState.bActive)
+	{
+		OnCollisionActorDeactivate.Broadcast(this);
+
+		SendDeactivationEvents();
+		SoftUnregisterSharedTargetInstance();
+		RemoveGameplayCues();
+		ReleasePeriodStagger();
+
+		ActivationState.PreviousTargetedActors.Empty();
+		ActivationState.PreviousInteractableActors.Empty();
+		ActivationState.TargetHitHistory.Reset();
+
+		ActivationState.bActive = false;
+	}
+}
+
+void ABaseCollisionActor::ReleaseAoEInstance()
+{
+	UnregisterSharedTargetInstance();
+	ReleaseInstigatorData();
+}
+
+void ABaseCollisionActor::GetAoEInstanceOverlaps(TArray<AActor*>& OutActors) const
+{
+	OutActors.Reset();
+
+	UWorld* World = GetWorld();
+	if (!World || !ShapeComp)
+	{
+		return;
+	}
+
+	//Same query as the shape would run with collision enabled, at its current transform and scale.
+	TArray<FOverlapResult> Overlaps;
+	FCollisionQueryParams Params(SCENE_QUERY_STAT(AoEInstanceOverlaps), false, this);
+	World->OverlapMultiByChannel(Overlaps, ShapeComp->GetComponentLocation(), ShapeComp->GetComponentQuat(), ShapeComp->GetCollisionObjectType(), ShapeComp->GetCollisionShape(), Params, FCollisionResponseParams(ShapeComp->GetCollisionResponseToChannels()));
+
+	for (const FOverlapResult& Overlap : Overlaps)
+	{
+		UPrimitiveComponent* const Component = Overlap.GetComponent();
+		AActor* const Actor = Overlap.GetActor();
+
+		//Overlap events need both components to generate them.
+		if (Component && Actor && Component->GetGenerateOverlapEvents())
+		{
+			OutActors.AddUnique(Actor);
+		}
+	}
+}
+
 bool ABaseCollisionActor::CanExecuteGameplayCue() const
 {
-	return GetNetMode() != ENetMode::NM_DedicatedServer && !bSkipGameplayCues;
+	//Executors run on the server and send the cues of their instances to clients.
+	return (GetNetMode() != ENetMode::NM_DedicatedServer || bActorlessExecutor) && !ActivationState.bSkipGameplayCues;
+}
+
+void ABaseCollisionActor::DispatchGameplayCue(AActor* Target, FGameplayTag CueTag, EGameplayCueEvent::Type EventType, const FGameplayCueParameters& Params)
+{
+	if (!bActorlessExecutor)
+	{
+		GetGameplayCueManager()->HandleGameplayCue(Target, CueTag, EventType, Params);
+		return;
+	}
+
+	//Hit cues go through the target, area cues through the instigator. The executor doesn't replicate, so it can't be referenced by the parameters.
+	//Only executed cues are sent, at the location of the instance: added cues would change the owned tags of the instigator, collide between instances of
+	//the same tag and attach to the instigator instead of the area. Classes with looping cues don't run actorless, see CanRunActorless.
+	UAbilitySystemComponent* CueASC = Target != this ? UAbilitySystemGlobals::GetAbilitySystemComponentFromActor(Target) : nullptr;
+	if (!CueASC)
+	{
+		CueASC = GetInstigatorAbilitySystemComponent();
+	}
+
+	if (!CueASC)
+	{
+		return;
+	}
+
+	FGameplayCueParameters ReplicatedParams = Params;
+	ReplicatedParams.EffectCauser = nullptr;
+	ReplicatedParams.TargetAttachComponent = nullptr;
+	if (ReplicatedParams.Location.IsZero())
+	{
+		ReplicatedParams.Location = GetActorLocation();
+	}
+
+	if (EventType == EGameplayCueEvent::Executed)
+	{
+		CueASC->ExecuteGameplayCue(CueTag, ReplicatedParams);
+	}
 }
 
 void ABaseCollisionActor::HandleGameplayCueEvent(FGameplayTag CueTag, EGameplayCueEvent::Type EventType)
 {
 	FGameplayCueParameters CueParams;
 	GetDefaultGameplayCueParams(CueParams);
-	GetGameplayCueManager()->HandleGameplayCue(this, CueTag, EventType, CueParams);
+	DispatchGameplayCue(this, CueTag, EventType, CueParams);
 }
 
 UGameplayCueManager* ABaseCollisionActor::GetGameplayCueManager()
@@ -1876,28 +2736,26 @@ void ABaseCollisionActor::GetDefaultGameplayCueParams(FGameplayCueParameters& Pa
 	Params.Location = GetActorLocation();
 	Params.TargetAttachComponent = GetShapeComponent();
 	Params.Instigator = GetInstigator() != nullptr ? GetInstigator() : GetOwner();
-	Params.AggregatedSourceTags.AppendTags(OwningAbilityTags);
-	Params.SourceObject = IndividualData.TargetActor;
+	Params.AggregatedSourceTags = ActivationState.SharedOwningAbilityTags.Get();
+	Params.SourceObject = ActivationState.IndividualData.TargetActor;
 }
 
 void ABaseCollisionActor::GetPreviewGameplayCueParams(FGameplayCueParameters& Params) const
 {
+	const FPreviewCueCache& Cache = GetPreviewCueCache();
+
 	//InnerRadius
-	Params.GameplayEffectLevel = FMath::Max(GetMinimumDistanceRequiredByLifetime(0, SharedData.AbilityLevel), GetMinimumDistanceRequiredByLifetime(1, SharedData.AbilityLevel));
+	Params.GameplayEffectLevel = Cache.InnerRadius;
 	
 	//Half Angle
-	Params.RawMagnitude = FMath::Max(GetMaximumDirectionDeviationByLifetime(0, SharedData.AbilityLevel), GetMaximumDirectionDeviationByLifetime(1, SharedData.AbilityLevel));
+	Params.RawMagnitude = Cache.HalfAngle;
 	if (Targeting.bScaleMaximumDirectionDeviation)
 	{
-		Params.RawMagnitude *= SharedData.AreaMultiplier;
+		Params.RawMagnitude *= ActivationState.SharedData.AreaMultiplier;
 	}
 
 	//Scaled extent
-	FBoxSphereBounds Bounds = GetShapeComponent()->CalcLocalBounds();
-	FVector Scale = GetCollisionActorScaleByLifetime(0, SharedData.AbilityLevel);
-	Params.Normal.X = Bounds.BoxExtent.X * Scale.X * SharedData.AreaMultiplier;
-	Params.Normal.Y = Bounds.BoxExtent.Y * Scale.Y * SharedData.AreaMultiplier;
-	Params.Normal.Z = Bounds.BoxExtent.Z * Scale.Z * SharedData.AreaMultiplier;
+	Params.Normal = Cache.ScaledLocalExtent * ActivationState.SharedData.AreaMultiplier;
 	Params.AbilityLevel = GetActorRotation().Yaw;
 
 	//General data
@@ -1905,6 +2763,30 @@ void ABaseCollisionActor::GetPreviewGameplayCueParams(FGameplayCueParameters& Pa
 	Params.Instigator = GetInstigator() != nullptr ? GetInstigator() : GetOwner();	
 }
 
+const ABaseCollisionActor::FPreviewCueCache& ABaseCollisionActor::GetPreviewCueCache() const
+{
+	//Without scale interpolation the lifetime scale is the current actor scale, which changes every activation.
+	const bool bCacheable = ScaleInterpolation.IsValid();
+	if (bCacheable && PreviewCueCache.bValid && PreviewCueCache.AbilityClass == ActivationState.IndividualData.AbilityClass && PreviewCueCache.Level == ActivationState.SharedData.AbilityLevel && PreviewCueCache.AbilityTags == ActivationState.SharedOwningAbilityTags)
+	{
+		return PreviewCueCache;
+	}
+
+	if (!CachedShapeLocalBounds.IsSet())
+	{
+		CachedShapeLocalBounds = GetShapeComponent()->CalcLocalBounds();
+	}
+
+	PreviewCueCache.InnerRadius = FMath::Max(GetMinimumDistanceRequiredByLifetime(0, ActivationState.SharedData.AbilityLevel), GetMinimumDistanceRequiredByLifetime(1, ActivationState.SharedData.AbilityLevel));
+	PreviewCueCache.HalfAngle = FMath::Max(GetMaximumDirectionDeviationByLifetime(0, ActivationState.SharedData.AbilityLevel), GetMaximumDirectionDeviationByLifetime(1, ActivationState.SharedData.AbilityLevel));
+	PreviewCueCache.ScaledLocalExtent = CachedShapeLocalBounds->BoxExtent * GetCollisionActorScaleByLifetime(0, ActivationState.SharedData.AbilityLevel);
+	PreviewCueCache.AbilityClass = ActivationState.IndividualData.AbilityClass;
+	PreviewCueCache.Level = ActivationState.SharedData.AbilityLevel;
+	PreviewCueCache.AbilityTags = ActivationState.SharedOwningAbilityTags;
+	PreviewCueCache.bValid = bCacheable;
+	return PreviewCueCache;
+}
+
 bool ABaseCollisionActor::GetImpactLocationForGameplayCues(AActor* HitActor, FVector& Location, FVector& Normal) const
 {
 	//try to find a point close to the mesh for gameplay cues.
@@ -1928,12 +2810,12 @@ FGameplayTag ABaseCollisionActor::GetPreactivationGameplayCue() const
 	if (!PreactivationGameplayCue.IsValid())
 	{
 		//Override GC for trap and mines if needed.
-		if (OwningAbilityTags.HasTag(UGlobalTags::Ability_Device_Mine()))
+		if (HasOwningAbilityFlag(EAbilityBehaviorFlags::DeviceMine))
 		{
 			return UGlobalTags::GameplayCue_Mine();
 		}
 
-		if (OwningAbilityTags.HasTag(UGlobalTags::Ability_Device_Trap()))
+		if (HasOwningAbilityFlag(EAbilityBehaviorFlags::DeviceTrap))
 		{
 			return UGlobalTags::GameplayCue_Trap();
 		}
@@ -1951,80 +2833,80 @@ void ABaseCollisionActor::ExecuteGameplayCues()
 
 		if (BurstGameplayCue.IsValid())
 		{
-			GetGameplayCueManager()->HandleGameplayCue(this, BurstGameplayCue, EGameplayCueEvent::Executed, CueParams);
+			DispatchGameplayCue(this, BurstGameplayCue, EGameplayCueEvent::Executed, CueParams);
 		}
 		else
 		{
 			UE_LOG(CollisionActorLog, Log, TEXT("No Burst GameplayCue Tag set for %s"), *GetName());
 		}
 
-		if (bActorGameplayCueInitialized)
+		if (ActivationState.bActorGameplayCueInitialized)
 		{
-			GetGameplayCueManager()->HandleGameplayCue(this, ActorGameplayCue, EGameplayCueEvent::Executed, CueParams);
+			DispatchGameplayCue(this, ActorGameplayCue, EGameplayCueEvent::Executed, CueParams);
 		}
 	}
 }
 
 void ABaseCollisionActor::InitializeActorGameplayCue()
 {
-	if (CanExecuteGameplayCue() && !bActorGameplayCueInitialized && ActorGameplayCue.IsValid() && Duration.LifeSpan != 0)
+	if (CanExecuteGameplayCue() && !ActivationState.bActorGameplayCueInitialized && ActorGameplayCue.IsValid() && Duration.LifeSpan != 0)
 	{
 		if (CanExecuteGameplayCue())
 		{
 			FGameplayCueParameters CueParams;
 			GetDefaultGameplayCueParams(CueParams);
-			GetGameplayCueManager()->HandleGameplayCue(this, ActorGameplayCue, EGameplayCueEvent::OnActive, CueParams);
-			bActorGameplayCueInitialized = true;
+			DispatchGameplayCue(this, ActorGameplayCue, EGameplayCueEvent::OnActive, CueParams);
+			ActivationState.bActorGameplayCueInitialized = true;
 		}
 
-		bExecuteDeactivationCue = true;
+		ActivationState.bExecuteDeactivationCue = true;
 	}
 }
 
 void ABaseCollisionActor::InitializePreactivationGameplayCue()
 {
-	if (CanExecuteGameplayCue() && !bPreactivationGameplayCueInitialized && PreactivationGameplayCue.IsValid())
+	if (CanExecuteGameplayCue() && !ActivationState.bPreactivationGameplayCueInitialized && PreactivationGameplayCue.IsValid())
 	{
 		FGameplayCueParameters CueParams;
 		GetDefaultGameplayCueParams(CueParams);
-		GetGameplayCueManager()->HandleGameplayCue(this, GetPreactivationGameplayCue(), EGameplayCueEvent::OnActive, CueParams);
-		bPreactivationGameplayCueInitialized = true;				
+		DispatchGameplayCue(this, GetPreactivationGameplayCue(), EGameplayCueEvent::OnActive, CueParams);
+		ActivationState.bPreactivationGameplayCueInitialized = true;				
 	}
 }
 
 void ABaseCollisionActor::InitializePreviewGameplayCue()
 {
-	if (CanExecuteGameplayCue() && !bPreviewGameplayCueInitialized && PreviewGameplayCue.IsValid() && Duration.LifeSpan != 0)
+	if (CanExecuteGameplayCue() && !ActivationState.bPreviewGameplayCueInitialized && PreviewGameplayCue.IsValid() && Duration.LifeSpan != 0)
 	{
 		if (CanExecuteGameplayCue())
 		{
 			FGameplayCueParameters CueParams;
 			GetPreviewGameplayCueParams(CueParams);
-			GetGameplayCueManager()->HandleGameplayCue(this, PreviewGameplayCue, EGameplayCueEvent::OnActive, CueParams);
-			bPreviewGameplayCueInitialized = true;
+			DispatchGameplayCue(this, PreviewGameplayCue, EGameplayCueEvent::OnActive, CueParams);
+			ActivationState.bPreviewGameplayCueInitialized = true;
 		}
 
-		bPreviewGameplayCueInitialized = true;
+		ActivationState.bPreviewGameplayCueInitialized = true;
 	}
 }
 
 void ABaseCollisionActor::RemovePreactivationGameplayCue()
 {
-	if (bPreactivationGameplayCueInitialized)
+	if (ActivationState.bPreactivationGameplayCueInitialized)
 	{
 		FGameplayCueParameters CueParams;
 		GetDefaultGameplayCueParams(CueParams);
-		GetGameplayCueManager()->HandleGameplayCue(this, GetPreactivationGameplayCue(), EGameplayCueEvent::Removed, CueParams);
-		bPreactivationGameplayCueInitialized = false;
+		DispatchGameplayCue(this, GetPreactivationGameplayCue(), EGameplayCueEvent::Removed, CueParams);
+		ActivationState.bPreactivationGameplayCueInitialized = false;
 	}
 }
 
 void ABaseCollisionActor::RemovePreviewGameplayCue()
 {
-	if (bPreviewGameplayCueInitialized)
+	if (ActivationState.bPreviewGameplayCueInitialized)
 	{
-		GetGameplayCueManager()->HandleGameplayCue(this, PreviewGameplayCue, EGameplayCueEvent::Removed, FGameplayCueParameters());
-		bPreviewGameplayCueInitialized = false;
+		DispatchGameplayCue(this, PreviewGameplayCue, EGameplayCueEvent::Removed, FGameplayCueParameters());
+		ActivationState.bPreviewGameplayCueInitialized = false;
 	}
 }
 
@@ -2033,11 +2915,11 @@ void ABaseCollisionActor::RemoveGameplayCues()
 	FGameplayCueParameters CueParams;
 	GetDefaultGameplayCueParams(CueParams);
 
-	if (bExecuteDeactivationCue && CanExecuteGameplayCue())
+	if (ActivationState.bExecuteDeactivationCue && CanExecuteGameplayCue())
 	{
 		if (DeactivationGameplayCue.IsValid())
 		{				
-			GetGameplayCueManager()->HandleGameplayCue(this, DeactivationGameplayCue, EGameplayCueEvent::Executed, CueParams);			
+			DispatchGameplayCue(this, DeactivationGameplayCue, EGameplayCueEvent::Executed, CueParams);			
 		}
 		else
 		{
@@ -2045,20 +2927,41 @@ void ABaseCollisionActor::RemoveGameplayCues()
 		}
 	}	
 
-	if (bActorGameplayCueInitialized)
+	if (ActivationState.bActorGameplayCueInitialized)
 	{
-		GetGameplayCueManager()->HandleGameplayCue(this, ActorGameplayCue, EGameplayCueEvent::Removed, CueParams);
-		bActorGameplayCueInitialized = false;
+		DispatchGameplayCue(this, ActorGameplayCue, EGameplayCueEvent::Removed, CueParams);
+		ActivationState.bActorGameplayCueInitialized = false;
 	}
 
 	RemovePreviewGameplayCue();
 
-	bExecuteDeactivationCue = true;
+	ActivationState.bExecuteDeactivationCue = true;
 }
 
 void ABaseCollisionActor::ResetParticleSystems() const
 {
 	//Reset particle systems. This avoids the trails from last used location to new location. Must be done after setting the actor to be seen again.
+	if (IsFastRecycleEnabled())
+	{
+		for (UParticleSystemComponent* ParticleComponent : RecycleParticleComponents)
+		{
+			if (ParticleComponent)
+			{
+				ParticleComponent->ForceReset();
+			}
+		}
+
+		for (UNiagaraComponent* NiagaraComponent : RecycleNiagaraComponents)
+		{
+			if (NiagaraComponent)
+			{
+				NiagaraComponent->ResetSystem();
+			}
+		}
+
+		return;
+	}
+
 	TArray<UParticleSystemComponent*> ParticleComponents;
 	GetComponents(ParticleComponents);
 	for (UParticleSystemComponent*& it : ParticleComponents)
@@ -2083,18 +2986,18 @@ UShapeComponent* ABaseCollisionActor::GetShapeComponent() const
 
 UAbilitySystemComponent* ABaseCollisionActor::GetInstigatorAbilitySystemComponent() const
 {
-	return InstigatorASC;
+	return ActivationState.InstigatorASC;
 }
 
 UBaseAbilitySystemComponent* ABaseCollisionActor::GetInstigatorBaseAbilitySystemComponent() const
 {
-	return InstigatorBaseASC;
+	return ActivationState.InstigatorBaseASC;
 }
 
 void ABaseCollisionActor::SetSourceAbilitySystemComponent()
 {
-	InstigatorASC = UAbilitySystemGlobals::GetAbilitySystemComponentFromActor(GetInstigator() != nullptr ? GetInstigator() : GetOwner());
-	InstigatorBaseASC = Cast<UBaseAbilitySystemComponent>(InstigatorASC);
+	ActivationState.InstigatorASC = UAbilitySystemGlobals::GetAbilitySystemComponentFromActor(GetInstigator() != nullptr ? GetInstigator() : GetOwner());
+	ActivationState.InstigatorBaseASC = Cast<UBaseAbilitySystemComponent>(ActivationState.InstigatorASC);
 }
 
 void ABaseCollisionActor::SendGameplayEvent(UAbilitySystemComponent* InASC, FGameplayTag EventTag, const FGameplayEventData& Payload)
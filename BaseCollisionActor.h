@@ -9,14 +9,132 @@
 #include "AbilitySystem/Targeting/TargetFilter.h"
 #include "AbilitySystem/CollisionActors/CollisionActorTypes.h"
 #include "AbilitySystem/ActorPool/PooledActorInterface.h"
+#include "AbilitySystem/Targeting/TargetHitHistory.h"
+#include "AbilitySystem/AbilityBehaviorFlags.h"
+#include "AbilitySystem/SharedGameplayTagContainer.h"
+#include "AbilitySystem/CollisionActors/CollisionActorActivationBlock.h"
 #include "BaseCollisionActor.generated.h"
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FCollisionActorSignature, ABaseCollisionActor*, CollisionActorReference);
 
 class UGameplayCueManager;
+class UAbilitySystemComponent;
 class UBaseAbilitySystemComponent;
 class UShapeComponent;
 class USceneComponent;
+class UTimelineComponent;
+class UParticleSystemComponent;
+class UNiagaraComponent;
+struct FAoEInstance;
+struct FCollisionActorVolleyItem;
+class UCollisionActorSchedulerSubsystem;
+enum class ECollisionActorScheduleEvent : uint8;
+
+/**
+*	Everything an activation sets on a collision actor, from the individual and shared data to the cue and targeting flags.
+*	Kept in a single struct so actorless instances swap it into their executor as a whole, see FAoEInstance. Members added here are per activation on both paths.
+*	The scaled Duration is per activation too, but it stays on the actor because it is also the class setting.
+*/
+USTRUCT()
+struct CAMERAPLAY_API FCollisionActorActivationState
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FCollisionActorIndividualData IndividualData;
+
+	UPROPERTY()
+	FCollisionActorSharedData SharedData;
+
+	/** State resolved from the shared data, common to every actor of the activation.*/
+	TSharedPtr<const FCollisionActorActivationBlock> ActivationBlock;
+
+	UPROPERTY()
+	FGameplayEffectContainerSpec EffectContainerSpec;
+
+	UPROPERTY()
+	FGameplayTagContainer OwningAbilityTags;
+
+	/** Behavior tags of OwningAbilityTags as flags. Resolved in SetSharedData.*/
+	EAbilityBehaviorFlags OwningAbilityFlags = EAbilityBehaviorFlags::None;
+
+	/** Interned copy of OwningAbilityTags, used to build payload and cue tags.*/
+	FSharedGameplayTagContainer SharedOwningAbilityTags;
+
+	UPROPERTY()
+	UAbilitySystemComponent* InstigatorASC = nullptr;
+
+	UPROPERTY()
+	UBaseAbilitySystemComponent* InstigatorBaseASC = nullptr;
+
+	UPROPERTY()
+	TArray<TWeakObjectPtr<AActor>> PreviousTargetedActors;
+
+	UPROPERTY()
+	TArray<TWeakObjectPtr<AActor>> PreviousInteractableActors;
+
+	/** Last hit time per target. With bAllowRetargetting, a target can be hit again once a period has passed since its last hit.*/
+	FTargetHitHistory TargetHitHistory;
+
+	UPROPERTY()
+	float StartTime = 0.f;
+
+	UPROPERTY()
+	FVector StartLocation = FVector::ZeroVector;
+
+	UPROPERTY()
+	FVector CachedAdditiveScale = FVector::ZeroVector;
+
+	//Data used to smooth height interpolation, by comparing with previous frames.
+	UPROPERTY()
+	TArray<float> PreviousInterpZValues;
+
+	UPROPERTY()
+	int32 MaximumPeriodsToExecute = 0;
+
+	UPROPERTY()
+	int32 ExecutedPeriods = 0;
+
+	/** Phase reserved for the periods in UPeriodicStaggerSubsystem, released on deactivation.*/
+	int32 PeriodStaggerReservation = INDEX_NONE;
+
+	UPROPERTY()
+	bool bActive = false;
+
+	UPROPERTY()
+	bool bDiscreteCollisionChecks = false;
+
+	UPROPERTY()
+	bool bAppliesPersistentEffects = false;
+
+	UPROPERTY()
+	bool bRegisteredTargetInstance = false;
+	
+	UPROPERTY()
+	bool bSoftRegisteredTargetInstance = false;
+
+	/**
+	*	Periodic Areas, that apply instant effects, need to be able to reapply those effects to allready targetted actors. Because of this, we want to allow retargeting of local previous targets in this cases.
+	*	When using shared targets, for periodic effects.
+	*/
+	UPROPERTY()
+	bool bAllowRetargetting = false;
+
+	UPROPERTY()
+	bool bActorGameplayCueInitialized = false;
+
+	UPROPERTY()
+	bool bPreviewGameplayCueInitialized = false;
+
+	UPROPERTY()
+	bool bPreactivationGameplayCueInitialized = false;
+
+	UPROPERTY()
+	bool bExecuteDeactivationCue = true;
+	
+	UPROPERTY()
+	bool bSkipGameplayCues = false;
+};
 
 /** Collision actors are used to apply effects in the world by abilities.*/
 UCLASS(Abstract)
@@ -32,6 +150,7 @@ public:
 
 	ABaseCollisionActor(const FObjectInitializer& ObjectInitializer);
 	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+	virtual void PostInitializeComponents() override;
 	virtual void BeginPlay() override;
 	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	virtual void Tick(float Delta) override;	
@@ -92,6 +211,47 @@ public:
 	UPROPERTY(EditDefaultsOnly, Category = Targeting)
 	ECollisionActorAttachmentType AttachmentType = ECollisionActorAttachmentType::LocationAndRotation;
 
+	/** Homing actors spawned without a target acquire the nearest valid target within this distance on InitializeTarget(). 0 disables the acquisition.*/
+	UPROPERTY(EditDefaultsOnly, Category = Targeting, meta = (ClampMin = 0))
+	float HomingAcquisitionRadius = 0.f;
+
+	/** Half angle in front of the actor, in degrees, in which the homing target is acquired.*/
+	UPROPERTY(EditDefaultsOnly, Category = Targeting, meta = (ClampMin = 0, ClampMax = 180))
+	float HomingAcquisitionHalfAngle = 180.f;
+
+	/**
+	*	Non periodic persistent actors only. Instead of physics begin and end overlap events, the overlapping set is queried every IncrementalOverlapInterval and diffed against the previous one.
+	*	Begin and end overlap logic only runs for the actors that entered or left, and the shape stops generating overlap events while active.
+	*/
+	UPROPERTY(EditDefaultsOnly, Category = "Collision Actor|Performance")
+	bool bIncrementalOverlapTracking = false;
+
+	/** Seconds between two incremental overlap updates. 0 updates every frame.*/
+	UPROPERTY(EditDefaultsOnly, Category = "Collision Actor|Performance", meta = (EditCondition = "bIncrementalOverlapTracking", ClampMin = 0))
+	float IncrementalOverlapInterval = 0.f;
+
+	/** Whether or not this class plays timelines. If not, recycling skips stopping and rewinding them.*/
+	UPROPERTY(EditDefaultsOnly, Category = "Collision Actor|Performance")
+	bool bUsesTimelines = true;
+
+	/** Whether or not this class runs latent actions (Delays, etc). If not, recycling skips looking for them.*/
+	UPROPERTY(EditDefaultsOnly, Category = "Collision Actor|Performance")
+	bool bUsesLatentActions = true;
+
+	/**
+	*	Whether or not this class sets timers other than the ones of ABaseCollisionActor, for example from blueprints.
+	*	If not, recycling clears the handles it owns instead of searching the timer manager for every timer bound to the actor.
+	*/
+	UPROPERTY(EditDefaultsOnly, Category = "Collision Actor|Performance")
+	bool bUsesExternalTimers = true;
+
+	/**
+	*	Periodic areas only. The first period, and every period after it, may be moved up to this many frames to a less crowded frame, see UPeriodicStaggerSubsystem.
+	*	Periods are never moved before the activation or past the lifespan. 0 keeps the exact timing.
+	*/
+	UPROPERTY(EditDefaultsOnly, Category = "Collision Actor|Performance", meta = (ClampMin = 0))
+	int32 PeriodStaggerFrames = 0;
+
 	/**
 	*	Preactivation gameplay cue. Its active while the activation delay is running until we activate the actor gameplay cue.
 	*	WhileActive event is called on interpolation scale changes.
@@ -155,6 +315,9 @@ protected:
 		
 	/** Initilizes variables when receiving the shared data.*/	
 	virtual void SetSharedData(const FCollisionActorSharedData& InSharedData);
+
+	/** Fills the activation block from the shared and individual data. Only runs for the first actor of the activation.*/
+	virtual void ResolveActivationBlock(FCollisionActorActivationBlock& OutBlock) const;
 	
 	/** Initilizes variables when receiving the individual data.*/
 	virtual void SetIndividualData(const FCollisionActorIndividualData& InIndividualData);
@@ -179,6 +342,12 @@ protected:
 	/** Should we send a multihit event at the end. This allows us to gather targets overtime and send a unique multihit with all the targets adquired over the lifetime.*/
 	virtual bool ShouldSendMultihitEventOnDeactivation() const;
 
+	/** Sends the multihit and deactivation gameplay events of the activation.*/
+	void SendDeactivationEvents();
+
+	/** Sends a collision actor lifecycle event, like activate or deactivate, to the instigator.*/
+	void SendCollisionActorEvent(FGameplayTag EventTag);
+
 	/** Called when the actor expires on time. Calls deactivate. */
 	virtual void Expire();
 	
@@ -188,18 +357,12 @@ protected:
 	/** Clears expiration timer. Useful for when we need to override the timer to allow the actor to complete certain behavior like return.*/
 	virtual void ClearExpirationTimer();
 
-	UPROPERTY()
-	bool bActive;
-
 	UPROPERTY()
 	bool bPreactivated;
 
 	UPROPERTY()
 	float PreActivationTime = 0.f;
 
-	UPROPERTY()
-	float StartTime = 0.f;
-
 	UPROPERTY()
 	FTimerHandle DurationTimerHandle;
 
@@ -210,16 +373,19 @@ protected:
 	FTimerHandle ActivationDelayTimerHandle;
 
 	UPROPERTY()
-	bool bSkipVariableInitialization;
+	FTimerHandle PreactivationTimerHandle;
 
 	UPROPERTY()
-	FGameplayTagContainer OwningAbilityTags;
+	bool bSkipVariableInitialization;
 
-	UPROPERTY()
-	FCollisionActorIndividualData IndividualData;
+	bool HasOwningAbilityFlag(EAbilityBehaviorFlags Flag) const;
+
+	/** Owning ability tags plus the context tags, if any.*/
+	FSharedGameplayTagContainer GetOwningAbilityTagsWithContext(const FGameplayTagContainer* ContextTags) const;
 
+	/** State of the current activation. Swapped as a whole by actorless instances.*/
 	UPROPERTY()
-	FCollisionActorSharedData SharedData;
+	FCollisionActorActivationState ActivationState;
 
 public:
 
@@ -264,15 +430,9 @@ public:
 
 protected:
 
-	UPROPERTY()
-	FVector StartLocation;
-
 	UPROPERTY()
 	bool bInterpolatingScale;
 
-	UPROPERTY()
-	FVector CachedAdditiveScale;
-
 	UPROPERTY()
 	bool bInterpolatingRotation;
 
@@ -285,10 +445,6 @@ protected:
 	UPROPERTY()
 	FTimerHandle RotationSyncTimerHandle;
 
-	//Data used to smooth height interpolation, by comparing with previous frames.
-	UPROPERTY()
-	TArray<float> PreviousInterpZValues;
-
 	//------------------------------------------------------------------------------
 	//	Attachment
 	//------------------------------------------------------------------------------
@@ -337,9 +493,25 @@ public:
 	/** Undoes anything done in InitializeTarget().*/
 	virtual void UninitializeTarget();
 
+	/**
+	*	Nearest valid target in front of the actor, within the given distance and half angle. Meant for homing actors to call from InitializeTarget().
+	*	Goes through the target acquisition service, the filter and the already targeted check only run for the candidates that could be the nearest.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Targeting")
+	AActor* FindHomingTarget(float MaxDistance, float HalfAngle = 180.f);
+
 	/** Apply Area of Effect periodically.*/
 	virtual void OnAreaOfEffectPeriod();
 
+	/** Applies one period to the overlapping actors and executes its cues.*/
+	void ApplyAreaOfEffectPeriod(const TArray<AActor*>& OverlappingActors);
+
+	/** Delay of the first period, moved by up to PeriodStaggerFrames. Call once MaximumPeriodsToExecute is set.*/
+	float StaggerFirstPeriodDelay();
+
+	/** Frees the phase reserved by StaggerFirstPeriodDelay, so series that end early don't crowd it until their planned end.*/
+	void ReleasePeriodStagger();
+
 	UFUNCTION()
 	virtual void OnBeginOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
 
@@ -366,26 +538,36 @@ public:
 	FGameplayEffectContainerSpec& GetEffectContainerSpec();
 
 	void SetEffectContainerSpec(const FGameplayEffectContainerSpec& NewSpec);	
-	
-	UPROPERTY()
-	FGameplayEffectContainerSpec EffectContainerSpec;
 
 protected:
 
 	UPROPERTY()
 	FTimerHandle AreaPeriodTimerHandle;
 
-	UPROPERTY()
-	int32 MaximumPeriodsToExecute;
+	/** Whether or not this activation tracks overlaps incrementally instead of through overlap events.*/
+	bool ShouldTrackOverlapsIncrementally() const;
 
-	UPROPERTY()
-	int32 ExecutedPeriods;
+	/** Disables overlap events on the shape and reports the actors already overlapping as begin overlaps.*/
+	void BeginIncrementalOverlapTracking();
 
-	UPROPERTY()
-	bool bDiscreteCollisionChecks;
+	/** Queries the overlapping set and runs the begin and end overlap logic for the delta with the previous one.*/
+	void UpdateIncrementalOverlaps();
 
-	UPROPERTY()
-	bool bAppliesPersistentEffects;
+	/** Reports the tracked actors as end overlaps, like disabling collision does with overlap events, and restores overlap events on the shape.*/
+	void EndIncrementalOverlapTracking();
+
+	struct FTrackedOverlap
+	{
+		TWeakObjectPtr<UPrimitiveComponent> Component;
+		TWeakObjectPtr<AActor> Actor;
+	};
+
+	/** Overlapping components found by the last incremental update.*/
+	TMap<TObjectKey<UPrimitiveComponent>, FTrackedOverlap> TrackedOverlaps;
+
+	bool bTrackingOverlapsIncrementally = false;
+
+	float IncrementalOverlapElapsedTime = 0.f;
 
 	//-----------------------------------------------
 	// Targeting
@@ -461,30 +643,14 @@ protected:
 	virtual void ClearPreviousTargets();
 	virtual void AddPreviousInteractableTarget(AActor* TargetToAdd);
 
+	/** Time used to record hits and check retargeting. It's the scheduled time of the current period, so timer delays don't shorten the retarget window.*/
+	virtual float GetRetargetTime() const;
+
 private:
 
 	UPROPERTY()
 	FTimerHandle ClearTargetsTimerHandle;
 
-	UPROPERTY()
-	TArray<TWeakObjectPtr<AActor>> PreviousTargetedActors;
-
-	UPROPERTY()
-	TArray<TWeakObjectPtr<AActor>> PreviousInteractableActors;
-
-	UPROPERTY()
-	bool bRegisteredTargetInstance;	
-	
-	UPROPERTY()
-	bool bSoftRegisteredTargetInstance;
-
-	/**
-	*	Periodic Areas, that apply instant effects, need to be able to reapply those effects to allready targetted actors. Because of this, we want to allow retargeting of local previous targets in this cases.
-	*	When using shared targets, for periodic effects.
-	*/
-	UPROPERTY()
-	bool bAllowRetargetting;
-
 	//-----------------------------------------------
 	// Pooling
 	//-----------------------------------------------
@@ -497,6 +663,44 @@ protected:
 	virtual	void ReuseAfterRecycle_Implementation();
 	virtual void PoolCollisionActor();
 
+	/**
+	*	Stops timelines, timers and latent actions left by the last activation.
+	*	The fast path uses the components cached in PostInitializeComponents, clears only the timer handles the actor owns and skips what the class declares it doesn't use.
+	*/
+	void ClearRecycleState(bool bFastPath);
+
+	/** Clears every timer handle owned by ABaseCollisionActor.*/
+	void ClearOwnedTimers();
+
+	/** Components reset on every recycle, gathered once after the components are initialized.*/
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UTimelineComponent>> RecycleTimelineComponents;
+
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UParticleSystemComponent>> RecycleParticleComponents;
+
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UNiagaraComponent>> RecycleNiagaraComponents;
+
+public:
+
+	/**
+	*	Drops the object references of the last activation: effect specs and their contexts, owner, instigator and previous targets.
+	*	Idle pooled actors then only reference their own components, keeping the graph the garbage collector walks through the pool small.
+	*/
+	void ReleaseReferencesForPool();
+
+	/** Whether or not deactivations take the fast recycle path. Bound to AbilitySystem.CollisionActor.FastRecycle.*/
+	static bool IsFastRecycleEnabled();
+
+	/** Runs the generic and the fast recycle cleanup on an instance of the class and logs recycles per second. Bound to AbilitySystem.CollisionActor.BenchmarkRecycle.*/
+	static void BenchmarkRecycle(const TArray<FString>& Args, UWorld* World);
+
+	/** Instances the collision actor pool keeps for this class at least.*/
+	int32 GetNumPreallocatedInstances() const { return NumPreallocatedInstances; }
+
+protected:
+
 	/** How many instances of this actor to preallocate.*/
 	UPROPERTY(EditDefaultsOnly, Category = "Pooling")
 	int32 NumPreallocatedInstances;
@@ -504,6 +708,108 @@ protected:
 	UPROPERTY()
 	bool bInRecycleQueue;
 
+	/** Removes the entries of this activation from the instigator ability system component.*/
+	void ReleaseInstigatorData();
+
+	//-----------------------------------------------
+	// Actorless Instances
+	//-----------------------------------------------
+
+public:
+
+	/**
+	*	Instant and periodic areas of this class may run as actorless AoE instances on the server, see UAoEInstanceSubsystem.
+	*	Only for classes that don't attach, interpolate, track overlaps incrementally or get predicted on the owning client. Their cues reach clients through the instigator.
+	*/
+	UPROPERTY(EditDefaultsOnly, Category = "Collision Actor|Performance")
+	bool bAllowActorlessInstances = false;
+
+	/** Whether or not an activation of this class with these effects can run as an actorless instance. Called on the class default object.*/
+	bool CanRunActorless(const FGameplayEffectContainerSpec& InEffectContainerSpec) const;
+
+protected:
+
+	friend class UAoEInstanceSubsystem;
+
+	/** Moves the instance into this executor: transform, owner, instigator and activation state.*/
+	void BindAoEInstance(FAoEInstance& Instance);
+
+	/** Moves the activation state back into the instance.*/
+	void UnbindAoEInstance(FAoEInstance& Instance);
+
+	/** Exchanges the activation state of this actor with the one of the instance.*/
+	void SwapAoEInstanceState(FAoEInstance& Instance);
+
+	/** Actorless lifecycle steps, run with the instance bound. BeginAoEInstance returns the seconds until FinishActivateAoEInstance.*/
+	float BeginAoEInstance();
+	void FinishActivateAoEInstance();
+	void ExecuteAoEInstancePeriod();
+	void DeactivateAoEInstance();
+	void ReleaseAoEInstance();
+
+	/** Actors overlapping the shape at its current transform. Executors never enable collision, the shape is queried directly.*/
+	void GetAoEInstanceOverlaps(TArray<AActor*>& OutActors) const;
+
+	/** Set on the executors of actorless instances. They are never relevant for replication.*/
+	bool bActorlessExecutor = false;
+
+	//-----------------------------------------------
+	// Volleys
+	//-----------------------------------------------
+
+public:
+
+	/**
+	*	Spawns one instance of the class per transform for one activation and preactivates them together. Server only, the shared data must already be in the ASC.
+	*	Instances are acquired from the pool in one go, registered for shared targeting with a single call and replicated as one volley item instead of one individual data item each.
+	*	Returns the volley ID, or INDEX_NONE if nothing could be spawned.
+	*/
+	static int32 SpawnVolley(UBaseAbilitySystemComponent* InASC, TSubclassOf<ABaseCollisionActor> Class, const FCollisionActorIndividualData& InIndividualData, TArrayView<const FTransform> Transforms, TArrayView<const int32> SpawnIndices, AActor* InOwner, APawn* InInstigator, const FGameplayEffectContainerSpec& InEffectContainerSpec, TArray<ABaseCollisionActor*>& OutActors);
+
+	/**
+	*	Preactivates the instances of a volley that weren't yet, registering them for shared targeting at once.
+	*	Clients call it every time the volley replicates, see FCollisionActorVolleyArray::OnVolleyReplicated, so instances whose actor resolves late are preactivated when it does.
+	*/
+	static void PreActivateVolley(UBaseAbilitySystemComponent* InASC, FCollisionActorVolleyItem& Volley);
+
+protected:
+
+	/** Volley this actor was spawned by, INDEX_NONE for individually spawned actors.*/
+	int32 VolleyID = INDEX_NONE;
+
+	/** The volley already registered this instance for shared targeting.*/
+	bool bSharedTargetingRegisteredByVolley = false;
+
+	//-----------------------------------------------
+	// Lifecycle Timers
+	//-----------------------------------------------
+
+protected:
+
+	friend class UCollisionActorSchedulerSubsystem;
+
+	/**
+	*	Runs the lifecycle step after the delay, on UCollisionActorSchedulerSubsystem or on the timer manager when the scheduler is disabled. Non positive delays run on the next tick.
+	*	Period repeats the step every Period seconds. Subclasses should use these instead of the lifecycle timer handles, which are only set while the scheduler is disabled.
+	*/
+	void SetLifecycleTimer(ECollisionActorScheduleEvent Event, float Delay, float Period = 0.f);
+	void ClearLifecycleTimer(ECollisionActorScheduleEvent Event);
+	bool IsLifecycleTimerActive(ECollisionActorScheduleEvent Event);
+
+	/** Calls the function of the lifecycle step. Bound to the scheduler and to the timer manager.*/
+	void OnScheduledEvent(ECollisionActorScheduleEvent Event);
+
+	/** Timer manager handle of the lifecycle step.*/
+	FTimerHandle& GetLifecycleTimerHandle(ECollisionActorScheduleEvent Event);
+
+	UCollisionActorSchedulerSubsystem* GetLifecycleScheduler() const;
+
+	/** Schedule of this actor in the scheduler, allocated with the first lifecycle timer and kept while pooled.*/
+	int32 LifecycleScheduleIndex = INDEX_NONE;
+
+	UPROPERTY()
+	FTimerHandle PoolTimerHandle;
+
 	//-----------------------------------------------
 	// Gameplay Cue
 	//-----------------------------------------------
@@ -514,6 +820,9 @@ protected:
 	UFUNCTION(BlueprintCallable, Category = "Gameplay Cue")
 	virtual void HandleGameplayCueEvent(FGameplayTag CueTag, EGameplayCueEvent::Type EventType);
 
+	/** Handles a cue locally, or sends it to clients through the instigator ability system component for actorless instances.*/
+	void DispatchGameplayCue(AActor* Target, FGameplayTag CueTag, EGameplayCueEvent::Type EventType, const FGameplayCueParameters& Params);
+
 	UGameplayCueManager* GetGameplayCueManager();
 	virtual void GetDefaultGameplayCueParams(FGameplayCueParameters& Params);	
 	virtual void GetPreviewGameplayCueParams(FGameplayCueParameters& Params) const;
@@ -528,23 +837,28 @@ protected:
 	virtual void RemoveGameplayCues();	
 	virtual void ResetParticleSystems() const;
 
-	UPROPERTY()
-	UGameplayCueManager* GameplayCueManager;
+	/** Preview cue values that only depend on the ability, its level and its tags. Pooled actors reuse them across activations.*/
+	struct FPreviewCueCache
+	{
+		TSubclassOf<UGameplayAbility> AbilityClass;
+		int32 Level = INDEX_NONE;
+		FSharedGameplayTagContainer AbilityTags;
+		float InnerRadius = 0.f;
+		float HalfAngle = 0.f;
+		FVector ScaledLocalExtent = FVector::ZeroVector;
+		bool bValid = false;
+	};
 
-	UPROPERTY()
-	bool bActorGameplayCueInitialized;
+	/** Returns the preview cue values for the current shared data, rebuilding them if needed.*/
+	const FPreviewCueCache& GetPreviewCueCache() const;
 
-	UPROPERTY()
-	bool bPreviewGameplayCueInitialized;
+	mutable FPreviewCueCache PreviewCueCache;
 
-	UPROPERTY()
-	bool bPreactivationGameplayCueInitialized;
+	/** Shape local bounds. The shape doesn't change between activations, so they are only calculated once.*/
+	mutable TOptional<FBoxSphereBounds> CachedShapeLocalBounds;
 
 	UPROPERTY()
-	bool bExecuteDeactivationCue;
-	
-	UPROPERTY()
-	bool bSkipGameplayCues;
+	UGameplayCueManager* GameplayCueManager;
 
 	//-----------------------------------------------
 	// Components
@@ -569,14 +883,6 @@ protected:
 	void SetSourceAbilitySystemComponent();
 	void SendGameplayEvent(UAbilitySystemComponent* InASC, FGameplayTag EventTag, const FGameplayEventData& Payload);
 
-private:
-
-	UPROPERTY()
-	UAbilitySystemComponent* InstigatorASC = nullptr;
-
-	UPROPERTY()
-	UBaseAbilitySystemComponent* InstigatorBaseASC = nullptr;
-
 	//-----------------------------------------------
 	// Prediction. WIP, simple logic test.
 	//-----------------------------------------------
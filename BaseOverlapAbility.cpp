@@ -10,10 +10,71 @@
 #include "AbilitySystemGlobals.h"
 #include "AbilitySystem/BPL_AbilitySystem.h"
 #include "AbilitySystem/Targeting/TargetTypes.h"
+#include "AbilitySystem/Abilities/OverlapEventSubsystem.h"
+#include "AbilitySystem/Abilities/OverlapEventKernels.h"
+#include "AbilitySystem/Targeting/TargetHitHistory.h"
+#include "AbilitySystem/AttributeScalingCache.h"
+#include "AbilitySystem/PeriodicStaggerSubsystem.h"
+#include "AbilitySystem/AbilityBehaviorFlags.h"
+#include "AbilitySystem/SharedGameplayTagContainer.h"
+#include "AbilitySystem/Abilities/OverlapVisualizationDescriptor.h"
+#include "AbilitySystem/AbilityAssetManifest.h"
+#include "AbilitySystem/Targeting/TargetAcquisitionSubsystem.h"
 
 int32 ShowOverlapDebug = 0;
 static FAutoConsoleVariableRef CVarEnableOverlapDebug(TEXT("AbilitySystem.ShowOverlapDebug"), ShowOverlapDebug, TEXT("Draw debug lines to show the overlap events. Values are 0 or 1."), ECVF_Default);
 
+float OverlapInterpStepTolerance = 10.f;
+static FAutoConsoleVariableRef CVarOverlapInterpStepTolerance(TEXT("AbilitySystem.OverlapInterpSteps.Tolerance"), OverlapInterpStepTolerance, TEXT("Maximum extent error, in unreal units, allowed between two interpolation steps of a scaling overlap. Values of 0 or less use evenly spaced steps."), ECVF_Default);
+
+float OverlapInterpStepMinInterval = .15f;
+static FAutoConsoleVariableRef CVarOverlapInterpStepMinInterval(TEXT("AbilitySystem.OverlapInterpSteps.MinInterval"), OverlapInterpStepMinInterval, TEXT("Minimum time between two interpolation steps of a scaling overlap, in seconds. Steps are never placed closer than the evenly spaced ones, every .15 seconds."), ECVF_Default);
+
+/** Values the interpolation steps of an overlap ability are baked from. Instances with the same values share the baked steps.*/
+struct FOverlapInterpStepsKey
+{
+	/** Object keys include the serial number, so a curve allocated where a destroyed one was doesn't share its entry.*/
+	TObjectKey<UCurveVector> ScaleCurve;
+	FVector ShapeExtent = FVector::ZeroVector;
+	float ScaleCurveMultiplier = 0.f;
+	float LifeSpan = 0.f;
+	float Tolerance = 0.f;
+	float MinInterval = 0.f;
+
+	bool operator==(const FOverlapInterpStepsKey& Other) const
+	{
+		return ScaleCurve == Other.ScaleCurve && ShapeExtent == Other.ShapeExtent && ScaleCurveMultiplier == Other.ScaleCurveMultiplier
+			&& LifeSpan == Other.LifeSpan && Tolerance == Other.Tolerance && MinInterval == Other.MinInterval;
+	}
+
+	friend uint32 GetTypeHash(const FOverlapInterpStepsKey& Key)
+	{
+		uint32 Hash = HashCombine(GetTypeHash(Key.ScaleCurve), GetTypeHash(Key.ShapeExtent));
+		Hash = HashCombine(Hash, GetTypeHash(Key.ScaleCurveMultiplier));
+		Hash = HashCombine(Hash, GetTypeHash(Key.LifeSpan));
+		Hash = HashCombine(Hash, GetTypeHash(Key.Tolerance));
+		return HashCombine(Hash, GetTypeHash(Key.MinInterval));
+	}
+};
+
+/** Sorted normalized times of the interpolation steps, always starting at 0 and ending at 1. Flushed when a world is cleaned up, so it doesn't grow across maps.*/
+static TMap<FOverlapInterpStepsKey, TArray<float>> BakedOverlapInterpSteps;
+
+static void BindBakedOverlapInterpStepsFlush()
+{
+	static bool bBound = false;
+	if (bBound)
+	{
+		return;
+	}
+	bBound = true;
+
+	FWorldDelegates::OnWorldCleanup.AddLambda([](UWorld* World, bool bSessionEnded, bool bCleanupResources)
+	{
+		BakedOverlapInterpSteps.Empty();
+	});
+}
+
 UBaseOverlapAbility::UBaseOverlapAbility() : Super()
 {
 	bRetriggerInstancedAbility = true;
@@ -30,6 +91,22 @@ void UBaseOverlapAbility::ActivateAbility(const FGameplayAbilitySpecHandle Handl
 	}
 }
 
+void UBaseOverlapAbility::OnGiveAbility(const FGameplayAbilityActorInfo* ActorInfo, const FGameplayAbilitySpec& Spec)
+{
+	Super::OnGiveAbility(ActorInfo, Spec);
+	RefreshAbilityTagData();
+
+	//Request the visualization and cue assets now so the first aim doesn't load them synchronously
+	UAbilityAssetManifest::Get().PreloadAbilityAssets(this);
+}
+
+void UBaseOverlapAbility::GetAssetManifestEntry(FAbilityAssetManifestEntry& OutEntry) const
+{
+	OutEntry.AbilityClass = GetClass();
+	OutEntry.Shape = Shape;
+	OutEntry.GameplayCueTag = GameplayCueTag;
+}
+
 bool UBaseOverlapAbility::CanActivateAbility(const FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo* ActorInfo, const FGameplayTagContainer* SourceTags, const FGameplayTagContainer* TargetTags, OUT FGameplayTagContainer* OptionalRelevantTags) const
 {
 	const bool CanActivate = Super::CanActivateAbility(Handle, ActorInfo, SourceTags, TargetTags, OptionalRelevantTags);
@@ -102,7 +179,7 @@ FGameplayAbilityTargetDataHandle UBaseOverlapAbility::GetMoveToTargetData(const
 float UBaseOverlapAbility::GetAnimMontageLengthExtension() const
 {
 	const float InternalSpawnDelay = GetSpawnDelay(GetAbilityLevel());
-	if (!AbilityTags.HasTag(UGlobalTags::Ability_SpawnBatch()))
+	if (!HasAbilityBehaviorFlag(EAbilityBehaviorFlags::SpawnBatch))
 	{
 		if (InternalSpawnDelay > 0.f)
 		{
@@ -128,36 +205,59 @@ void UBaseOverlapAbility::GetTargetContext(const FTargetInformation& TargetInfo,
 
 void UBaseOverlapAbility::GetVisualizationParams_Implementation(TMap<FString, float>& Params) const
 {
+	Params.Append(GetVisualizationDescriptor().Params);
+}
+
+const FOverlapVisualizationDescriptor& UBaseOverlapAbility::GetVisualizationDescriptor() const
+{
+	const UAbilitySystemComponent* ASC = GetAbilitySystemComponentFromActorInfo();
+	const int32 Level = GetAbilityLevel();
+	const uint32 AttributeEpoch = FAttributeScalingCache::GetEpoch(ASC);
+	const FSharedGameplayTagContainer CurrentAbilityTags = GetSharedAbilityTags();
+
+	//Without the attribute cache there is no epoch to tell when attributes change.
+	if (FAttributeScalingCache::IsEnabled() && VisualizationCache.Matches(Level, AttributeEpoch, CurrentAbilityTags))
+	{
+		return VisualizationCache.Descriptor;
+	}
+
+	FOverlapVisualizationDescriptor& Descriptor = VisualizationCache.Descriptor;
 	const FVector InitialExtent = GetAreaBoundsByLifeTime(0, true);
 	const FVector FinalExtent = GetAreaBoundsByLifeTime(1, true);
 	const FVector Extent = InitialExtent.Size() > FinalExtent.Size() ? InitialExtent : FinalExtent;
-	Params.Add("OuterRadius", Extent.X);
-	Params.Add("InnerRadius", GetMinimumTargetDistanceToCenterRequired(1));
-	Params.Add("HalfAngle", GetMaximumAngleDeviationBetweenTargetAndOverlap(1));
-	Params.Add("Width", Extent.X);
-	Params.Add("Length", Extent.Y);		
-	Params.Add("TargetAmount", GetOverlapAmount(GetAbilityLevel()));
+	Descriptor.OuterRadius = Extent.X;
+	Descriptor.InnerRadius = GetMinimumTargetDistanceToCenterRequired(1);
+	Descriptor.HalfAngle = GetMaximumAngleDeviationBetweenTargetAndOverlap(1);
+	Descriptor.Width = Extent.X;
+	Descriptor.Length = Extent.Y;
+	Descriptor.TargetAmount = GetOverlapAmount(Level);
+
+	Descriptor.Params.Reset();
+	Descriptor.Params.Add("OuterRadius", Descriptor.OuterRadius);
+	Descriptor.Params.Add("InnerRadius", Descriptor.InnerRadius);
+	Descriptor.Params.Add("HalfAngle", Descriptor.HalfAngle);
+	Descriptor.Params.Add("Width", Descriptor.Width);
+	Descriptor.Params.Add("Length", Descriptor.Length);
+	Descriptor.Params.Add("TargetAmount", Descriptor.TargetAmount);
+	Descriptor.Params.Add("Shape", static_cast<float>(Shape));
 
 	if (GetTargetDistribution())
 	{
-		GetTargetDistribution().GetDefaultObject()->GetVisualizationParams(Params);
+		GetTargetDistribution().GetDefaultObject()->GetVisualizationParams(Descriptor.Params);
 	}
+
+	//Evaluating the attributes may have created the ASC cache, read the epoch again.
+	VisualizationCache.bValid = true;
+	VisualizationCache.Level = Level;
+	VisualizationCache.AttributeEpoch = FAttributeScalingCache::GetEpoch(ASC);
+	VisualizationCache.AbilityTags = CurrentAbilityTags;
+	return Descriptor;
 }
 
 FTargetVisualization UBaseOverlapAbility::GetVisualRepresentation_Implementation() const
 {	
 	FTargetVisualization Visualization = FTargetVisualization();
-	switch (Shape)
-	{
-	case EOverlapAbilityShape::Sphere:
-		Visualization.DecalMaterial = LoadObject<UMaterialInterface>(nullptr, TEXT("/Game/Materials/Decals/M_Decal_Circle_Gradient.M_Decal_Circle_Gradient"));
-		break;
-	case EOverlapAbilityShape::Box:
-		Visualization.DecalMaterial = LoadObject<UMaterialInterface>(nullptr, TEXT("/Game/Materials/Decals/M_Decal_Square_Gradient.M_Decal_Square_Gradient"));
-		break;
-	default:
-		break;
-	}
+	Visualization.DecalMaterial = UAbilityAssetManifest::Get().GetDecalMaterial(Shape);
 
 	ensureMsgf(Visualization.DecalMaterial, TEXT("UBaseOverlapAbility::GetVisualRepresentation_Implementation: Could not find decal material for visualization"));
 	Visualization.DecalLocation = EVisualizationPlacementLocation::Source;
@@ -186,7 +286,7 @@ FVector UBaseOverlapAbility::GetAreaBoundsByLifeTime(float NormalizedLifeTime,
 
 	if (bScaleWithAttributes)
 	{
-		const float InternalAreaMultiplier = bScaleWithAttributes ? ScaleValueWithAttribute(1.f, UAbilityAttributeSet::GetAreaOfEffectAttribute()) : 1.f;
+		const float InternalAreaMultiplier = bScaleWithAttributes ? ScaleValueWithAttributeCached(1.f, UAbilityAttributeSet::GetAreaOfEffectAttribute()) : 1.f;
 		OutExtent *= InternalAreaMultiplier;
 	}
 
@@ -218,17 +318,73 @@ FVector UBaseOverlapAbility::GetScaleByTime(float NormalizedTime) const
 
 int32 UBaseOverlapAbility::GetInterpSteps() const
 {
-	return FMath::Max(5, Duration.LifeSpan/.15);
+	return GetInterpStepTimes().Num() - 1;
+}
+
+const TArray<float>& UBaseOverlapAbility::GetInterpStepTimes() const
+{
+	FOverlapInterpStepsKey Key;
+	Key.ScaleCurve = ScaleInterpolation.ScaleCurve;
+	Key.ScaleCurveMultiplier = ScaleInterpolation.ScaleCurveMultiplier;
+	Key.ShapeExtent = ShapeExtent;
+	Key.LifeSpan = Duration.LifeSpan;
+	Key.Tolerance = OverlapInterpStepTolerance;
+	Key.MinInterval = OverlapInterpStepMinInterval;
+
+	//Keyed by the inputs rather than the class, instances with modified extents or lifespans don't bake over each other.
+	BindBakedOverlapInterpStepsFlush();
+	TArray<float>& Times = BakedOverlapInterpSteps.FindOrAdd(Key);
+	if (Times.IsEmpty())
+	{
+		BakeInterpStepTimes(Times);
+	}
+
+	return Times;
+}
+
+void UBaseOverlapAbility::BakeInterpStepTimes(TArray<float>& OutTimes) const
+{
+	OutTimes.Reset();
+
+	//Evenly spaced steps, used when there is no curve to follow or the tolerance is disabled.
+	const int32 Steps = FMath::Max(5, Duration.LifeSpan / .15);
+	if (!HasScaleInterp() || OverlapInterpStepTolerance <= 0.f)
+	{
+		for (int32 i = 0; i <= Steps; i++)
+		{
+			OutTimes.Add(float(i) / Steps);
+		}
+		return;
+	}
+
+	//Sample the curve at the finest resolution allowed and place a step each time the extent drifts further than the tolerance from the last step.
+	//Flat sections of the curve get no steps, fast expansions get one every sample. There are never more samples than evenly spaced steps.
+	const int32 NumSamples = FMath::Clamp(FMath::CeilToInt32(Duration.LifeSpan / FMath::Max(OverlapInterpStepMinInterval, KINDA_SMALL_NUMBER)), 5, Steps);
+	auto GetSampleExtent = [this, NumSamples](int32 Sample)
+	{
+		return GetAreaBoundsByLifeTime(float(Sample) / NumSamples, false);
+	};
+
+	OutTimes.Add(0.f);
+	FVector StepExtent = GetSampleExtent(0);
+	for (int32 Sample = 1; Sample < NumSamples; Sample++)
+	{
+		const FVector SampleExtent = GetSampleExtent(Sample);
+		if ((SampleExtent - StepExtent).GetAbsMax() > OverlapInterpStepTolerance)
+		{
+			OutTimes.Add(float(Sample) / NumSamples);
+			StepExtent = SampleExtent;
+		}
+	}
+	OutTimes.Add(1.f);
 }
 
 void UBaseOverlapAbility::ExpandOverlapEvent(FOverlapEventSnapshot& Event, TArray<FOverlapEventSnapshot>& ExpandedEvent) const
 {
 	const float InternalActivationTime = Event.ActivationTime;
-	const int32 Steps = GetInterpSteps();
-	const float StepLength = Duration.LifeSpan / Steps;
-	for (int32 i = 0; i <= Steps; i++)
+	for (const float StepTime : GetInterpStepTimes())
 	{
-		Event.ActivationTime = InternalActivationTime + i * StepLength;
+		Event.ActivationTime = InternalActivationTime + StepTime * Duration.LifeSpan;
 		ExpandedEvent.Add(Event);
 	}
 }
@@ -265,6 +421,23 @@ void UBaseOverlapAbility::GeneratePeriodicOverlapEvents(const FGameplayEventData
 		GeneratedEvents.Append(InitialEvents);
 		AddedTime += Attributes.Period;
 	}
+
+	//Spread series of the same period over nearby frames. Every period moves by the same offset, none is added or lost and the last one stays within the lifespan.
+	UPeriodicStaggerSubsystem* StaggerSubsystem = PeriodStaggerFrames > 0 && GetWorld() && UPeriodicStaggerSubsystem::IsEnabled() ? GetWorld()->GetSubsystem<UPeriodicStaggerSubsystem>() : nullptr;
+	if (StaggerSubsystem && !GeneratedEvents.IsEmpty())
+	{
+		const float Tolerance = PeriodStaggerFrames * UPeriodicStaggerSubsystem::GetFrameTime();
+		const float MinOffset = -FMath::Min(Attributes.FirstPeriodDelay, Tolerance);
+		const float MaxOffset = FMath::Clamp(Attributes.LifeSpan - AddedTime, 0.f, Tolerance);
+		const float Offset = StaggerSubsystem->StaggerPeriodicSeries(GeneratedEvents[0].ActivationTime, Attributes.Period, MinOffset, MaxOffset, GeneratedEvents.Last().ActivationTime + MaxOffset);
+		if (Offset != 0.f)
+		{
+			for (auto& it : GeneratedEvents)
+			{
+				it.ActivationTime += Offset;
+			}
+		}
+	}
 }
 
 int32 UBaseOverlapAbility::GetBaseOverlapAmount_Implementation(int32 AbilityLevel) const
@@ -274,12 +447,12 @@ int32 UBaseOverlapAbility::GetBaseOverlapAmount_Implementation(int32 AbilityLeve
 
 int32 UBaseOverlapAbility::GetOverlapAmount(int32 AbilityLevel) const
 {
-	if (AbilityTags.HasTag(UGlobalTags::Ability_DisableMultipleSpawn()))
+	if (HasAbilityBehaviorFlag(EAbilityBehaviorFlags::DisableMultipleSpawn))
 	{
 		return 1;
 	}
 
-	return ScaleValueWithAttribute(GetBaseOverlapAmount(AbilityLevel), UAbilityAttributeSet::GetTargetAmountAttribute());
+	return ScaleValueWithAttributeCached(GetBaseOverlapAmount(AbilityLevel), UAbilityAttributeSet::GetTargetAmountAttribute());
 }
 
 float UBaseOverlapAbility::GetBaseSpawnDelay_Implementation(int32 AbilityLevel) const
@@ -289,7 +462,7 @@ float UBaseOverlapAbility::GetBaseSpawnDelay_Implementation(int32 AbilityLevel)
 
 float UBaseOverlapAbility::GetSpawnDelay(int32 AbilityLevel) const
 {
-	return ScaleValueWithAttribute(GetBaseSpawnDelay(AbilityLevel), UAbilityAttributeSet::GetSpawnDelayAttribute());
+	return ScaleValueWithAttributeCached(GetBaseSpawnDelay(AbilityLevel), UAbilityAttributeSet::GetSpawnDelayAttribute());
 }
 
 float UBaseOverlapAbility::GetBaseMinAngleSpan_Implementation(int32 AbilityLevel) const
@@ -304,22 +477,22 @@ float UBaseOverlapAbility::GetBaseMaxAngleSpan_Implementation(int32 AbilityLevel
 
 float UBaseOverlapAbility::GetMinAngleSpan(int32 AbilityLevel) const
 {
-	if (AbilityTags.HasTag(UGlobalTags::Ability_DisableAngleSpanModifiers()))
+	if (HasAbilityBehaviorFlag(EAbilityBehaviorFlags::DisableAngleSpanModifiers))
 	{
 		return GetBaseMinAngleSpan(AbilityLevel);
 	}
 
-	return ScaleValueWithAttribute(GetBaseMinAngleSpan(AbilityLevel), UAbilityAttributeSet::GetMinimumTargetAngleSpanAttribute());
+	return ScaleValueWithAttributeCached(GetBaseMinAngleSpan(AbilityLevel), UAbilityAttributeSet::GetMinimumTargetAngleSpanAttribute());
 }
 
 float UBaseOverlapAbility::GetMaxAngleSpan(int32 AbilityLevel) const
 {
-	if (AbilityTags.HasTag(UGlobalTags::Ability_DisableAngleSpanModifiers()))
+	if (HasAbilityBehaviorFlag(EAbilityBehaviorFlags::DisableAngleSpanModifiers))
 	{
 		return GetBaseMaxAngleSpan(AbilityLevel);
 	}
 	
-	return ScaleValueWithAttribute(GetBaseMaxAngleSpan(AbilityLevel), UAbilityAttributeSet::GetMaximumTargetAngleSpanAttribute());
+	return ScaleValueWithAttributeCached(GetBaseMaxAngleSpan(AbilityLevel), UAbilityAttributeSet::GetMaximumTargetAngleSpanAttribute());
 }
 
 float UBaseOverlapAbility::GetBaseMinimumTargetDistanceToCenterRequired(float InLifetime) const
@@ -337,7 +510,7 @@ float UBaseOverlapAbility::GetBaseMinimumTargetDistanceToCenterRequired(float In
 float UBaseOverlapAbility::GetMinimumTargetDistanceToCenterRequired(float InLifetime) const
 {
 	const float MinDist = GetBaseMinimumTargetDistanceToCenterRequired(InLifetime);
-	return ScaleValueWithAttribute(MinDist, UAbilityAttributeSet::GetAreaOfEffectAttribute());	
+	return ScaleValueWithAttributeCached(MinDist, UAbilityAttributeSet::GetAreaOfEffectAttribute());	
 }
 
 float UBaseOverlapAbility::GetBaseMaximumAngleDeviationBetweenTargetAndOverlap(float InLifetime) const
@@ -357,7 +530,7 @@ float UBaseOverlapAbility::GetMaximumAngleDeviationBetweenTargetAndOverlap(float
 	float Deviation = GetBaseMaximumAngleDeviationBetweenTargetAndOverlap(InLifetime);
 	if (bScaleMaximumDirectionDeviationWithAreaAttributeModifiers)
 	{
-		Deviation = ScaleValueWithAttribute(Deviation, UAbilityAttributeSet::GetAreaOfEffectAttribute());
+		Deviation = ScaleValueWithAttributeCached(Deviation, UAbilityAttributeSet::GetAreaOfEffectAttribute());
 	}
 	return FMath::Clamp(Deviation, 0.f, 180.f);
 }
@@ -369,75 +542,91 @@ void UBaseOverlapAbility::OnQueueEmptied_Implementation()
 
 void UBaseOverlapAbility::OnOverlapEvent_Implementation(const FOverlapEventSnapshot& OverlapEventData)
 {
-	const FOverlapEventID ID = FOverlapEventID(OverlapEventData.EventID, OverlapEventData.OverlapID);
-	const bool bPeriodic = Duration.Period > 0.f;
-	if (bPeriodic)
-	{
-		RemoveTargets(OverlapEventData.EventID, /*OverlapEventData.OverlapID**/-1); //clear all targets from previous overlaps. This is needed for cases like miasma. If this requires to filter by overlapID, we can put an option for this so we can choose per ability.
+	FOverlapEventEvaluation Evaluation;
+	PrepareOverlapEvaluation(OverlapEventData, Evaluation);
+	EvaluateOverlapEvent(OverlapEventData, Evaluation);
+	ApplyOverlapEvaluation(OverlapEventData, Evaluation);
+}
 
-		if (bExecuteGameplayCueOnEveryPeriod)
-		{
-			ExecutedGameplayCues.Remove(ID);
-		}
+void UBaseOverlapAbility::PrepareOverlapEvaluation(const FOverlapEventSnapshot& OverlapEventData, FOverlapEventEvaluation& Evaluation) const
+{
+	//Snapshots created by ProcessOverlapEvent index into the event geometry table. Anything else is evaluated here.
+	FOverlapEventGeometryStep LocalStep;
+	const FOverlapEventGeometryStep* Step = FindOverlapEventGeometryStep(OverlapEventData);
+	if (!Step)
+	{
+		const float ElapsedTime = OverlapEventData.ActivationTime - OverlapEventData.InitialEventTime;
+		BuildOverlapEventGeometryStep(ElapsedTime, OverlapEventData.DurationMultiplier, OverlapEventData.AreaMultiplier, LocalStep);
+		Step = &LocalStep;
 	}
 
-	const TArray<AActor*, FDefaultAllocator> IgnoreActors = GetIgnoredActors(OverlapEventData.EventID, AbilityTags.HasTag(UGlobalTags::Ability_Targeting_IndividualTargeting()) ? OverlapEventData.OverlapID : -1);
-	TArray<AActor*, FDefaultAllocator> FilteredActors;
-	const TArray<TEnumAsByte<EObjectTypeQuery>> Query{ EObjectTypeQuery::ObjectTypeQuery3 };
-	
-	const float ElapsedTime = OverlapEventData.ActivationTime - OverlapEventData.InitialEventTime;
-	const float NormalizedElapsedTime = Duration.LifeSpan != 0 ? ElapsedTime / (Duration.LifeSpan * OverlapEventData.DurationMultiplier) : 1.f;
-	FVector CurrentExtent = GetAreaBoundsByLifeTime(NormalizedElapsedTime, false);
-	CurrentExtent *= OverlapEventData.AreaMultiplier;
-	
-	FRotator CurrentRotator = FRotator(0, OverlapEventData.YawRotation + RotationRate * ElapsedTime, 0);
-	CurrentRotator.Normalize();	
-	float CurrentYaw = CurrentRotator.Yaw;
+	Evaluation.Extent = Step->Extent;
+
+	FRotator CurrentRotator = FRotator(0, OverlapEventData.YawRotation + Step->YawOffset, 0);
+	CurrentRotator.Normalize();
+	Evaluation.Yaw = CurrentRotator.Yaw;
+
+	Evaluation.MinDistance = Step->InnerRadius;
+	Evaluation.AngleDeviation = Step->HalfAngle;
+	Evaluation.Kernel = Step->Kernel;
+	Evaluation.QueryBounds = OverlapEventKernels::CanMergeQuery(Shape) ? OverlapEventKernels::GetQueryBounds(Shape, OverlapEventData, Evaluation) : FSphere(OverlapEventData.Location, 0.f);
+	Evaluation.SharedCandidates = nullptr;
+	Evaluation.CandidateQuery = OverlapEventKernels::GetCandidateQuery(Shape, OverlapEventData, Evaluation);
+	Evaluation.Filter = GetOverlapFilter();
+	Evaluation.Avatar = GetAvatarActorFromActorInfo();
+	Evaluation.Targets.Reset();
+}
 
-	switch (Shape)
+void UBaseOverlapAbility::EvaluateOverlapEvent(const FOverlapEventSnapshot& OverlapEventData, FOverlapEventEvaluation& Evaluation) const
+{
+	//This can run off the game thread when events are batched. Only read the snapshot and the prepared evaluation here.
+	//The filter, line of sight and ignored actors are checked when the evaluation is applied, on the game thread.
+	const FOverlapEventKernel Kernel = Evaluation.Kernel ? Evaluation.Kernel : OverlapEventKernels::Select(Shape, Evaluation);
+	Kernel(this, OverlapEventData, Evaluation);
+}
+
+void UBaseOverlapAbility::ApplyOverlapEvaluation(const FOverlapEventSnapshot& OverlapEventData, FOverlapEventEvaluation& Evaluation)
+{
+	const FOverlapEventID ID = FOverlapEventID(OverlapEventData.EventID, OverlapEventData.OverlapID);
+	const bool bPeriodic = Duration.Period > 0.f;
+	if (bPeriodic && bExecuteGameplayCueOnEveryPeriod)
 	{
-	case EOverlapAbilityShape::Sphere:
-		UKismetSystemLibrary::SphereOverlapActors(this, OverlapEventData.Location, CurrentExtent.X, Query, APawn::StaticClass(), IgnoreActors, FilteredActors);
-		break;
-	case EOverlapAbilityShape::Box:
-		UBPL_AbilitySystem::RotatedBoxOverlapActors(this, OverlapEventData.Location, FRotator(0.f,CurrentYaw, 0.f), CurrentExtent, Query, APawn::StaticClass(), IgnoreActors, FilteredActors);
-		break;
-	default:
-		break;
+		ExecutedGameplayCues.Remove(ID);
 	}
 
-	FGameplayTargetDataFilterHandle Filter = GetOverlapFilter();
-	FilteredActors.RemoveAll([&Filter](AActor* it)
-	{
-		return !Filter.FilterPassesForActor(it);
-	});
+	TArray<AActor*, FDefaultAllocator>& FilteredActors = Evaluation.Targets;
+	OverlapEventKernels::FilterTargets(this, OverlapEventData, bTargetRequiresLineOfSightToCenterLocation, Evaluation);
 
-	if (bTargetRequiresLineOfSightToCenterLocation)
+	const TArray<AActor*, FDefaultAllocator> IgnoreActors = GetIgnoredActors(OverlapEventData.EventID, HasAbilityBehaviorFlag(EAbilityBehaviorFlags::IndividualTargeting) ? OverlapEventData.OverlapID : -1);
+	if (!IgnoreActors.IsEmpty())
 	{
-		FilteredActors.RemoveAll([this, &OverlapEventData](AActor* it)
+		FilteredActors.RemoveAll([&IgnoreActors](AActor* it)
 		{
-			return !UTargetFunctionLibrary::HasLineOfSightToTarget(this, OverlapEventData.Location, it, this->GetAvatarActorFromActorInfo());
+			return IgnoreActors.Contains(it);
 		});
 	}
 
-	const float MinDistance = GetBaseMinimumTargetDistanceToCenterRequired(NormalizedElapsedTime) * OverlapEventData.AreaMultiplier;
-	if (MinDistance > 0.f)
+	//Periodic overlaps can hit each target once per period and overlap. This is needed for cases like miasma, where overlapping areas stack.
+	FTargetHitHistory* HitHistory = bPeriodic ? &FindOrAddHitHistory(OverlapEventData.EventID) : nullptr;
+	const int32 NumHitsBefore = HitHistory ? HitHistory->GetNumHits() : 0;
+	if (HitHistory)
 	{
-		FilteredActors.RemoveAll([MinDistance, &OverlapEventData](AActor* it)
+		FilteredActors.RemoveAll([HitHistory, &OverlapEventData](AActor* it)
 		{
-			return !UTargetFunctionLibrary::IsTargetInMinimalDistance(OverlapEventData.Location, it, MinDistance);
+			return !HitHistory->IsEligible(it, OverlapEventData.ActivationTime, OverlapEventData.OverlapID);
 		});
-	}
 
-	const float AngleDeviation = GetBaseMaximumAngleDeviationBetweenTargetAndOverlap(NormalizedElapsedTime) * OverlapEventData.AreaMultiplier;
-	if (AngleDeviation < 180.f)
-	{
-		FilteredActors.RemoveAll([AngleDeviation, CurrentYaw, &OverlapEventData](AActor* it)
+		for (AActor* Target : FilteredActors)
 		{
-			return !UTargetFunctionLibrary::IsTargetBetweenAngleDeviation(OverlapEventData.Location, it, CurrentYaw, AngleDeviation);
-		});
+			HitHistory->RecordHit(Target, OverlapEventData.ActivationTime, OverlapEventData.OverlapID);
+		}
 	}
 
+	const FVector CurrentExtent = Evaluation.Extent;
+	const float CurrentYaw = Evaluation.Yaw;
+	const float MinDistance = Evaluation.MinDistance;
+	const float AngleDeviation = Evaluation.AngleDeviation;
+
 	if (!FilteredActors.IsEmpty())
 	{
 		FGameplayEffectContainerSpec Spec = FGameplayEffectContainerSpec();
@@ -466,9 +655,10 @@ void UBaseOverlapAbility::OnOverlapEvent_Implementation(const FOverlapEventSnaps
 		{
 			Payload.Target = Target;
 			
-			if (UAbilitySystemComponent* TargetASC = UAbilitySystemGlobals::GetAbilitySystemComponentFromActor(Target))
+			UAbilitySystemComponent* TargetASC = UAbilitySystemGlobals::GetAbilitySystemComponentFromActor(Target);
+			Payload.TargetTags = TargetASC ? TargetASC->GetOwnedGameplayTags() : FGameplayTagContainer::EmptyContainer;
+			if (TargetASC)
 			{
-				TargetASC->GetOwnedGameplayTags(Payload.TargetTags);
 				FScopedPredictionWindow NewScopedWindow(TargetASC, true);
 				TargetASC->HandleGameplayEvent(UGlobalTags::Event_Hit(), &Payload);
 			}
@@ -477,25 +667,22 @@ void UBaseOverlapAbility::OnOverlapEvent_Implementation(const FOverlapEventSnaps
 		}
 	}
 
-	if (bPeriodic)
+	if (HitHistory)
 	{
-		SendMultihitEvent(OverlapEventData.EventID, FilteredActors.Num());
+		SendMultihitEvent(OverlapEventData.EventID, HitHistory->GetNumHits() - NumHitsBefore);
 	}
 	
 	if (GameplayCueTag.IsValid() && !ExecutedGameplayCues.Contains(ID))
 	{		
 		FGameplayCueParameters Params = FGameplayCueParameters();
-		Params.AggregatedSourceTags = AbilityTags;
-		if ( !GetEventData(ID.EventID).InstigatorTags.IsEmpty())
-		{
-			Params.AggregatedSourceTags.AppendTags(GetEventData(ID.EventID).InstigatorTags);
-		}		
+		Params.AggregatedSourceTags = GetEventSourceTags(ID.EventID).Get();
 		Params.RawMagnitude = OverlapEventData.DurationMultiplier;
 		Params.AbilityLevel = FMath::TruncToInt32(AngleDeviation);
 		Params.GameplayEffectLevel = FMath::TruncToInt32(MinDistance);
 		Params.Location = OverlapEventData.Location;		
 		Params.NormalizedMagnitude = CurrentYaw;
-		Params.Normal = GetAreaBoundsByLifeTime(1, false) * OverlapEventData.AreaMultiplier;
+		const FOverlapEventGeometry* Geometry = EventGeometryMap.Find(OverlapEventData.EventID);
+		Params.Normal = Geometry ? Geometry->FinalExtent : GetAreaBoundsByLifeTime(1, false) * OverlapEventData.AreaMultiplier;
 		Params.Normal.Z = GetWorld()->GetTimeSeconds(); 
 		Params.SourceObject = this;
 		ModifyGameplayCueParams(ID,Params);
@@ -529,7 +716,30 @@ void UBaseOverlapAbility::OnOverlapEvent_Implementation(const FOverlapEventSnaps
 		{
 			UKismetSystemLibrary::DrawDebugBox(this, OverlapEventData.Location, CurrentExtent, FLinearColor::Green, FRotator(0.f,CurrentYaw, 0.f), .5f, 1.f);			
 			break;
-		}			
+		}
+		case EOverlapAbilityShape::Capsule:
+		{
+			const FVector Dir = FRotator(0.f, CurrentYaw, 0.f).Vector();
+			UKismetSystemLibrary::DrawDebugCapsule(this, OverlapEventData.Location, FMath::Max(CurrentExtent.X, CurrentExtent.Y), CurrentExtent.Y, FRotationMatrix::MakeFromZ(Dir).Rotator(), FLinearColor::Green, .5f, 1.f);
+			break;
+		}
+		case EOverlapAbilityShape::Cone:
+		{
+			const FVector Dir = FRotator(0.f, CurrentYaw, 0.f).Vector();
+			const float HalfAngle = FMath::DegreesToRadians(FMath::Min(AngleDeviation, 180.f));
+			UKismetSystemLibrary::DrawDebugCone(this, OverlapEventData.Location, Dir, CurrentExtent.X, HalfAngle, HalfAngle, 12, FLinearColor::Green, .5f, 1.f);
+			break;
+		}
+		case EOverlapAbilityShape::Ring:
+		{
+			DrawDebugSector(OverlapEventData.Location, CurrentYaw, MinDistance, CurrentExtent.X, 180.f);
+			break;
+		}
+		case EOverlapAbilityShape::Sector:
+		{
+			DrawDebugSector(OverlapEventData.Location, CurrentYaw, MinDistance, CurrentExtent.X, AngleDeviation);
+			break;
+		}
 		default:
 			break;
 		}
@@ -543,6 +753,42 @@ void UBaseOverlapAbility::OnOverlapEvent_Implementation(const FOverlapEventSnaps
 #endif //UE_BUILD_SHIPPING
 }
 
+#if !UE_BUILD_SHIPPING
+void UBaseOverlapAbility::DrawDebugSector(const FVector& Location, float Yaw, float InnerRadius, float OuterRadius, float HalfAngle) const
+{
+	const int32 NumSegments = 32;
+	const float ClampedHalfAngle = FMath::Clamp(HalfAngle, 0.f, 180.f);
+	const bool bFullRing = ClampedHalfAngle >= 180.f;
+	FVector PreviousInner = FVector::ZeroVector;
+	FVector PreviousOuter = FVector::ZeroVector;
+
+	for (int32 i = 0; i <= NumSegments; i++)
+	{
+		const float SegmentYaw = Yaw - ClampedHalfAngle + 2.f * ClampedHalfAngle * i / NumSegments;
+		const FVector Dir = FRotator(0.f, SegmentYaw, 0.f).Vector();
+		const FVector Inner = Location + Dir * InnerRadius;
+		const FVector Outer = Location + Dir * OuterRadius;
+
+		if (i > 0)
+		{
+			UKismetSystemLibrary::DrawDebugLine(this, PreviousOuter, Outer, FLinearColor::Green, .5f, 1.f);
+			if (InnerRadius > 0.f)
+			{
+				UKismetSystemLibrary::DrawDebugLine(this, PreviousInner, Inner, FLinearColor::Green, .5f, 1.f);
+			}
+		}
+
+		if (!bFullRing && (i == 0 || i == NumSegments))
+		{
+			UKismetSystemLibrary::DrawDebugLine(this, Inner, Outer, FLinearColor::Green, .5f, 1.f);
+		}
+
+		PreviousInner = Inner;
+		PreviousOuter = Outer;
+	}
+}
+#endif //UE_BUILD_SHIPPING
+
 FGameplayAbilityTargetDataHandle UBaseOverlapAbility::GetTargetData_Implementation(const FGameplayEventData& EventData) const
 {
 	return EventData.TargetData;
@@ -555,14 +801,22 @@ void UBaseOverlapAbility::ProcessOverlapEvent(const FGameplayEventData& Payload,
 
 	EventDataMap.Add(EventID, Payload);	
 
+	//Cue source tags only depend on the event, merge them once and share them with every cue of the event.
+	EventSourceTagsMap.Add(EventID, FSharedGameplayTagContainer::Union(GetSharedAbilityTags(), FSharedGameplayTagContainer::Intern(Payload.InstigatorTags)));
+
 	FEventSnapshottedAttributes SnapshotAttributes = FEventSnapshottedAttributes();
 	ProcessEventAttributes(Payload, EventID, SnapshotAttributes);
 	const float CurrentTime = GetWorld()->GetTimeSeconds();	
 
+	FOverlapEventGeometry Geometry;
+	BuildOverlapEventGeometryStep(0.f, SnapshotAttributes.DurationMultiplier, SnapshotAttributes.AreaMultiplier, Geometry.Initial);
+	Geometry.FinalExtent = GetAreaBoundsByLifeTime(1, false) * SnapshotAttributes.AreaMultiplier;
+
 	TArray<FOverlapEventSnapshot> EventSnapshots;
 	EventSnapshots.Reserve(OutHandle.Num() * (GetInterpSteps() + 1));
 
-	const float SpawnDelayInternal = AbilityTags.HasTag(UGlobalTags::Ability_SpawnBatch()) ? 0.f : SnapshotAttributes.SpawnDelay;
+	const bool bSpawnBatch = HasAbilityBehaviorFlag(EAbilityBehaviorFlags::SpawnBatch);
+	const float SpawnDelayInternal = bSpawnBatch ? 0.f : SnapshotAttributes.SpawnDelay;
 
 	for (int32 i = 0; i < OutHandle.Num(); i++)
 	{		
@@ -589,7 +843,7 @@ void UBaseOverlapAbility::ProcessOverlapEvent(const FGameplayEventData& Payload,
 			ExpandedEvents.Reserve(GetInterpSteps() + 1);
 			ExpandOverlapEvent(SnapshotEvent, ExpandedEvents);
 			EventSnapshots.Append(ExpandedEvents);
-			if (AbilityTags.HasTag(UGlobalTags::Ability_SpawnBatch()))
+			if (bSpawnBatch)
 			{
 				for (auto& Event : ExpandedEvents)
 				{
@@ -602,7 +856,7 @@ void UBaseOverlapAbility::ProcessOverlapEvent(const FGameplayEventData& Payload,
 		else
 		{
 			EventSnapshots.Add(SnapshotEvent);
-			if (AbilityTags.HasTag(UGlobalTags::Ability_SpawnBatch()))
+			if (bSpawnBatch)
 			{
 				SnapshotEvent.ActivationTime += SnapshotAttributes.SpawnDelay;	
 				SnapshotEvent.OverlapID += 10000;
@@ -613,15 +867,14 @@ void UBaseOverlapAbility::ProcessOverlapEvent(const FGameplayEventData& Payload,
 
 	if (Duration.ActivationDelay)
 	{
-		const float ActivationDelay = ScaleValueWithAttribute(Duration.ActivationDelay, UAbilitySystemComponent::GetOutgoingDurationProperty());
+		const float ActivationDelay = ScaleValueWithAttributeCached(Duration.ActivationDelay, UAbilitySystemComponent::GetOutgoingDurationProperty());
 
 		FGameplayCueParameters Params = FGameplayCueParameters();
-		Params.AggregatedSourceTags.AppendTags(AbilityTags);
-		Params.AggregatedSourceTags.AppendTags(Payload.InstigatorTags);
+		Params.AggregatedSourceTags = GetEventSourceTags(EventID).Get();
 		Params.RawMagnitude = SnapshotAttributes.DurationMultiplier;
-		Params.AbilityLevel = FMath::TruncToInt32(GetBaseMaximumAngleDeviationBetweenTargetAndOverlap(0) * SnapshotAttributes.AreaMultiplier);
-		Params.GameplayEffectLevel = FMath::TruncToInt32(GetBaseMinimumTargetDistanceToCenterRequired(0) * SnapshotAttributes.AreaMultiplier);
-		Params.Normal = GetAreaBoundsByLifeTime(1, false) * SnapshotAttributes.AreaMultiplier;
+		Params.AbilityLevel = FMath::TruncToInt32(Geometry.Initial.HalfAngle);
+		Params.GameplayEffectLevel = FMath::TruncToInt32(Geometry.Initial.InnerRadius);
+		Params.Normal = Geometry.FinalExtent;
 		Params.SourceObject = this;
 		ModifyGameplayCueParams(FOverlapEventID(EventID, 0), Params);
 		UAbilitySystemComponent* const AbilitySystemComponent = GetAbilitySystemComponentFromActorInfo_Checked();
@@ -640,6 +893,33 @@ void UBaseOverlapAbility::ProcessOverlapEvent(const FGameplayEventData& Payload,
 	}
 
 	GeneratePeriodicOverlapEvents(Payload, EventID, EventSnapshots);
+	if (Duration.Period > 0.f)
+	{
+		//Same snapshot the periods were spaced with, attributes can change before the first period is applied.
+		FEventSnapshottedPeriodicAttributes PeriodicAttributes;
+		ProcessEventPeriodicAttributes(Payload, EventID, PeriodicAttributes);
+		HitHistoryMap.FindOrAdd(EventID).RetargetInterval = PeriodicAttributes.Period;
+	}
+
+	//One geometry step per distinct elapsed time. Interpolation steps, spawn batch copies and periods share their entries across overlaps.
+	TMap<int32, int32> StepIndexByElapsedTime;
+	for (auto& Event : EventSnapshots)
+	{
+		const float ElapsedTime = Event.ActivationTime - Event.InitialEventTime;
+		const int32 ElapsedTimeKey = FMath::RoundToInt32(ElapsedTime * 1000.f);
+		if (const int32* StepIndex = StepIndexByElapsedTime.Find(ElapsedTimeKey))
+		{
+			Event.GeometryIndex = *StepIndex;
+		}
+		else
+		{
+			BuildOverlapEventGeometryStep(ElapsedTime, SnapshotAttributes.DurationMultiplier, SnapshotAttributes.AreaMultiplier, Geometry.Steps.AddDefaulted_GetRef());
+			Event.GeometryIndex = Geometry.Steps.Num() - 1;
+			StepIndexByElapsedTime.Add(ElapsedTimeKey, Event.GeometryIndex);
+		}
+	}
+
+	EventGeometryMap.Add(EventID, MoveTemp(Geometry));
 
 	if (HasScaleInterp() || SnapshotAttributes.SpawnDelay || Duration.Period || Duration.ActivationDelay)
 	{
@@ -661,19 +941,52 @@ void UBaseOverlapAbility::ProcessOverlapEvent(const FGameplayEventData& Payload,
 	}		
 }
 
+void UBaseOverlapAbility::BuildOverlapEventGeometryStep(float ElapsedTime, float DurationMultiplier, float AreaMultiplier, FOverlapEventGeometryStep& OutStep) const
+{
+	const float NormalizedElapsedTime = Duration.LifeSpan != 0 ? ElapsedTime / (Duration.LifeSpan * DurationMultiplier) : 1.f;
+	OutStep.ElapsedTime = ElapsedTime;
+	OutStep.Extent = GetAreaBoundsByLifeTime(NormalizedElapsedTime, false) * AreaMultiplier;
+	OutStep.InnerRadius = GetBaseMinimumTargetDistanceToCenterRequired(NormalizedElapsedTime) * AreaMultiplier;
+	OutStep.HalfAngle = GetBaseMaximumAngleDeviationBetweenTargetAndOverlap(NormalizedElapsedTime) * AreaMultiplier;
+	OutStep.YawOffset = RotationRate * ElapsedTime;
+	OutStep.Kernel = OverlapEventKernels::Select(Shape, OutStep.InnerRadius > 0.f, OutStep.HalfAngle < 180.f);
+}
+
+const FOverlapEventGeometryStep* UBaseOverlapAbility::FindOverlapEventGeometryStep(const FOverlapEventSnapshot& OverlapEventData) const
+{
+	const FOverlapEventGeometry* Geometry = EventGeometryMap.Find(OverlapEventData.EventID);
+	return Geometry ? Geometry->GetStep(OverlapEventData.GeometryIndex) : nullptr;
+}
+
 FGameplayAbilityTargetDataHandle UBaseOverlapAbility::ProcessTargetDataForEvent(const FGameplayEventData& Payload)
 {
 	FGameplayAbilityTargetDataHandle OutHandle = FGameplayAbilityTargetDataHandle();
-	const FGameplayAbilityTargetDataHandle InitialHandle = GetTargetData(Payload);
+	FGameplayAbilityTargetDataHandle InitialHandle = GetTargetData(Payload);
 	FTargetInformation TargetInfo = FTargetInformation();
+
+	//Individually targeted events without a target actor distribute over the nearest valid targets around the target location, one per overlap.
+	if (HasAbilityBehaviorFlag(EAbilityBehaviorFlags::IndividualTargeting) && GetAbilityRange() > 0.f)
+	{
+		GetTargetInformationFromTargetData(TargetInfo, InitialHandle);
+		if (!TargetInfo.TargetActor)
+		{
+			TArray<AActor*> NearestTargets;
+			if (FindNearestTargets(TargetInfo.GetEndLocation(AbilityTags, GetAvatarActorFromActorInfo()), GetOverlapAmount(GetAbilityLevel()), GetAbilityRange(), NearestTargets) > 0)
+			{
+				InitialHandle.Append(UAbilitySystemBlueprintLibrary::AbilityTargetDataFromActorArray(NearestTargets, true));
+			}
+		}
+		TargetInfo = FTargetInformation();
+	}
+
 	ApplyTargetDistribution(InitialHandle, OutHandle, TargetInfo);
 	return OutHandle;
 }
 
 void UBaseOverlapAbility::ProcessEventAttributes(const FGameplayEventData& Payload, int32 EventID, FEventSnapshottedAttributes& Attributes) const
 {	
-	Attributes.DurationMultiplier = ScaleValueWithAttribute(1, UAbilitySystemComponent::GetOutgoingDurationProperty());
-	Attributes.AreaMultiplier = ScaleValueWithAttribute(1, UAbilityAttributeSet::GetAreaOfEffectAttribute());
+	Attributes.DurationMultiplier = ScaleValueWithAttributeCached(1, UAbilitySystemComponent::GetOutgoingDurationProperty());
+	Attributes.AreaMultiplier = ScaleValueWithAttributeCached(1, UAbilityAttributeSet::GetAreaOfEffectAttribute());
 	Attributes.InitialRadius = GetAreaBoundsByLifeTime(0).X;
 	Attributes.SpawnDelay = GetSpawnDelay(GetAbilityLevel());
 	Attributes.InitialAvatarLocation = GetAvatarActorFromActorInfo()->GetActorLocation();
@@ -681,9 +994,9 @@ void UBaseOverlapAbility::ProcessEventAttributes(const FGameplayEventData& Paylo
 
 void UBaseOverlapAbility::ProcessEventPeriodicAttributes(const FGameplayEventData& Payload, int32 EventID, FEventSnapshottedPeriodicAttributes& Attributes) const
 {
-	Attributes.FirstPeriodDelay = ScaleValueWithAttribute(Duration.FirstPeriodDelay, UAbilityAttributeSet::GetOutgoingTickDurationAttribute());
-	Attributes.Period = ScaleValueWithAttribute(Duration.Period, UAbilityAttributeSet::GetOutgoingTickDurationAttribute());
-	Attributes.LifeSpan = ScaleValueWithAttribute(Duration.LifeSpan, UAbilitySystemComponent::GetOutgoingDurationProperty());
+	Attributes.FirstPeriodDelay = ScaleValueWithAttributeCached(Duration.FirstPeriodDelay, UAbilityAttributeSet::GetOutgoingTickDurationAttribute());
+	Attributes.Period = ScaleValueWithAttributeCached(Duration.Period, UAbilityAttributeSet::GetOutgoingTickDurationAttribute());
+	Attributes.LifeSpan = ScaleValueWithAttributeCached(Duration.LifeSpan, UAbilitySystemComponent::GetOutgoingDurationProperty());
 }
 
 void UBaseOverlapAbility::ExecuteOverlapAtLocation(const FGameplayAbilityTargetDataHandle& TargetData)
@@ -695,7 +1008,14 @@ void UBaseOverlapAbility::ExecuteOverlapAtLocation(const FGameplayAbilityTargetD
 
 bool UBaseOverlapAbility::IsOverlapQueueEmpty() const
 {
-	return InstantQueue.IsEmpty() && Queue.IsEmpty();
+	if (!InstantQueue.IsEmpty() || !Queue.IsEmpty())
+	{
+		return false;
+	}
+
+	//Events handed to the subsystem are still waiting to be applied.
+	const UOverlapEventSubsystem* OverlapEventSubsystem = GetWorld() ? GetWorld()->GetSubsystem<UOverlapEventSubsystem>() : nullptr;
+	return !OverlapEventSubsystem || !OverlapEventSubsystem->HasPendingOverlapEvents(this);
 }
 
 bool UBaseOverlapAbility::AddOverlapEventToQueue(const FOverlapEventSnapshot& EventData)
@@ -776,9 +1096,7 @@ void UBaseOverlapAbility::OnQueueTimerFinished()
 	{
 		UE_LOG(LogTemp, Log, TEXT("UBaseOverlapAbility::OnQueueTimerFinished: Triggered Overlap Event n�: %i"));
 		FOverlapEventSnapshot Snapshot = Queue.Pop();
-		InitAbilityModifiedTags(&GetEventData(Snapshot.EventID));
-		CompensateOverlapLocation(Snapshot);
-		OnOverlapEvent(Snapshot);
+		DispatchOverlapEvent(Snapshot);
 		UpdateQueueTimer();
 		if (ShouldCleanUpEvent(Snapshot.EventID))
 		{	
@@ -795,14 +1113,13 @@ void UBaseOverlapAbility::OnIsntantQueueTimerFinished()
 {
 	if (InstantQueue.Num())
 	{
+		//One event per tick. Batched events still share the frame with the events of other abilities.
 		FOverlapEventSnapshot Snapshot = InstantQueue.Pop();
-		InitAbilityModifiedTags(&GetEventData(Snapshot.EventID));		
-		CompensateOverlapLocation(Snapshot);
-		OnOverlapEvent(Snapshot);
+		DispatchOverlapEvent(Snapshot);
 		UpdateInstantQueueTimer();
 		if (ShouldCleanUpEvent(Snapshot.EventID))
 		{
-			CleanUpEvent(Snapshot.EventID);			
+			CleanUpEvent(Snapshot.EventID);
 		}
 	}
 	else
@@ -811,6 +1128,63 @@ void UBaseOverlapAbility::OnIsntantQueueTimerFinished()
 	}
 }
 
+void UBaseOverlapAbility::DispatchOverlapEvent(FOverlapEventSnapshot& Snapshot)
+{
+	InitAbilityModifiedTags(&GetEventData(Snapshot.EventID));
+	CompensateOverlapLocation(Snapshot);
+
+	if (Duration.Period > 0.f)
+	{
+		if (UPeriodicStaggerSubsystem* StaggerSubsystem = GetWorld() ? GetWorld()->GetSubsystem<UPeriodicStaggerSubsystem>() : nullptr)
+		{
+			StaggerSubsystem->AddPeriodicWork();
+		}
+	}
+
+	if (UOverlapEventSubsystem* OverlapEventSubsystem = GetOverlapEventSubsystem())
+	{
+		OverlapEventSubsystem->QueueOverlapEvent(this, Snapshot);
+	}
+	else
+	{
+		OnOverlapEvent(Snapshot);
+	}
+}
+
+bool UBaseOverlapAbility::CanBatchOverlapEvents() const
+{
+	//Blueprint overrides expect to run the whole event by themselves.
+	return !GetClass()->IsFunctionImplementedInScript(GET_FUNCTION_NAME_CHECKED(UBaseOverlapAbility, OnOverlapEvent));
+}
+
+UOverlapEventSubsystem* UBaseOverlapAbility::GetOverlapEventSubsystem() const
+{
+	if (GetWorld() && CanBatchOverlapEvents())
+	{
+		return GetWorld()->GetSubsystem<UOverlapEventSubsystem>();
+	}
+
+	return nullptr;
+}
+
+void UBaseOverlapAbility::PrepareBatchedOverlapEvent(const FOverlapEventSnapshot& OverlapEventData, FOverlapEventEvaluation& Evaluation)
+{
+	InitAbilityModifiedTags(&GetEventData(OverlapEventData.EventID));
+	PrepareOverlapEvaluation(OverlapEventData, Evaluation);
+}
+
+void UBaseOverlapAbility::ExecuteBatchedOverlapEvent(const FOverlapEventSnapshot& OverlapEventData, FOverlapEventEvaluation& Evaluation)
+{
+	//Other events of this ability may have been prepared after this one, restore the tags for this event.
+	InitAbilityModifiedTags(&GetEventData(OverlapEventData.EventID));
+	ApplyOverlapEvaluation(OverlapEventData, Evaluation);
+
+	if (ShouldCleanUpEvent(OverlapEventData.EventID))
+	{
+		CleanUpEvent(OverlapEventData.EventID);
+	}
+}
+
 void UBaseOverlapAbility::RestartQueues()
 {
 	UpdateInstantQueueTimer();
@@ -819,6 +1193,14 @@ void UBaseOverlapAbility::RestartQueues()
 
 bool UBaseOverlapAbility::ShouldCleanUpEvent(int32 EventID)
 {
+	if (const UOverlapEventSubsystem* OverlapEventSubsystem = GetWorld() ? GetWorld()->GetSubsystem<UOverlapEventSubsystem>() : nullptr)
+	{
+		if (OverlapEventSubsystem->HasPendingOverlapEvent(this, EventID))
+		{
+			return false;
+		}
+	}
+
 	for (const auto& it : InstantQueue)
 	{
 		if (it.EventID == EventID)
@@ -843,6 +1225,7 @@ void UBaseOverlapAbility::CleanUpEvent(int32 EventID)
 	RemoveConsumableEffect();
 
 	const int32 TargetCount = RemoveTargets(EventID);
+	HitHistoryMap.Remove(EventID);
 
 	if (ShouldSendMultihitEventOnCleanUp())
 	{
@@ -850,14 +1233,16 @@ void UBaseOverlapAbility::CleanUpEvent(int32 EventID)
 	}
 
 	EventDataMap.Remove(EventID);
+	EventSourceTagsMap.Remove(EventID);
 	EventEffectsMap.Remove(EventID);
+	EventGeometryMap.Remove(EventID);
 
 	ExecutedGameplayCues.RemoveAll([&EventID](FOverlapEventID ID)
 	{
 		return ID.EventID == EventID;
 	});
 	
-	if (Queue.IsEmpty() && InstantQueue.IsEmpty())
+	if (IsOverlapQueueEmpty())
 	{
 		OnQueueEmptied();
 		
@@ -905,6 +1290,22 @@ FGameplayTargetDataFilterHandle UBaseOverlapAbility::GetOverlapFilter_Implementa
 	return MakeAbilityFilterHandleFromAbility();
 }
 
+int32 UBaseOverlapAbility::FindNearestTargets(const FVector& Origin, int32 Count, float MaxRadius, TArray<AActor*>& OutTargets) const
+{
+	OutTargets.Reset();
+	UTargetAcquisitionSubsystem* TargetAcquisition = GetWorld() ? GetWorld()->GetSubsystem<UTargetAcquisitionSubsystem>() : nullptr;
+	if (!TargetAcquisition)
+	{
+		return 0;
+	}
+
+	const FGameplayTargetDataFilterHandle Filter = GetOverlapFilter();
+	return TargetAcquisition->FindNearestTargets(Origin, Count, MaxRadius, [&Filter](const AActor* Actor)
+		{
+			return Filter.FilterPassesForActor(Actor);
+		}, OutTargets);
+}
+
 void UBaseOverlapAbility::GetContainerSpecCacheForEvent(int32 EventID, FGameplayEffectContainerSpec& Spec) const
 {
 	Spec = *EventEffectsMap.Find(EventID);
@@ -943,7 +1344,9 @@ TArray<AActor*> UBaseOverlapAbility::GetIgnoredActors_Implementation(int32 Event
 	TArray<AActor*> IgnoredActors;
 	IgnoredActors.Empty();
 	
-	if (OverlapID <= 0)
+	//Periodic events retarget through the hit history, previous targets are not ignored.
+	const bool bPeriodic = Duration.Period > 0.f;
+	if (!bPeriodic && OverlapID <= 0)
 	{
 		for (auto& Pair : TargetsMap)
 		{
@@ -953,7 +1356,7 @@ TArray<AActor*> UBaseOverlapAbility::GetIgnoredActors_Implementation(int32 Event
 			}
 		}
 	}
-	else
+	else if (!bPeriodic)
 	{
 		FOverlapEventID ID = FOverlapEventID(EventID, OverlapID);
 
@@ -984,6 +1387,24 @@ TArray<AActor*> UBaseOverlapAbility::GetIgnoredActors_Implementation(int32 Event
 	return IgnoredActors;
 }
 
+float UBaseOverlapAbility::ScaleValueWithAttributeCached(float Value, FGameplayAttribute Attribute) const
+{
+	return FAttributeScalingCache::ScaleValueWithAttribute(GetAbilitySystemComponentFromActorInfo(), AbilityTags, Value, Attribute);
+}
+
+FTargetHitHistory& UBaseOverlapAbility::FindOrAddHitHistory(int32 EventID)
+{
+	if (FTargetHitHistory* HitHistory = HitHistoryMap.Find(EventID))
+	{
+		return *HitHistory;
+	}
+
+	//Events processed by ProcessOverlapEvent already have their history, with the snapshotted period.
+	FTargetHitHistory& HitHistory = HitHistoryMap.Add(EventID);
+	HitHistory.RetargetInterval = ScaleValueWithAttributeCached(Duration.Period, UAbilityAttributeSet::GetOutgoingTickDurationAttribute());
+	return HitHistory;
+}
+
 const FGameplayEventData& UBaseOverlapAbility::GetEventData(int32 EventID) const
 {
 	const FGameplayEventData* Data = EventDataMap.Find(EventID);
@@ -1030,9 +1451,54 @@ void UBaseOverlapAbility::SendMultihitEvent(int32 EventID, int32 Amount)
 	}
 }
 
+void UBaseOverlapAbility::InitAbilityModifiedTags(const FGameplayEventData* EventData)
+{
+	Super::InitAbilityModifiedTags(EventData);
+
+	//Every path that assigns AbilityTags ends here, so getters never see flags from the previous tags.
+	RefreshAbilityTagData();
+}
+
+void UBaseOverlapAbility::RefreshAbilityTagData() const
+{
+	BehaviorFlags = AbilityBehaviorFlags::FromTags(AbilityTags);
+	bBehaviorFlagsResolved = true;
+
+	//Interned on first use, most overlap events never need the shared tags.
+	bSharedAbilityTagsResolved = false;
+}
+
+FSharedGameplayTagContainer UBaseOverlapAbility::GetEventSourceTags(int32 EventID) const
+{
+	const FSharedGameplayTagContainer* SourceTags = EventSourceTagsMap.Find(EventID);
+	return SourceTags ? *SourceTags : GetSharedAbilityTags();
+}
+
+FSharedGameplayTagContainer UBaseOverlapAbility::GetSharedAbilityTags() const
+{
+	if (!bSharedAbilityTagsResolved)
+	{
+		SharedAbilityTags = FSharedGameplayTagContainer::Intern(AbilityTags);
+		bSharedAbilityTagsResolved = true;
+	}
+
+	return SharedAbilityTags;
+}
+
+bool UBaseOverlapAbility::HasAbilityBehaviorFlag(EAbilityBehaviorFlags Flag) const
+{
+	//Getters can run on the CDO or before the first event, resolve the flags on first use.
+	if (!bBehaviorFlagsResolved)
+	{
+		RefreshAbilityTagData();
+	}
+
+	return EnumHasAnyFlags(BehaviorFlags, Flag);
+}
+
 void UBaseOverlapAbility::CompensateOverlapLocation(FOverlapEventSnapshot& OverlapEvent)
 {	
-	if(AbilityTags.HasTag(UGlobalTags::Ability_Targeting_Start_Actor_Avatar()))
+	if (HasAbilityBehaviorFlag(EAbilityBehaviorFlags::StartAtAvatar))
 	{
 		OverlapEvent.Location += GetAvatarActorFromActorInfo()->GetActorLocation() - OverlapEvent.InitialAvatarLocation;
 	}
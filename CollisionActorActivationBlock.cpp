@@ -0,0 +1,79 @@
+// Copyright 2024 Marchetti S. César A. All Rights Reserved.
+
+#include "AbilitySystem/CollisionActors/CollisionActorActivationBlock.h"
+#include "AbilitySystem/AbilitySystemStats.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Collision Actor Activation Blocks Resolved"), STAT_CollisionActorActivationBlocksResolved, STATGROUP_AbilitySystemPerf);
+
+namespace CollisionActorActivationBlock
+{
+	using FBlockPtr = TSharedPtr<const FCollisionActorActivationBlock>;
+	using FWeakBlockPtr = TWeakPtr<const FCollisionActorActivationBlock>;
+
+	static TMap<FCollisionActorActivationBlock::FKey, FWeakBlockPtr> Blocks;
+
+	/** Expired entries are purged every time this many new blocks are resolved.*/
+	static constexpr int32 PurgeInterval = 64;
+	static int32 ResolvedSincePurge = 0;
+
+	static void PurgeExpired()
+	{
+		for (auto It = Blocks.CreateIterator(); It; ++It)
+		{
+			if (!It.Value().IsValid())
+			{
+				It.RemoveCurrent();
+			}
+		}
+	}
+}
+
+TSharedRef<const FCollisionActorActivationBlock> FCollisionActorActivationBlock::FindOrResolve(const FKey& Key, const FCollisionActorSharedData& SharedData, TFunctionRef<void(FCollisionActorActivationBlock&)> Resolve)
+{
+	using namespace CollisionActorActivationBlock;
+	check(IsInGameThread());
+
+	if (const FWeakBlockPtr* Existing = Blocks.Find(Key))
+	{
+		FBlockPtr Block = Existing->Pin();
+		if (Block && Block->WasResolvedFrom(SharedData))
+		{
+			return Block.ToSharedRef();
+		}
+	}
+
+	if (++ResolvedSincePurge >= PurgeInterval)
+	{
+		ResolvedSincePurge = 0;
+		PurgeExpired();
+	}
+
+	INC_DWORD_STAT(STAT_CollisionActorActivationBlocksResolved);
+
+	TSharedRef<FCollisionActorActivationBlock> NewBlock = MakeShared<FCollisionActorActivationBlock>();
+	NewBlock->AbilityLevel = SharedData.AbilityLevel;
+	NewBlock->DurationMultiplier = SharedData.DurationMultiplier;
+	NewBlock->PeriodMultiplier = SharedData.PeriodMultiplier;
+	NewBlock->SharedAreaMultiplier = SharedData.AreaMultiplier;
+	NewBlock->ModifierTags = SharedData.ModifierTags;
+	Resolve(*NewBlock);
+
+	Blocks.Add(Key, NewBlock);
+	return NewBlock;
+}
+
+int32 FCollisionActorActivationBlock::GetNumBlocks()
+{
+	int32 Num = 0;
+	for (const auto& Pair : CollisionActorActivationBlock::Blocks)
+	{
+		Num += Pair.Value.IsValid() ? 1 : 0;
+	}
+	return Num;
+}
+
+bool FCollisionActorActivationBlock::WasResolvedFrom(const FCollisionActorSharedData& SharedData) const
+{
+	return AbilityLevel == SharedData.AbilityLevel && DurationMultiplier == SharedData.DurationMultiplier && PeriodMultiplier == SharedData.PeriodMultiplier
+		&& SharedAreaMultiplier == SharedData.AreaMultiplier && ModifierTags == SharedData.ModifierTags;
+}
@@ -0,0 +1,75 @@
+// Copyright 2024 Marchetti S. César A. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+#include "AbilitySystem/CollisionActors/CollisionActorTypes.h"
+#include "AbilitySystem/AbilityBehaviorFlags.h"
+#include "AbilitySystem/SharedGameplayTagContainer.h"
+
+class UAbilitySystemComponent;
+
+/**
+*	State of an activation resolved from its shared data, once for every collision actor of the volley.
+*	Immutable and refcounted, actors keep a pointer to it and only copy what they modify during their lifetime.
+*	Blocks are found by instigator, shared data ID, collision actor class and ability classes, and validated against the shared data they were resolved from,
+*	so an ID reused by a later activation resolves a new block. The table only holds weak pointers, a block goes away with the last actor that uses it.
+*	Game thread only.
+*/
+struct CAMERAPLAY_API FCollisionActorActivationBlock
+{
+	/** Owning ability tags with the modifiers of the activation applied.*/
+	FGameplayTagContainer OwningAbilityTags;
+	EAbilityBehaviorFlags OwningAbilityFlags = EAbilityBehaviorFlags::None;
+	FSharedGameplayTagContainer SharedOwningAbilityTags;
+
+	/** Class duration with the duration and period multipliers applied.*/
+	FCollisionActorDuration Duration;
+
+	/** Class interpolations. The alternate rotation direction depends on the spawn index and is applied by each actor.*/
+	FScaleInterp ScaleInterpolation;
+	FCollisionActorRotationInterp RotationInterpolation;
+
+	/** Area multiplier of the shared data, scaled with the avatar for trap abilities.*/
+	float AreaMultiplier = 1.f;
+
+	struct FKey
+	{
+		TObjectKey<UAbilitySystemComponent> ASC;
+		TObjectKey<UClass> CollisionActorClass;
+		TObjectKey<UClass> AbilityClass;
+		TObjectKey<UClass> MainModifierAbilityClass;
+		int32 SharedDataID = 0;
+
+		bool operator==(const FKey& Other) const
+		{
+			return SharedDataID == Other.SharedDataID && ASC == Other.ASC && CollisionActorClass == Other.CollisionActorClass && AbilityClass == Other.AbilityClass && MainModifierAbilityClass == Other.MainModifierAbilityClass;
+		}
+
+		friend uint32 GetTypeHash(const FKey& Key)
+		{
+			uint32 Hash = HashCombine(GetTypeHash(Key.ASC), GetTypeHash(Key.CollisionActorClass));
+			Hash = HashCombine(Hash, GetTypeHash(Key.AbilityClass));
+			Hash = HashCombine(Hash, GetTypeHash(Key.MainModifierAbilityClass));
+			return HashCombine(Hash, ::GetTypeHash(Key.SharedDataID));
+		}
+	};
+
+	/** Returns the block of the activation, calling Resolve to fill a new one if there is none or the shared data changed.*/
+	static TSharedRef<const FCollisionActorActivationBlock> FindOrResolve(const FKey& Key, const FCollisionActorSharedData& SharedData, TFunctionRef<void(FCollisionActorActivationBlock&)> Resolve);
+
+	/** Amount of blocks in use.*/
+	static int32 GetNumBlocks();
+
+private:
+
+	/** Shared data the block was resolved from.*/
+	int32 AbilityLevel = 0;
+	float DurationMultiplier = 1.f;
+	float PeriodMultiplier = 1.f;
+	float SharedAreaMultiplier = 1.f;
+	FGameplayTagContainer ModifierTags;
+
+	bool WasResolvedFrom(const FCollisionActorSharedData& SharedData) const;
+};
@@ -0,0 +1,666 @@
+// Copyright 2024 Marchetti S. César A. All Rights Reserved.
+
+#include "AbilitySystem/ActorPool/CollisionActorPoolSubsystem.h"
+#include "AbilitySystem/CollisionActors/BaseCollisionActor.h"
+#include "AbilitySystem/ActorPool/PooledActorInterface.h"
+#include "AbilitySystem/AbilitySystemStats.h"
+#include "Engine/World.h"
+#include "UObject/UObjectIterator.h"
+#include "cameraplay/cameraplay.h"
+
+DECLARE_CYCLE_STAT(TEXT("Collision Actor Pool Prewarm"), STAT_CollisionActorPoolPrewarm, STATGROUP_AbilitySystemPerf);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Collision Actor Pool Hits"), STAT_CollisionActorPoolHits, STATGROUP_AbilitySystemPerf);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Collision Actor Pool Misses"), STAT_CollisionActorPoolMisses, STATGROUP_AbilitySystemPerf);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Collision Actor Pool Prewarmed"), STAT_CollisionActorPoolPrewarmed, STATGROUP_AbilitySystemPerf);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Collision Actor Pool Trimmed"), STAT_CollisionActorPoolTrimmed, STATGROUP_AbilitySystemPerf);
+
+int32 EnableCollisionActorPool = 0;
+static FAutoConsoleVariableRef CVarEnableCollisionActorPool(TEXT("AbilitySystem.CollisionActorPool"), EnableCollisionActorPool, TEXT("Pool collision actors in adaptive per class pools instead of the actor pool manager, and pool predicted and cosmetic instances locally. Values are 0 or 1."), ECVF_Default);
+
+float CollisionActorPoolPrewarmBudgetMs = 0.5f;
+static FAutoConsoleVariableRef CVarCollisionActorPoolPrewarmBudgetMs(TEXT("AbilitySystem.CollisionActorPool.PrewarmBudgetMs"), CollisionActorPoolPrewarmBudgetMs, TEXT("Milliseconds per frame the pool may spend spawning prewarm instances. At least one instance is spawned per frame while any is queued."), ECVF_Default);
+
+float CollisionActorPoolTrimCooldown = 20.f;
+static FAutoConsoleVariableRef CVarCollisionActorPoolTrimCooldown(TEXT("AbilitySystem.CollisionActorPool.TrimCooldown"), CollisionActorPoolTrimCooldown, TEXT("Seconds of each trim window. Idle instances above the demand of the window are destroyed when it closes."), ECVF_Default);
+
+int32 CollisionActorPoolTrimPerFrame = 2;
+static FAutoConsoleVariableRef CVarCollisionActorPoolTrimPerFrame(TEXT("AbilitySystem.CollisionActorPool.TrimPerFrame"), CollisionActorPoolTrimPerFrame, TEXT("Maximum idle instances destroyed per frame."), ECVF_Default);
+
+float CollisionActorPoolLeadTime = 0.5f;
+static FAutoConsoleVariableRef CVarCollisionActorPoolLeadTime(TEXT("AbilitySystem.CollisionActorPool.LeadTime"), CollisionActorPoolLeadTime, TEXT("Seconds of acquisitions, at the recent acquire rate, that the pool keeps free ahead of demand."), ECVF_Default);
+
+int32 CollisionActorPoolClearReferences = 1;
+static FAutoConsoleVariableRef CVarCollisionActorPoolClearReferences(TEXT("AbilitySystem.CollisionActorPool.ClearReferences"), CollisionActorPoolClearReferences, TEXT("Drop the object references of the last activation when an actor enters the pool, so garbage collection walks less through idle instances. Values are 0 or 1."), ECVF_Default);
+
+static FAutoConsoleCommandWithWorldAndArgs CollisionActorPoolStatsCommand(
+	TEXT("AbilitySystem.CollisionActorPool.Stats"),
+	TEXT("Logs the size and demand of every collision actor pool."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (UCollisionActorPoolSubsystem* PoolSubsystem = World ? World->GetSubsystem<UCollisionActorPoolSubsystem>() : nullptr)
+		{
+			PoolSubsystem->LogStats();
+		}
+	}));
+
+static FAutoConsoleCommandWithWorldAndArgs CollisionActorPoolClientStressCommand(
+	TEXT("AbilitySystem.CollisionActorPool.ClientStress"),
+	TEXT("Casts local collision actors in rounds through the local pool and with spawn and destroy, and logs spawn and garbage collection cost. Arguments: Class path (first native collision actor class), Actors per round (100), Rounds (20)."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&UCollisionActorPoolSubsystem::ClientStress));
+
+static FAutoConsoleCommandWithWorldAndArgs CollisionActorPoolMeasureGCCommand(
+	TEXT("AbilitySystem.CollisionActorPool.MeasureGC"),
+	TEXT("Logs the garbage collection time attributable to idle pooled collision actors, by collecting with and without them. The pools are refilled by the prewarm afterwards. Arguments: Collections (5)."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&UCollisionActorPoolSubsystem::MeasureGC));
+
+TMap<TPair<FSoftClassPath, bool>, int32> UCollisionActorPoolSubsystem::RememberedHighWaterMarks;
+
+ABaseCollisionActor* FCollisionActorClassPool::PopFreeActor()
+{
+	for (TArray<TObjectPtr<ABaseCollisionActor>>* List : { &FreeActors, &ColdActors })
+	{
+		while (List->Num() > 0)
+		{
+			ABaseCollisionActor* Candidate = List->Pop();
+			if (IsValid(Candidate))
+			{
+				return Candidate;
+			}
+		}
+	}
+
+	return nullptr;
+}
+
+void FCollisionActorClassPool::DemoteFreeActors(int32 Count)
+{
+	Count = FMath::Min(Count, FreeActors.Num());
+	if (Count > 0)
+	{
+		ColdActors.Append(FreeActors.GetData(), Count);
+		FreeActors.RemoveAt(0, Count);
+	}
+}
+
+bool UCollisionActorPoolSubsystem::IsEnabled()
+{
+	return EnableCollisionActorPool != 0;
+}
+
+bool UCollisionActorPoolSubsystem::IsLocalCollisionActor(const ABaseCollisionActor* Actor)
+{
+	//Actors spawned by a client never replicate, whatever their class says.
+	return Actor && (!Actor->GetIsReplicated() || Actor->GetNetMode() == NM_Client);
+}
+
+void UCollisionActorPoolSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	if (!IsEnabled())
+	{
+		return;
+	}
+
+	//Prewarm for the demand seen on previous maps.
+	for (const TPair<TPair<FSoftClassPath, bool>, int32>& Remembered : RememberedHighWaterMarks)
+	{
+		if (UClass* Class = Remembered.Key.Key.ResolveClass())
+		{
+			PrewarmClass(Class, Remembered.Key.Value);
+		}
+	}
+}
+
+void UCollisionActorPoolSubsystem::Deinitialize()
+{
+	for (const TMap<TObjectPtr<UClass>, FCollisionActorClassPool>* PoolMap : { &Pools, &LocalPools })
+	{
+		for (const TPair<TObjectPtr<UClass>, FCollisionActorClassPool>& Pool : *PoolMap)
+		{
+			RememberHighWaterMark(Pool.Key, Pool.Value.bLocal, Pool.Value.HighWaterMark);
+		}
+	}
+
+	Pools.Empty();
+	LocalPools.Empty();
+	PrewarmQueue.Empty();
+	PrewarmQueueHead = 0;
+
+	Super::Deinitialize();
+}
+
+TStatId UCollisionActorPoolSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCollisionActorPoolSubsystem, STATGROUP_Tickables);
+}
+
+void UCollisionActorPoolSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (Pools.IsEmpty() && LocalPools.IsEmpty())
+	{
+		return;
+	}
+
+	TickPrewarm();
+	TickTrim();
+}
+
+ABaseCollisionActor* UCollisionActorPoolSubsystem::AcquireCollisionActor(TSubclassOf<ABaseCollisionActor> Class, const FTransform& Transform, AActor* Owner, APawn* Instigator, bool bLocal)
+{
+	UWorld* World = GetWorld();
+	if (!Class || !World)
+	{
+		return nullptr;
+	}
+
+	FCollisionActorClassPool& Pool = FindOrAddPool(Class, bLocal);
+
+	//Last released first, its memory is the most likely to still be in cache.
+	ABaseCollisionActor* Actor = Pool.PopFreeActor();
+
+	if (Actor)
+	{
+		INC_DWORD_STAT(STAT_CollisionActorPoolHits);
+		ReuseCollisionActor(Actor, Transform, Owner, Instigator);
+	}
+	else
+	{
+		//Pool ran dry, spawn now and let the acquire rate grow the pool for the next ones.
+		INC_DWORD_STAT(STAT_CollisionActorPoolMisses);
+		Actor = SpawnCollisionActor(Class, Transform, Owner, Instigator, bLocal);
+		if (!Actor)
+		{
+			return nullptr;
+		}
+	}
+
+	OnAcquired(Class, Pool, 1);
+	return Actor;
+}
+
+void UCollisionActorPoolSubsystem::AcquireCollisionActors(TSubclassOf<ABaseCollisionActor> Class, TArrayView<const FTransform> Transforms, AActor* Owner, APawn* Instigator, TArray<ABaseCollisionActor*>& OutActors, bool bLocal)
+{
+	OutActors.Reset(Transforms.Num());
+
+	UWorld* World = GetWorld();
+	if (!Class || !World || Transforms.IsEmpty())
+	{
+		return;
+	}
+
+	FCollisionActorClassPool& Pool = FindOrAddPool(Class, bLocal);
+
+	//One pool lookup for the volley, then the same LIFO pops as single acquisitions.
+	int32 NumHits = 0;
+	int32 NumAcquired = 0;
+	for (const FTransform& Transform : Transforms)
+	{
+		ABaseCollisionActor* Actor = Pool.PopFreeActor();
+
+		if (Actor)
+		{
+			NumHits++;
+			ReuseCollisionActor(Actor, Transform, Owner, Instigator);
+		}
+		else
+		{
+			Actor = SpawnCollisionActor(Class, Transform, Owner, Instigator, bLocal);
+		}
+
+		OutActors.Add(Actor);
+		NumAcquired += Actor ? 1 : 0;
+	}
+
+	INC_DWORD_STAT_BY(STAT_CollisionActorPoolHits, NumHits);
+	INC_DWORD_STAT_BY(STAT_CollisionActorPoolMisses, NumAcquired - NumHits);
+
+	OnAcquired(Class, Pool, NumAcquired);
+}
+
+void UCollisionActorPoolSubsystem::ReuseCollisionActor(ABaseCollisionActor* Actor, const FTransform& Transform, AActor* Owner, APawn* Instigator) const
+{
+	Actor->SetActorTransform(Transform, false, nullptr, ETeleportType::ResetPhysics);
+	Actor->SetOwner(Owner);
+	Actor->SetInstigator(Instigator);
+	IPooledActorInterface::Execute_SetInRecycleQueue(Actor, false);
+	IPooledActorInterface::Execute_ReuseAfterRecycle(Actor);
+
+	if (Actor->GetIsReplicated())
+	{
+		Actor->SetNetDormancy(ENetDormancy::DORM_Awake);
+	}
+}
+
+void UCollisionActorPoolSubsystem::OnAcquired(UClass* Class, FCollisionActorClassPool& Pool, int32 NumAcquired)
+{
+	if (NumAcquired <= 0)
+	{
+		return;
+	}
+
+	Pool.NumInUse += NumAcquired;
+	Pool.AcquiresThisWindow += NumAcquired;
+	Pool.HighWaterMark = FMath::Max(Pool.HighWaterMark, Pool.NumInUse);
+
+	//Demand is back, keep the instances that were going to be trimmed.
+	Pool.NumPendingTrim = FMath::Max(Pool.NumPendingTrim - NumAcquired, 0);
+
+	//Keep the acquisitions expected over the lead time free.
+	const int32 DesiredFree = FMath::CeilToInt32(Pool.AcquireRate * CollisionActorPoolLeadTime);
+	if (Pool.GetNumFree() + Pool.NumPendingPrewarm < DesiredFree)
+	{
+		QueuePrewarm(Class, Pool, Pool.NumInUse + DesiredFree);
+	}
+}
+
+void UCollisionActorPoolSubsystem::ReleaseCollisionActor(ABaseCollisionActor* Actor)
+{
+	if (!IsValid(Actor))
+	{
+		return;
+	}
+
+	FCollisionActorClassPool& Pool = FindOrAddPool(Actor->GetClass(), IsLocalCollisionActor(Actor));
+	Pool.NumInUse = FMath::Max(Pool.NumInUse - 1, 0);
+
+	IPooledActorInterface::Execute_Recycle(Actor);
+	IPooledActorInterface::Execute_SetInRecycleQueue(Actor, true);
+
+	if (CollisionActorPoolClearReferences)
+	{
+		Actor->ReleaseReferencesForPool();
+	}
+
+	Pool.FreeActors.Push(Actor);
+}
+
+void UCollisionActorPoolSubsystem::PrewarmClass(TSubclassOf<ABaseCollisionActor> Class, bool bLocal)
+{
+	if (!Class || !IsEnabled() || !CanPool(bLocal))
+	{
+		return;
+	}
+
+	const int32* Remembered = RememberedHighWaterMarks.Find(TPair<FSoftClassPath, bool>(FSoftClassPath(Class), bLocal));
+	const int32 DesiredSize = FMath::Max(Class->GetDefaultObject<ABaseCollisionActor>()->GetNumPreallocatedInstances(), Remembered ? *Remembered : 0);
+
+	FCollisionActorClassPool& Pool = FindOrAddPool(Class, bLocal);
+	QueuePrewarm(Class, Pool, DesiredSize);
+}
+
+void UCollisionActorPoolSubsystem::LogStats() const
+{
+	UE_LOG(CollisionActorLog, Log, TEXT("Collision actor pools: %d replicated, %d local"), Pools.Num(), LocalPools.Num());
+	for (const TMap<TObjectPtr<UClass>, FCollisionActorClassPool>* PoolMap : { &Pools, &LocalPools })
+	{
+		for (const TPair<TObjectPtr<UClass>, FCollisionActorClassPool>& Pool : *PoolMap)
+		{
+			UE_LOG(CollisionActorLog, Log, TEXT("  %s%s: Free %d, InUse %d, HighWaterMark %d, PendingPrewarm %d, PendingTrim %d, AcquireRate %.2f/s"),
+				*GetNameSafe(Pool.Key), Pool.Value.bLocal ? TEXT(" (Local)") : TEXT(""), Pool.Value.GetNumFree(), Pool.Value.NumInUse, Pool.Value.HighWaterMark, Pool.Value.NumPendingPrewarm, Pool.Value.NumPendingTrim, Pool.Value.AcquireRate);
+		}
+	}
+}
+
+void UCollisionActorPoolSubsystem::ClientStress(const TArray<FString>& Args, UWorld* World)
+{
+	UCollisionActorPoolSubsystem* PoolSubsystem = World ? World->GetSubsystem<UCollisionActorPoolSubsystem>() : nullptr;
+	if (!PoolSubsystem)
+	{
+		return;
+	}
+
+	UClass* Class = nullptr;
+	if (Args.Num() > 0)
+	{
+		Class = FSoftClassPath(Args[0]).TryLoadClass<ABaseCollisionActor>();
+	}
+	else
+	{
+		for (TObjectIterator<UClass> It; It; ++It)
+		{
+			if (It->IsChildOf(ABaseCollisionActor::StaticClass()) && !It->HasAnyClassFlags(CLASS_Abstract | CLASS_Deprecated | CLASS_NewerVersionExists))
+			{
+				Class = *It;
+				break;
+			}
+		}
+	}
+
+	if (!Class)
+	{
+		UE_LOG(CollisionActorLog, Warning, TEXT("UCollisionActorPoolSubsystem::ClientStress: No collision actor class to spawn."));
+		return;
+	}
+
+	const int32 ActorsPerRound = Args.Num() > 1 ? FMath::Max(1, FCString::Atoi(*Args[1])) : 100;
+	const int32 Rounds = Args.Num() > 2 ? FMath::Max(1, FCString::Atoi(*Args[2])) : 20;
+
+	TArray<ABaseCollisionActor*> RoundActors;
+	RoundActors.Reserve(ActorsPerRound);
+
+	//Each round casts a burst of local actors and recycles them, then collects garbage as the frames after a fight would.
+	auto RunRounds = [&](bool bPooled, double& OutCastSeconds, double& OutGarbageSeconds)
+	{
+		OutCastSeconds = 0.0;
+		OutGarbageSeconds = 0.0;
+
+		for (int32 Round = 0; Round < Rounds; Round++)
+		{
+			const double CastStart = FPlatformTime::Seconds();
+			for (int32 Index = 0; Index < ActorsPerRound; Index++)
+			{
+				const FTransform Transform(FVector(Index * 10.f, Round * 10.f, 0.f));
+				ABaseCollisionActor* Actor = bPooled ? PoolSubsystem->AcquireCollisionActor(Class, Transform, nullptr, nullptr, true) : PoolSubsystem->SpawnCollisionActor(Class, Transform, nullptr, nullptr, true);
+				if (Actor)
+				{
+					RoundActors.Add(Actor);
+				}
+			}
+
+			for (ABaseCollisionActor* Actor : RoundActors)
+			{
+				if (bPooled)
+				{
+					PoolSubsystem->ReleaseCollisionActor(Actor);
+				}
+				else
+				{
+					Actor->Destroy();
+				}
+			}
+			RoundActors.Reset();
+			OutCastSeconds += FPlatformTime::Seconds() - CastStart;
+
+			const double GarbageStart = FPlatformTime::Seconds();
+			CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+			OutGarbageSeconds += FPlatformTime::Seconds() - GarbageStart;
+		}
+	};
+
+	double SpawnCastSeconds = 0.0;
+	double SpawnGarbageSeconds = 0.0;
+	RunRounds(false, SpawnCastSeconds, SpawnGarbageSeconds);
+
+	double PooledCastSeconds = 0.0;
+	double PooledGarbageSeconds = 0.0;
+	RunRounds(true, PooledCastSeconds, PooledGarbageSeconds);
+
+	const int32 Casts = ActorsPerRound * Rounds;
+	UE_LOG(CollisionActorLog, Log, TEXT("Client stress %s, %d rounds of %d actors:"), *Class->GetName(), Rounds, ActorsPerRound);
+	UE_LOG(CollisionActorLog, Log, TEXT("  Spawn and destroy: %.2f us per cast, %.2f ms GC per round."), SpawnCastSeconds * 1000000.0 / Casts, SpawnGarbageSeconds * 1000.0 / Rounds);
+	UE_LOG(CollisionActorLog, Log, TEXT("  Local pool: %.2f us per cast, %.2f ms GC per round."), PooledCastSeconds * 1000000.0 / Casts, PooledGarbageSeconds * 1000.0 / Rounds);
+}
+
+void UCollisionActorPoolSubsystem::MeasureGC(const TArray<FString>& Args, UWorld* World)
+{
+	UCollisionActorPoolSubsystem* PoolSubsystem = World ? World->GetSubsystem<UCollisionActorPoolSubsystem>() : nullptr;
+	if (!PoolSubsystem)
+	{
+		return;
+	}
+
+	const int32 Collections = Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 5;
+
+	auto MeasureCollections = [Collections]()
+	{
+		//Leftover garbage would be purged by the first timed collection.
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+
+		const double StartTime = FPlatformTime::Seconds();
+		for (int32 Collection = 0; Collection < Collections; Collection++)
+		{
+			CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+		}
+		return (FPlatformTime::Seconds() - StartTime) * 1000.0 / Collections;
+	};
+
+	int32 NumPooled = 0;
+	int32 NumComponents = 0;
+	for (const TMap<TObjectPtr<UClass>, FCollisionActorClassPool>* PoolMap : { &PoolSubsystem->Pools, &PoolSubsystem->LocalPools })
+	{
+		for (const TPair<TObjectPtr<UClass>, FCollisionActorClassPool>& Pool : *PoolMap)
+		{
+			for (const TArray<TObjectPtr<ABaseCollisionActor>>* List : { &Pool.Value.FreeActors, &Pool.Value.ColdActors })
+			{
+				for (const ABaseCollisionActor* Actor : *List)
+				{
+					if (IsValid(Actor))
+					{
+						NumPooled++;
+						NumComponents += Actor->GetComponents().Num();
+					}
+				}
+			}
+		}
+	}
+
+	const double WithPoolMs = MeasureCollections();
+
+	//Destroy the idle instances and queue them again, the prewarm refills the pools over the next frames.
+	for (TMap<TObjectPtr<UClass>, FCollisionActorClassPool>* PoolMap : { &PoolSubsystem->Pools, &PoolSubsystem->LocalPools })
+	{
+		for (TPair<TObjectPtr<UClass>, FCollisionActorClassPool>& Pool : *PoolMap)
+		{
+			const int32 PoolSize = Pool.Value.NumInUse + Pool.Value.GetNumFree();
+			for (TArray<TObjectPtr<ABaseCollisionActor>>* List : { &Pool.Value.FreeActors, &Pool.Value.ColdActors })
+			{
+				for (ABaseCollisionActor* Actor : *List)
+				{
+					if (IsValid(Actor))
+					{
+						Actor->Destroy();
+					}
+				}
+				List->Reset();
+			}
+			Pool.Value.NumPendingTrim = 0;
+			PoolSubsystem->QueuePrewarm(Pool.Key, Pool.Value, PoolSize);
+		}
+	}
+
+	const double WithoutPoolMs = MeasureCollections();
+
+	UE_LOG(CollisionActorLog, Log, TEXT("Pooled collision actors GC: %d idle actors, %d components, references cleared on pool entry: %d."), NumPooled, NumComponents, CollisionActorPoolClearReferences);
+	UE_LOG(CollisionActorLog, Log, TEXT("  %.3f ms per collection with the pools, %.3f ms without, %.3f ms attributable to pooled actors (%.2f us per actor)."),
+		WithPoolMs, WithoutPoolMs, WithPoolMs - WithoutPoolMs, NumPooled > 0 ? (WithPoolMs - WithoutPoolMs) * 1000.0 / NumPooled : 0.0);
+}
+
+FCollisionActorClassPool& UCollisionActorPoolSubsystem::FindOrAddPool(UClass* Class, bool bLocal)
+{
+	TMap<TObjectPtr<UClass>, FCollisionActorClassPool>& PoolMap = bLocal ? LocalPools : Pools;
+	if (FCollisionActorClassPool* Pool = PoolMap.Find(Class))
+	{
+		return *Pool;
+	}
+
+	FCollisionActorClassPool& Pool = PoolMap.Add(Class);
+	Pool.bLocal = bLocal;
+	Pool.WindowStartTime = GetWorld() ? GetWorld()->GetTimeSeconds() : 0.f;
+	return Pool;
+}
+
+bool UCollisionActorPoolSubsystem::CanPool(bool bLocal) const
+{
+	const UWorld* World = GetWorld();
+	return World && (bLocal || World->GetNetMode() != NM_Client);
+}
+
+ABaseCollisionActor* UCollisionActorPoolSubsystem::SpawnCollisionActor(UClass* Class, const FTransform& Transform, AActor* Owner, APawn* Instigator, bool bLocal) const
+{
+	UWorld* World = GetWorld();
+	if (!World)
+	{
+		return nullptr;
+	}
+
+	ABaseCollisionActor* Actor = World->SpawnActorDeferred<ABaseCollisionActor>(Class, Transform, Owner, Instigator, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+	if (!Actor)
+	{
+		return nullptr;
+	}
+
+	if (bLocal)
+	{
+		Actor->SetReplicatesDirectly(false);
+	}
+
+	Actor->FinishSpawning(Transform);
+	return Actor;
+}
+
+ABaseCollisionActor* UCollisionActorPoolSubsystem::SpawnPooledActor(UClass* Class, const FTransform& Transform, bool bLocal) const
+{
+	ABaseCollisionActor* Actor = SpawnCollisionActor(Class, Transform, nullptr, nullptr, bLocal);
+	if (Actor)
+	{
+		if (Actor->GetIsReplicated())
+		{
+			Actor->SetNetDormancy(ENetDormancy::DORM_DormantAll);
+		}
+
+		IPooledActorInterface::Execute_SetInRecycleQueue(Actor, true);
+	}
+
+	return Actor;
+}
+
+void UCollisionActorPoolSubsystem::QueuePrewarm(UClass* Class, FCollisionActorClassPool& Pool, int32 DesiredSize)
+{
+	const int32 Missing = DesiredSize - (Pool.NumInUse + Pool.GetNumFree() + Pool.NumPendingPrewarm);
+	if (Missing <= 0)
+	{
+		return;
+	}
+
+	if (Pool.NumPendingPrewarm == 0)
+	{
+		PrewarmQueue.Emplace(Class, Pool.bLocal);
+	}
+
+	Pool.NumPendingPrewarm += Missing;
+	Pool.NumPendingTrim = 0;
+}
+
+void UCollisionActorPoolSubsystem::RememberHighWaterMark(UClass* Class, bool bLocal, int32 HighWaterMark)
+{
+	if (Class && HighWaterMark > 0)
+	{
+		int32& Remembered = RememberedHighWaterMarks.FindOrAdd(TPair<FSoftClassPath, bool>(FSoftClassPath(Class), bLocal));
+		Remembered = FMath::Max(Remembered, HighWaterMark);
+	}
+}
+
+void UCollisionActorPoolSubsystem::TickPrewarm()
+{
+	if (PrewarmQueueHead >= PrewarmQueue.Num())
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_CollisionActorPoolPrewarm);
+
+	const double EndTime = FPlatformTime::Seconds() + CollisionActorPoolPrewarmBudgetMs * 0.001;
+	bool bSpawned = false;
+
+	while (PrewarmQueueHead < PrewarmQueue.Num() && (!bSpawned || FPlatformTime::Seconds() < EndTime))
+	{
+		UClass* Class = PrewarmQueue[PrewarmQueueHead].Key.Get();
+		const bool bLocal = PrewarmQueue[PrewarmQueueHead].Value;
+		FCollisionActorClassPool* Pool = Class ? (bLocal ? LocalPools : Pools).Find(Class) : nullptr;
+		if (!Pool || Pool->NumPendingPrewarm <= 0)
+		{
+			PrewarmQueueHead++;
+			continue;
+		}
+
+		bSpawned = true;
+		Pool->NumPendingPrewarm--;
+
+		if (ABaseCollisionActor* Actor = SpawnPooledActor(Class, FTransform::Identity, bLocal))
+		{
+			INC_DWORD_STAT(STAT_CollisionActorPoolPrewarmed);
+
+			//Prewarmed instances were never used, they go to the cold list and released ones stay on top.
+			Pool->ColdActors.Push(Actor);
+		}
+		else
+		{
+			Pool->NumPendingPrewarm = 0;
+		}
+
+		if (Pool->NumPendingPrewarm <= 0)
+		{
+			PrewarmQueueHead++;
+		}
+	}
+
+	//Popping from the front would shift the whole queue, done entries are dropped at once when none is left.
+	if (PrewarmQueueHead >= PrewarmQueue.Num())
+	{
+		PrewarmQueue.Reset();
+		PrewarmQueueHead = 0;
+	}
+}
+
+void UCollisionActorPoolSubsystem::TickTrim()
+{
+	const float WorldTime = GetWorld()->GetTimeSeconds();
+	const float Cooldown = FMath::Max(CollisionActorPoolTrimCooldown, 1.f);
+	int32 TrimBudget = FMath::Max(CollisionActorPoolTrimPerFrame, 0);
+
+	for (TMap<TObjectPtr<UClass>, FCollisionActorClassPool>* PoolMap : { &Pools, &LocalPools })
+	{
+		for (TPair<TObjectPtr<UClass>, FCollisionActorClassPool>& Entry : *PoolMap)
+		{
+			FCollisionActorClassPool& Pool = Entry.Value;
+			const float WindowTime = WorldTime - Pool.WindowStartTime;
+
+			if (WindowTime >= Cooldown)
+			{
+				//Remember the peak before starting a new window, so the next map can prewarm for it.
+				RememberHighWaterMark(Entry.Key, Pool.bLocal, Pool.HighWaterMark);
+
+				Pool.AcquireRate = FMath::Lerp(Pool.AcquireRate, Pool.AcquiresThisWindow / WindowTime, 0.5f);
+				Pool.AcquiresThisWindow = 0;
+				Pool.WindowStartTime = WorldTime;
+
+				//The pool keeps enough instances for the demand of the closed window and drops the rest.
+				const int32 PreallocatedInstances = Entry.Key ? Entry.Key->GetDefaultObject<ABaseCollisionActor>()->GetNumPreallocatedInstances() : 0;
+				const int32 DesiredSize = FMath::Max(PreallocatedInstances, Pool.HighWaterMark + FMath::CeilToInt32(Pool.AcquireRate * CollisionActorPoolLeadTime));
+				Pool.HighWaterMark = Pool.NumInUse;
+
+				const int32 Excess = Pool.NumInUse + Pool.GetNumFree() + Pool.NumPendingPrewarm - DesiredSize;
+				if (Excess > 0)
+				{
+					Pool.NumPendingPrewarm = 0;
+					Pool.NumPendingTrim = Excess;
+
+					//Once per window, the bottom of the free list becomes cold if the cold list alone can't cover the trim.
+					Pool.DemoteFreeActors(Excess - Pool.ColdActors.Num());
+				}
+			}
+
+			//Destroy from the cold list, acquisitions keep using the hot one.
+			Pool.NumPendingTrim = FMath::Min(Pool.NumPendingTrim, Pool.ColdActors.Num());
+			const int32 NumToTrim = FMath::Min(Pool.NumPendingTrim, TrimBudget);
+			for (int32 Index = 0; Index < NumToTrim; Index++)
+			{
+				ABaseCollisionActor* Actor = Pool.ColdActors.Pop();
+				if (IsValid(Actor))
+				{
+					Actor->Destroy();
+				}
+			}
+
+			if (NumToTrim > 0)
+			{
+				INC_DWORD_STAT_BY(STAT_CollisionActorPoolTrimmed, NumToTrim);
+				Pool.NumPendingTrim -= NumToTrim;
+				TrimBudget -= NumToTrim;
+			}
+		}
+	}
+}
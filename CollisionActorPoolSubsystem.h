@@ -0,0 +1,157 @@
+// Copyright 2024 Marchetti S. César A. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CollisionActorPoolSubsystem.generated.h"
+
+class ABaseCollisionActor;
+
+/** Free instances and demand of one collision actor class.*/
+USTRUCT()
+struct FCollisionActorClassPool
+{
+	GENERATED_BODY()
+
+	/** LIFO list of released instances. The last released actor is the first one reused.*/
+	UPROPERTY()
+	TArray<TObjectPtr<ABaseCollisionActor>> FreeActors;
+
+	/** Instances that were never used or sat idle through a trim window. Reused after FreeActors and trimmed first, all ends are O(1).*/
+	UPROPERTY()
+	TArray<TObjectPtr<ABaseCollisionActor>> ColdActors;
+
+	/** Instances given out and not released yet.*/
+	int32 NumInUse = 0;
+
+	/** Highest NumInUse since the last trim window.*/
+	int32 HighWaterMark = 0;
+
+	/** Instances queued to be spawned by the time sliced prewarm.*/
+	int32 NumPendingPrewarm = 0;
+
+	/** Idle instances to destroy from the cold end of the free list, a few per frame.*/
+	int32 NumPendingTrim = 0;
+
+	/** Smoothed acquisitions per second.*/
+	float AcquireRate = 0.f;
+
+	int32 AcquiresThisWindow = 0;
+
+	/** World time the trim window started.*/
+	float WindowStartTime = 0.f;
+
+	/** Non replicated instances, recycled on the machine that spawned them.*/
+	bool bLocal = false;
+
+	int32 GetNumFree() const
+	{
+		return FreeActors.Num() + ColdActors.Num();
+	}
+
+	/** Hottest valid free instance, or null if the pool ran dry. Destroyed instances are dropped on the way.*/
+	ABaseCollisionActor* PopFreeActor();
+
+	/** Moves the coldest instances of FreeActors to ColdActors, so they are trimmed before the ones released recently.*/
+	void DemoteFreeActors(int32 Count);
+};
+
+/**
+*	Per class pools of collision actors with adaptive sizes.
+*	Fetch and return are O(1) pops and pushes on a LIFO free list. Pools are prewarmed a few instances per frame within a time budget, sized from the class preallocation,
+*	the high-water mark remembered from previous maps and the recent acquire rate, and idle instances are trimmed after a cool-down.
+*	Opt-in with AbilitySystem.CollisionActorPool.
+*	Replicated instances are pooled on authority only, like the actor pool manager it replaces for collision actors. Predicted and cosmetic instances are non replicated and
+*	pooled locally, on clients too, in separate pools so a local instance is never handed out where a replicated one is expected.
+*	Actors drop the references of their last activation when they enter a pool, so idle instances only reference their own components.
+*/
+UCLASS()
+class CAMERAPLAY_API UCollisionActorPoolSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	static bool IsEnabled();
+
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/** Reuses a free instance of the class, or spawns one if the pool ran dry. Local instances don't replicate, for predicted and cosmetic actors.*/
+	ABaseCollisionActor* AcquireCollisionActor(TSubclassOf<ABaseCollisionActor> Class, const FTransform& Transform, AActor* Owner, APawn* Instigator, bool bLocal = false);
+
+	/** Acquires one instance per transform with a single pool lookup, for volleys. OutActors matches the transforms, with null for instances that couldn't be spawned.*/
+	void AcquireCollisionActors(TSubclassOf<ABaseCollisionActor> Class, TArrayView<const FTransform> Transforms, AActor* Owner, APawn* Instigator, TArray<ABaseCollisionActor*>& OutActors, bool bLocal = false);
+
+	/** Returns a deactivated actor to its pool.*/
+	void ReleaseCollisionActor(ABaseCollisionActor* Actor);
+
+	/** Queues instances of the class until the pool holds its preallocation or remembered high-water mark. Call when an ability that spawns it is granted.*/
+	void PrewarmClass(TSubclassOf<ABaseCollisionActor> Class, bool bLocal = false);
+
+	/** Whether or not the actor belongs to a local pool: not replicated, or spawned by a client.*/
+	static bool IsLocalCollisionActor(const ABaseCollisionActor* Actor);
+
+	/**
+	*	Spawns and releases local instances of a class in rounds, once through the local pool and once with spawn and destroy, and logs the cost of each including garbage collection.
+	*	Bound to AbilitySystem.CollisionActorPool.ClientStress.
+	*/
+	static void ClientStress(const TArray<FString>& Args, UWorld* World);
+
+	/**
+	*	Times garbage collections with the idle pooled instances and again after destroying them, and logs the difference as the cost of the pools.
+	*	The destroyed instances are queued for prewarm. Bound to AbilitySystem.CollisionActorPool.MeasureGC.
+	*/
+	static void MeasureGC(const TArray<FString>& Args, UWorld* World);
+
+	/** Logs the size and demand of every pool. Bound to AbilitySystem.CollisionActorPool.Stats.*/
+	void LogStats() const;
+
+private:
+
+	FCollisionActorClassPool& FindOrAddPool(UClass* Class, bool bLocal);
+
+	/** Moves a free instance into place and wakes it up.*/
+	void ReuseCollisionActor(ABaseCollisionActor* Actor, const FTransform& Transform, AActor* Owner, APawn* Instigator) const;
+
+	/** Updates the demand of the pool after acquisitions and queues prewarm if it runs low.*/
+	void OnAcquired(UClass* Class, FCollisionActorClassPool& Pool, int32 NumAcquired);
+
+	ABaseCollisionActor* SpawnPooledActor(UClass* Class, const FTransform& Transform, bool bLocal) const;
+
+	/** Spawns an instance, non replicated if local. Spawning is deferred so replication is set before the actor begins play.*/
+	ABaseCollisionActor* SpawnCollisionActor(UClass* Class, const FTransform& Transform, AActor* Owner, APawn* Instigator, bool bLocal) const;
+
+	/** Whether or not this machine may pool instances of that kind.*/
+	bool CanPool(bool bLocal) const;
+
+	/** Spawns queued instances until the frame budget runs out.*/
+	void TickPrewarm();
+
+	/** Closes the trim window of pools past the cool-down and destroys idle instances above their demand, a few per frame.*/
+	void TickTrim();
+
+	void QueuePrewarm(UClass* Class, FCollisionActorClassPool& Pool, int32 DesiredSize);
+
+	static void RememberHighWaterMark(UClass* Class, bool bLocal, int32 HighWaterMark);
+
+	/** Replicated instances, authority only.*/
+	UPROPERTY()
+	TMap<TObjectPtr<UClass>, FCollisionActorClassPool> Pools;
+
+	/** Non replicated instances.*/
+	UPROPERTY()
+	TMap<TObjectPtr<UClass>, FCollisionActorClassPool> LocalPools;
+
+	/** Classes with queued prewarm instances, in the order they were requested. The flag tells if the local pool requested them.*/
+	TArray<TPair<TWeakObjectPtr<UClass>, bool>> PrewarmQueue;
+
+	/** First entry of PrewarmQueue that is still pending. Entries before it are done, the queue is reset once all of them are.*/
+	int32 PrewarmQueueHead = 0;
+
+	/** Highest high-water mark seen per class and kind of pool, kept across maps so the next map prewarms for it.*/
+	static TMap<TPair<FSoftClassPath, bool>, int32> RememberedHighWaterMarks;
+};
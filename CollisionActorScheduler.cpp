@@ -0,0 +1,387 @@
+// Copyright 2024 Marchetti S. César A. All Rights Reserved.
+
+#include "AbilitySystem/CollisionActors/CollisionActorScheduler.h"
+#include "AbilitySystem/CollisionActors/BaseCollisionActor.h"
+#include "AbilitySystem/AbilitySystemStats.h"
+#include "Engine/World.h"
+
+DECLARE_CYCLE_STAT(TEXT("Collision Actor Scheduler Tick"), STAT_CollisionActorSchedulerTick, STATGROUP_AbilitySystemPerf);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Collision Actor Scheduled Events"), STAT_CollisionActorScheduledEvents, STATGROUP_AbilitySystemPerf);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Collision Actor Schedules"), STAT_CollisionActorSchedules, STATGROUP_AbilitySystemPerf);
+
+int32 EnableCollisionActorScheduler = 1;
+static FAutoConsoleVariableRef CVarEnableCollisionActorScheduler(TEXT("AbilitySystem.CollisionActorScheduler"), EnableCollisionActorScheduler, TEXT("Drive the lifecycle timers of collision actors (activation, period, expiration and pooling) from a timing wheel instead of the timer manager. Values are 0 or 1, applied to timers set afterwards."), ECVF_Default);
+
+bool UCollisionActorSchedulerSubsystem::IsEnabled()
+{
+	return EnableCollisionActorScheduler != 0;
+}
+
+double UCollisionActorSchedulerSubsystem::FSchedule::GetNextTime() const
+{
+	double NextTime = -1.0;
+	for (const double Time : EventTimes)
+	{
+		if (Time >= 0.0 && (NextTime < 0.0 || Time < NextTime))
+		{
+			NextTime = Time;
+		}
+	}
+	return NextTime;
+}
+
+void UCollisionActorSchedulerSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	for (int32& Head : BucketHeads)
+	{
+		Head = INDEX_NONE;
+	}
+
+	ProcessedTick = FMath::FloorToInt64(GetTime() / SlotSeconds);
+}
+
+void UCollisionActorSchedulerSubsystem::Deinitialize()
+{
+	Schedules.Empty();
+	FreeSchedules.Empty();
+	for (int32& Head : BucketHeads)
+	{
+		Head = INDEX_NONE;
+	}
+	NumScheduled = 0;
+
+	Super::Deinitialize();
+}
+
+TStatId UCollisionActorSchedulerSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCollisionActorSchedulerSubsystem, STATGROUP_Tickables);
+}
+
+double UCollisionActorSchedulerSubsystem::GetTime() const
+{
+	const UWorld* World = GetWorld();
+	return World ? World->GetTimeSeconds() : 0.0;
+}
+
+int64 UCollisionActorSchedulerSubsystem::GetTickForTime(double Time) const
+{
+	//The slot of a tick holds the times after the previous tick, up to its own.
+	return FMath::Max(FMath::CeilToInt64(Time / SlotSeconds), ProcessedTick + 1);
+}
+
+int32 UCollisionActorSchedulerSubsystem::AllocateSchedule(ABaseCollisionActor* Actor)
+{
+	int32 ScheduleIndex;
+	if (!FreeSchedules.IsEmpty())
+	{
+		ScheduleIndex = FreeSchedules.Pop();
+		Schedules[ScheduleIndex] = FSchedule();
+	}
+	else
+	{
+		ScheduleIndex = Schedules.AddDefaulted();
+	}
+
+	FSchedule& Schedule = Schedules[ScheduleIndex];
+	Schedule.Actor = Actor;
+	Schedule.bAllocated = true;
+
+	SET_DWORD_STAT(STAT_CollisionActorSchedules, Schedules.Num() - FreeSchedules.Num());
+	return ScheduleIndex;
+}
+
+void UCollisionActorSchedulerSubsystem::ReleaseSchedule(int32 ScheduleIndex)
+{
+	if (!Schedules.IsValidIndex(ScheduleIndex) || !Schedules[ScheduleIndex].bAllocated)
+	{
+		return;
+	}
+
+	ClearAllEvents(ScheduleIndex);
+
+	FSchedule& Schedule = Schedules[ScheduleIndex];
+	Schedule.Actor.Reset();
+	Schedule.bAllocated = false;
+	FreeSchedules.Add(ScheduleIndex);
+
+	SET_DWORD_STAT(STAT_CollisionActorSchedules, Schedules.Num() - FreeSchedules.Num());
+}
+
+void UCollisionActorSchedulerSubsystem::SetEvent(int32 ScheduleIndex, ECollisionActorScheduleEvent Event, float Delay, float Period)
+{
+	if (!Schedules.IsValidIndex(ScheduleIndex) || !Schedules[ScheduleIndex].bAllocated)
+	{
+		return;
+	}
+
+	//Non positive delays run on the next tick, like SetTimerForNextTick.
+	FSchedule& Schedule = Schedules[ScheduleIndex];
+	Schedule.EventTimes[(int32)Event] = GetTime() + FMath::Max(Delay, UE_KINDA_SMALL_NUMBER);
+	if (Event == ECollisionActorScheduleEvent::Period)
+	{
+		Schedule.Period = Period;
+	}
+
+	Unlink(ScheduleIndex);
+	Link(ScheduleIndex);
+}
+
+void UCollisionActorSchedulerSubsystem::ClearEvent(int32 ScheduleIndex, ECollisionActorScheduleEvent Event)
+{
+	if (!Schedules.IsValidIndex(ScheduleIndex) || Schedules[ScheduleIndex].EventTimes[(int32)Event] < 0.0)
+	{
+		return;
+	}
+
+	//The schedule stays in the slot of the cleared event. It's relinked when the slot is reached, or unlinked if nothing is left.
+	Schedules[ScheduleIndex].EventTimes[(int32)Event] = -1.0;
+}
+
+void UCollisionActorSchedulerSubsystem::ClearAllEvents(int32 ScheduleIndex)
+{
+	if (!Schedules.IsValidIndex(ScheduleIndex))
+	{
+		return;
+	}
+
+	Schedules[ScheduleIndex].ResetEvents();
+	Unlink(ScheduleIndex);
+}
+
+bool UCollisionActorSchedulerSubsystem::IsEventPending(int32 ScheduleIndex, ECollisionActorScheduleEvent Event) const
+{
+	return Schedules.IsValidIndex(ScheduleIndex) && Schedules[ScheduleIndex].EventTimes[(int32)Event] >= 0.0;
+}
+
+void UCollisionActorSchedulerSubsystem::Link(int32 ScheduleIndex)
+{
+	FSchedule& Schedule = Schedules[ScheduleIndex];
+	check(Schedule.Bucket == INDEX_NONE);
+
+	const double NextTime = Schedule.GetNextTime();
+	if (NextTime < 0.0)
+	{
+		return;
+	}
+
+	const int64 CurrentTick = ProcessedTick + 1;
+	Schedule.DueTick = GetTickForTime(NextTime);
+
+	int32 Bucket;
+	if (Schedule.DueTick - CurrentTick < NearSlots)
+	{
+		Bucket = (int32)(Schedule.DueTick % NearSlots);
+	}
+	else if ((Schedule.DueTick / NearSlots) - (CurrentTick / NearSlots) < FarSlots)
+	{
+		Bucket = FarBucketOffset + (int32)((Schedule.DueTick / NearSlots) % FarSlots);
+	}
+	else
+	{
+		Bucket = OverflowBucket;
+	}
+
+	Schedule.Bucket = Bucket;
+	Schedule.Prev = INDEX_NONE;
+	Schedule.Next = BucketHeads[Bucket];
+	if (Schedule.Next != INDEX_NONE)
+	{
+		Schedules[Schedule.Next].Prev = ScheduleIndex;
+	}
+	BucketHeads[Bucket] = ScheduleIndex;
+
+	NumScheduled++;
+}
+
+void UCollisionActorSchedulerSubsystem::Unlink(int32 ScheduleIndex)
+{
+	FSchedule& Schedule = Schedules[ScheduleIndex];
+	if (Schedule.Bucket == INDEX_NONE)
+	{
+		return;
+	}
+
+	if (Schedule.Prev != INDEX_NONE)
+	{
+		Schedules[Schedule.Prev].Next = Schedule.Next;
+	}
+	else
+	{
+		BucketHeads[Schedule.Bucket] = Schedule.Next;
+	}
+
+	if (Schedule.Next != INDEX_NONE)
+	{
+		Schedules[Schedule.Next].Prev = Schedule.Prev;
+	}
+
+	Schedule.Bucket = INDEX_NONE;
+	Schedule.Prev = INDEX_NONE;
+	Schedule.Next = INDEX_NONE;
+
+	NumScheduled--;
+}
+
+void UCollisionActorSchedulerSubsystem::Cascade(int64 Tick)
+{
+	const int64 Block = Tick / NearSlots;
+
+	//Once per far wheel turn, the overflow is linked again to whichever wheel it fits now.
+	if (Block % FarSlots == 0)
+	{
+		int32 ScheduleIndex = BucketHeads[OverflowBucket];
+		while (ScheduleIndex != INDEX_NONE)
+		{
+			const int32 Next = Schedules[ScheduleIndex].Next;
+			Unlink(ScheduleIndex);
+			Link(ScheduleIndex);
+			ScheduleIndex = Next;
+		}
+	}
+
+	//The far slot of this block holds due ticks within the next near wheel turn.
+	const int32 FarBucket = FarBucketOffset + (int32)(Block % FarSlots);
+	int32 ScheduleIndex = BucketHeads[FarBucket];
+	while (ScheduleIndex != INDEX_NONE)
+	{
+		const int32 Next = Schedules[ScheduleIndex].Next;
+		Unlink(ScheduleIndex);
+		Link(ScheduleIndex);
+		ScheduleIndex = Next;
+	}
+}
+
+void UCollisionActorSchedulerSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	const double Now = GetTime();
+	const int64 LastFullTick = FMath::FloorToInt64(Now / SlotSeconds);
+
+	if (NumScheduled == 0)
+	{
+		ProcessedTick = FMath::Max(ProcessedTick, LastFullTick);
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_CollisionActorSchedulerTick);
+
+	//Whole slots up to now. ProcessedTick moves before each slot so schedules linked while dispatching never land in the slot being processed.
+	while (ProcessedTick < LastFullTick)
+	{
+		const int64 Tick = ++ProcessedTick;
+		if (Tick % NearSlots == 0)
+		{
+			Cascade(Tick);
+		}
+		ProcessSlot(Tick, Now);
+	}
+
+	//The slot now falls in may already hold due events. It's checked again next frame, so it isn't cascaded into yet.
+	const int64 PartialTick = ProcessedTick + 1;
+	if (PartialTick % NearSlots != 0)
+	{
+		ProcessSlot(PartialTick, Now);
+	}
+
+	SET_DWORD_STAT(STAT_CollisionActorScheduledEvents, NumScheduled);
+}
+
+void UCollisionActorSchedulerSubsystem::ProcessSlot(int64 Tick, double Now)
+{
+	const int32 Bucket = (int32)(Tick % NearSlots);
+	if (BucketHeads[Bucket] == INDEX_NONE)
+	{
+		return;
+	}
+
+	//Events fired below can link and unlink schedules in this slot, so walk a copy.
+	TArray<int32, TInlineAllocator<64>> SlotSchedules;
+	for (int32 ScheduleIndex = BucketHeads[Bucket]; ScheduleIndex != INDEX_NONE; ScheduleIndex = Schedules[ScheduleIndex].Next)
+	{
+		if (Schedules[ScheduleIndex].DueTick <= Tick)
+		{
+			SlotSchedules.Add(ScheduleIndex);
+		}
+	}
+
+	for (const int32 ScheduleIndex : SlotSchedules)
+	{
+		const FSchedule& Schedule = Schedules[ScheduleIndex];
+		if (Schedule.Bucket != Bucket || Schedule.DueTick > Tick)
+		{
+			//Moved by an earlier event of this slot.
+			continue;
+		}
+
+		const double NextTime = Schedule.GetNextTime();
+		if (NextTime < 0.0 || NextTime <= Now)
+		{
+			Unlink(ScheduleIndex);
+			Dispatch(ScheduleIndex, Now);
+		}
+		else if (GetTickForTime(NextTime) != Tick)
+		{
+			//The event it was linked for was cleared.
+			Unlink(ScheduleIndex);
+			Link(ScheduleIndex);
+		}
+	}
+}
+
+void UCollisionActorSchedulerSubsystem::Dispatch(int32 ScheduleIndex, double Now)
+{
+	//Fire the due events earliest first, a period that fell behind catches up before a later expiration. Schedules may reallocate while firing, so only indices are kept.
+	while (Schedules.IsValidIndex(ScheduleIndex) && Schedules[ScheduleIndex].bAllocated)
+	{
+		FSchedule& Schedule = Schedules[ScheduleIndex];
+
+		int32 DueEvent = INDEX_NONE;
+		for (int32 Event = 0; Event < (int32)ECollisionActorScheduleEvent::Num; Event++)
+		{
+			const double Time = Schedule.EventTimes[Event];
+			if (Time >= 0.0 && Time <= Now && (DueEvent == INDEX_NONE || Time < Schedule.EventTimes[DueEvent]))
+			{
+				DueEvent = Event;
+			}
+		}
+
+		if (DueEvent == INDEX_NONE)
+		{
+			break;
+		}
+
+		ABaseCollisionActor* Actor = Schedule.Actor.Get();
+		if (!Actor)
+		{
+			Schedule.ResetEvents();
+			break;
+		}
+
+		if (DueEvent == (int32)ECollisionActorScheduleEvent::Period && Schedule.Period > 0.f)
+		{
+			Schedule.EventTimes[DueEvent] += Schedule.Period;
+		}
+		else
+		{
+			Schedule.EventTimes[DueEvent] = -1.0;
+		}
+
+		//The event may set, clear or release this schedule. Linking while unlinked is deferred to the end.
+		Actor->OnScheduledEvent((ECollisionActorScheduleEvent)DueEvent);
+
+		//Set from the event, it already linked itself.
+		if (Schedules.IsValidIndex(ScheduleIndex) && Schedules[ScheduleIndex].Bucket != INDEX_NONE)
+		{
+			Unlink(ScheduleIndex);
+		}
+	}
+
+	if (Schedules.IsValidIndex(ScheduleIndex) && Schedules[ScheduleIndex].bAllocated && Schedules[ScheduleIndex].Bucket == INDEX_NONE)
+	{
+		Link(ScheduleIndex);
+	}
+}
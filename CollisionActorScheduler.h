@@ -0,0 +1,141 @@
+// Copyright 2024 Marchetti S. César A. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CollisionActorScheduler.generated.h"
+
+class ABaseCollisionActor;
+
+/** Lifecycle steps of a collision actor driven by the scheduler.*/
+enum class ECollisionActorScheduleEvent : uint8
+{
+	/** BeginActivate, once the server activation time is reached.*/
+	BeginActivate,
+	/** FinishActivate, after the activation delay.*/
+	FinishActivate,
+	/** OnAreaOfEffectPeriod, repeating.*/
+	Period,
+	/** Expire, after the lifespan.*/
+	Expire,
+	/** PoolCollisionActor, after deactivation.*/
+	Pool,
+	Num
+};
+
+/**
+*	Collision actor lifecycle timers on a hierarchical timing wheel, instead of up to five entries per actor in the timer manager heap.
+*	Each actor owns one compact schedule with the next time of every lifecycle event, linked into the wheel slot of the earliest one. Setting, clearing and clearing all the
+*	events of an actor are O(1), so deactivation drops pending work without searching. The near wheel has slots of 1/64 s covering 4 s, the far wheel covers about 4 minutes and
+*	longer schedules wait in an overflow list. Events never fire early, a schedule is checked in the frame its slot starts.
+*	AbilitySystem.CollisionActorScheduler switches collision actors back to the timer manager.
+*/
+UCLASS()
+class CAMERAPLAY_API UCollisionActorSchedulerSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	static bool IsEnabled();
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/** Returns the index of a new, empty schedule for the actor.*/
+	int32 AllocateSchedule(ABaseCollisionActor* Actor);
+
+	/** Frees the schedule, pending events are dropped.*/
+	void ReleaseSchedule(int32 ScheduleIndex);
+
+	/** Runs the event after the delay, replacing a pending one. Period events repeat every Period seconds if it is positive.*/
+	void SetEvent(int32 ScheduleIndex, ECollisionActorScheduleEvent Event, float Delay, float Period = 0.f);
+
+	void ClearEvent(int32 ScheduleIndex, ECollisionActorScheduleEvent Event);
+
+	/** Drops every pending event of the schedule. O(1).*/
+	void ClearAllEvents(int32 ScheduleIndex);
+
+	bool IsEventPending(int32 ScheduleIndex, ECollisionActorScheduleEvent Event) const;
+
+	/** Schedules with at least one pending event.*/
+	int32 GetNumScheduled() const { return NumScheduled; }
+
+private:
+
+	static constexpr double SlotSeconds = 1.0 / 64.0;
+	static constexpr int32 NearSlots = 256;
+	static constexpr int32 FarSlots = 64;
+
+	/** Buckets of the near wheel, then the far wheel, then the overflow list.*/
+	static constexpr int32 FarBucketOffset = NearSlots;
+	static constexpr int32 OverflowBucket = NearSlots + FarSlots;
+	static constexpr int32 NumBuckets = OverflowBucket + 1;
+
+	struct FSchedule
+	{
+		TWeakObjectPtr<ABaseCollisionActor> Actor;
+
+		/** World time of each event, negative if not pending.*/
+		double EventTimes[(int32)ECollisionActorScheduleEvent::Num];
+
+		float Period = 0.f;
+
+		/** Wheel tick the schedule is linked for.*/
+		int64 DueTick = 0;
+
+		/** Intrusive list of the bucket, INDEX_NONE when unlinked.*/
+		int32 Bucket = INDEX_NONE;
+		int32 Prev = INDEX_NONE;
+		int32 Next = INDEX_NONE;
+
+		bool bAllocated = false;
+
+		FSchedule()
+		{
+			ResetEvents();
+		}
+
+		void ResetEvents()
+		{
+			for (double& Time : EventTimes)
+			{
+				Time = -1.0;
+			}
+		}
+
+		/** Earliest pending event time, negative if none.*/
+		double GetNextTime() const;
+	};
+
+	double GetTime() const;
+
+	int64 GetTickForTime(double Time) const;
+
+	/** Links the schedule to the bucket of its next event, or leaves it unlinked if nothing is pending.*/
+	void Link(int32 ScheduleIndex);
+	void Unlink(int32 ScheduleIndex);
+
+	/** Moves the far wheel slot that starts at the tick, and the overflow list on wrap, into the near wheel.*/
+	void Cascade(int64 Tick);
+
+	/** Fires the due events of every schedule in the near wheel slot of the tick.*/
+	void ProcessSlot(int64 Tick, double Now);
+
+	/** Fires the due events of a schedule in time order, then links it again.*/
+	void Dispatch(int32 ScheduleIndex, double Now);
+
+	TArray<FSchedule> Schedules;
+	TArray<int32> FreeSchedules;
+
+	/** First schedule of each bucket.*/
+	int32 BucketHeads[NumBuckets];
+
+	/** Last tick whose slot was processed.*/
+	int64 ProcessedTick = 0;
+
+	int32 NumScheduled = 0;
+};
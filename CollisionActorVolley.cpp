@@ -0,0 +1,56 @@
+// Copyright 2024 Marchetti S. César A. All Rights Reserved.
+
+#include "AbilitySystem/CollisionActors/CollisionActorVolley.h"
+#include "AbilitySystem/CollisionActors/BaseCollisionActor.h"
+
+FCollisionActorIndividualData FCollisionActorVolleyItem::GetInstanceIndividualData(int32 InstanceIndex) const
+{
+	FCollisionActorIndividualData InstanceData = IndividualData;
+	if (Instances.IsValidIndex(InstanceIndex))
+	{
+		InstanceData.SpawnIndex = Instances[InstanceIndex].SpawnIndex;
+	}
+	return InstanceData;
+}
+
+void FCollisionActorVolleyItem::PostReplicatedAdd(const FCollisionActorVolleyArray& InArraySerializer)
+{
+	InArraySerializer.OnVolleyReplicated.Broadcast(*this);
+}
+
+void FCollisionActorVolleyItem::PostReplicatedChange(const FCollisionActorVolleyArray& InArraySerializer)
+{
+	//Also called when the actor of an instance resolves after the item was added.
+	InArraySerializer.OnVolleyReplicated.Broadcast(*this);
+}
+
+int32 FCollisionActorVolleyArray::AddVolley(const FCollisionActorIndividualData& InIndividualData, TArray<FCollisionActorVolleyInstance>&& InInstances)
+{
+	FCollisionActorVolleyItem& Item = Items.AddDefaulted_GetRef();
+	Item.VolleyID = NextVolleyID++;
+	Item.IndividualData = InIndividualData;
+	Item.Instances = MoveTemp(InInstances);
+	Item.NumActive = Item.Instances.Num();
+	MarkItemDirty(Item);
+	return Item.VolleyID;
+}
+
+const FCollisionActorVolleyItem* FCollisionActorVolleyArray::FindVolley(int32 VolleyID) const
+{
+	return Items.FindByPredicate([VolleyID](const FCollisionActorVolleyItem& Item) { return Item.VolleyID == VolleyID; });
+}
+
+void FCollisionActorVolleyArray::ReleaseInstance(int32 VolleyID)
+{
+	const int32 Index = Items.IndexOfByPredicate([VolleyID](const FCollisionActorVolleyItem& Item) { return Item.VolleyID == VolleyID; });
+	if (Index == INDEX_NONE)
+	{
+		return;
+	}
+
+	if (--Items[Index].NumActive <= 0)
+	{
+		Items.RemoveAtSwap(Index);
+		MarkArrayDirty();
+	}
+}
@@ -0,0 +1,97 @@
+// Copyright 2024 Marchetti S. César A. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Net/Serialization/FastArraySerializer.h"
+#include "AbilitySystem/CollisionActors/CollisionActorTypes.h"
+#include "CollisionActorVolley.generated.h"
+
+class ABaseCollisionActor;
+struct FCollisionActorVolleyArray;
+
+/** Per instance part of a volley.*/
+USTRUCT()
+struct CAMERAPLAY_API FCollisionActorVolleyInstance
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TObjectPtr<ABaseCollisionActor> Actor;
+
+	UPROPERTY()
+	int32 SpawnIndex = 0;
+};
+
+/**
+*	Collision actors spawned together by one activation, replicated as a single item instead of one individual data item per actor.
+*	The individual data is common to every instance, except for the spawn index.
+*/
+USTRUCT()
+struct CAMERAPLAY_API FCollisionActorVolleyItem : public FFastArraySerializerItem
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	int32 VolleyID = INDEX_NONE;
+
+	UPROPERTY()
+	FCollisionActorIndividualData IndividualData;
+
+	UPROPERTY()
+	TArray<FCollisionActorVolleyInstance> Instances;
+
+	/** Instances that weren't pooled yet. Server only.*/
+	UPROPERTY(NotReplicated)
+	int32 NumActive = 0;
+
+	/** Instances already preactivated, by instance index. Instances whose actor resolves late are preactivated when it does. Client only.*/
+	TBitArray<> PreactivatedInstances;
+
+	/** Individual data of one instance of the volley.*/
+	FCollisionActorIndividualData GetInstanceIndividualData(int32 InstanceIndex) const;
+
+	void PostReplicatedAdd(const FCollisionActorVolleyArray& InArraySerializer);
+	void PostReplicatedChange(const FCollisionActorVolleyArray& InArraySerializer);
+};
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnCollisionActorVolleyReplicated, FCollisionActorVolleyItem&);
+
+/** Replicated volleys of an ability system component.*/
+USTRUCT()
+struct CAMERAPLAY_API FCollisionActorVolleyArray : public FFastArraySerializer
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<FCollisionActorVolleyItem> Items;
+
+	/** Broadcast on clients when a volley replicates and again when the actors of its instances resolve, to preactivate them like individually replicated data.*/
+	FOnCollisionActorVolleyReplicated OnVolleyReplicated;
+
+	/** Adds the volley and returns its ID.*/
+	int32 AddVolley(const FCollisionActorIndividualData& InIndividualData, TArray<FCollisionActorVolleyInstance>&& InInstances);
+
+	const FCollisionActorVolleyItem* FindVolley(int32 VolleyID) const;
+
+	/** Called when an instance of the volley is pooled. The item is removed with its last instance.*/
+	void ReleaseInstance(int32 VolleyID);
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FCollisionActorVolleyItem, FCollisionActorVolleyArray>(Items, DeltaParms, *this);
+	}
+
+private:
+
+	int32 NextVolleyID = 0;
+};
+
+template<>
+struct TStructOpsTypeTraits<FCollisionActorVolleyArray> : public TStructOpsTypeTraitsBase2<FCollisionActorVolleyArray>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
+};
@@ -0,0 +1,121 @@
+// Copyright 2024 Marchetti S. César A. All Rights Reserved.
+
+#include "AbilitySystem/ModifiedAbilityCache.h"
+#include "Abilities/GameplayAbility.h"
+#include "AbilitySystem/BPL_AbilitySystem.h"
+#include "AbilitySystem/GameplayData/GameplayDataAbilityModifier.h"
+#include "AbilitySystem/AbilitySystemStats.h"
+#include "UObject/UObjectGlobals.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Modified Ability Cache Hits"), STAT_ModifiedAbilityCacheHits, STATGROUP_AbilitySystemPerf);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Modified Ability Cache Misses"), STAT_ModifiedAbilityCacheMisses, STATGROUP_AbilitySystemPerf);
+
+int32 ModifiedAbilityCacheEnabled = 1;
+static FAutoConsoleVariableRef CVarModifiedAbilityCacheEnabled(TEXT("AbilitySystem.ModifiedAbilityCache"), ModifiedAbilityCacheEnabled, TEXT("Memoize modified abilities by ability class, level and modifier set. Values are 0 or 1."), ECVF_Default);
+
+static FAutoConsoleCommand ModifiedAbilityCacheStatsCommand(TEXT("AbilitySystem.ModifiedAbilityCache.Stats"), TEXT("Logs the modified ability cache hit rate."), FConsoleCommandDelegate::CreateStatic(&FModifiedAbilityCache::LogStats));
+
+TMap<FModifiedAbilityCache::FKey, TSharedRef<const FModifiedAbility>> FModifiedAbilityCache::Entries;
+uint64 FModifiedAbilityCache::TotalHits = 0;
+uint64 FModifiedAbilityCache::TotalMisses = 0;
+
+TSharedRef<const FModifiedAbility> FModifiedAbilityCache::Get(TSubclassOf<UGameplayAbility> AbilityClass, int32 Level, const FGameplayTagContainer& ModifierTags)
+{
+	TArray<FGameplayTag, TInlineAllocator<8>> Tags;
+	for (const FGameplayTag& Tag : ModifierTags)
+	{
+		Tags.Add(Tag);
+	}
+	return Get(AbilityClass, Level, Tags);
+}
+
+TSharedRef<const FModifiedAbility> FModifiedAbilityCache::Get(TSubclassOf<UGameplayAbility> AbilityClass, int32 Level, TArrayView<const FGameplayTag> ModifierTags)
+{
+	FKey Key;
+	Key.AbilityClass = AbilityClass.Get();
+	Key.Level = Level;
+	Key.ModifierTags.Append(ModifierTags.GetData(), ModifierTags.Num());
+
+	if (!ModifiedAbilityCacheEnabled || !IsInGameThread())
+	{
+		return Build(AbilityClass, Level, Key.ModifierTags);
+	}
+
+	BindInvalidation();
+
+	Key.Hash = HashCombine(GetTypeHash(Key.AbilityClass), ::GetTypeHash(Level));
+	for (const FGameplayTag& Tag : Key.ModifierTags)
+	{
+		Key.Hash = HashCombine(Key.Hash, GetTypeHash(Tag));
+	}
+
+	if (const TSharedRef<const FModifiedAbility>* Entry = Entries.Find(Key))
+	{
+		TotalHits++;
+		INC_DWORD_STAT(STAT_ModifiedAbilityCacheHits);
+		return *Entry;
+	}
+
+	TotalMisses++;
+	INC_DWORD_STAT(STAT_ModifiedAbilityCacheMisses);
+
+	TSharedRef<const FModifiedAbility> NewEntry = Build(AbilityClass, Level, Key.ModifierTags);
+	Entries.Add(MoveTemp(Key), NewEntry);
+	return NewEntry;
+}
+
+TSharedRef<FModifiedAbility> FModifiedAbilityCache::Build(TSubclassOf<UGameplayAbility> AbilityClass, int32 Level, TArrayView<const FGameplayTag> ModifierTags)
+{
+	TSharedRef<FModifiedAbility> ModifiedAbility = MakeShared<FModifiedAbility>(AbilityClass, Level);
+	for (const FGameplayTag& ModifierTag : ModifierTags)
+	{
+		ModifiedAbility->ApplyModifier(UBPL_AbilitySystem::FindAbilityModifier(ModifierTag));
+	}
+	return ModifiedAbility;
+}
+
+bool FModifiedAbilityCache::IsEnabled()
+{
+	return ModifiedAbilityCacheEnabled != 0;
+}
+
+void FModifiedAbilityCache::Invalidate()
+{
+	Entries.Reset();
+}
+
+void FModifiedAbilityCache::BindInvalidation()
+{
+	static bool bBound = false;
+	if (bBound)
+	{
+		return;
+	}
+	bBound = true;
+
+	//Modifier data assets are the only input that can change at runtime, and only when they are reloaded.
+	FCoreUObjectDelegates::OnPackageReloaded.AddLambda([](EPackageReloadPhase Phase, FPackageReloadedEvent* Event)
+	{
+		if (Phase == EPackageReloadPhase::PostBatchPostGC)
+		{
+			Invalidate();
+		}
+	});
+
+#if WITH_EDITOR
+	FCoreUObjectDelegates::OnObjectPropertyChanged.AddLambda([](UObject* Object, FPropertyChangedEvent& Event)
+	{
+		if (Cast<UGameplayDataAbilityModifier>(Object))
+		{
+			Invalidate();
+		}
+	});
+#endif
+}
+
+void FModifiedAbilityCache::LogStats()
+{
+	const uint64 Lookups = TotalHits + TotalMisses;
+	UE_LOG(LogTemp, Log, TEXT("Modified ability cache: %llu hits, %llu misses (%.1f%% hit rate). %d modified abilities."),
+		TotalHits, TotalMisses, Lookups ? 100.0 * TotalHits / Lookups : 0.0, Entries.Num());
+}
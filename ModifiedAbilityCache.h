@@ -0,0 +1,69 @@
+// Copyright 2024 Marchetti S. César A. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+#include "UObject/ObjectKey.h"
+#include "AbilitySystem/AbilityTypes.h"
+
+class UGameplayAbility;
+
+/**
+*	Process wide memo of FModifiedAbility, keyed by ability class, level and modifier tags.
+*	Modifiers are applied in the order the tags are given, like applying them one by one does. Modifiers don't have to commute, so the key keeps that order
+*	and the same tags in another order are another entry. Callers pass replicated containers or their own pick order, which are the same on every machine.
+*	Entries are immutable and shared. The cache is only flushed when modifier data assets are reloaded or edited.
+*	Game thread only.
+*/
+class CAMERAPLAY_API FModifiedAbilityCache
+{
+public:
+
+	/** Modified ability of the class at the level with every modifier applied, in the order of the tags.*/
+	static TSharedRef<const FModifiedAbility> Get(TSubclassOf<UGameplayAbility> AbilityClass, int32 Level, const FGameplayTagContainer& ModifierTags);
+	static TSharedRef<const FModifiedAbility> Get(TSubclassOf<UGameplayAbility> AbilityClass, int32 Level, TArrayView<const FGameplayTag> ModifierTags);
+
+	/** Whether or not modified abilities are being cached.*/
+	static bool IsEnabled();
+
+	/** Drops every entry. Bound to modifier data asset reloads.*/
+	static void Invalidate();
+
+	/** Logs hit rate and size. Bound to AbilitySystem.ModifiedAbilityCache.Stats.*/
+	static void LogStats();
+
+private:
+
+	struct FKey
+	{
+		TObjectKey<UClass> AbilityClass;
+		int32 Level = 0;
+
+		/** In application order.*/
+		TArray<FGameplayTag, TInlineAllocator<8>> ModifierTags;
+
+		/** Computed once from the tags.*/
+		uint32 Hash = 0;
+
+		bool operator==(const FKey& Other) const
+		{
+			return Hash == Other.Hash && Level == Other.Level && AbilityClass == Other.AbilityClass && ModifierTags == Other.ModifierTags;
+		}
+
+		friend uint32 GetTypeHash(const FKey& Key)
+		{
+			return Key.Hash;
+		}
+	};
+
+	static TSharedRef<FModifiedAbility> Build(TSubclassOf<UGameplayAbility> AbilityClass, int32 Level, TArrayView<const FGameplayTag> ModifierTags);
+
+	/** Binds the invalidation to asset reloads the first time the cache is used.*/
+	static void BindInvalidation();
+
+	static TMap<FKey, TSharedRef<const FModifiedAbility>> Entries;
+
+	static uint64 TotalHits;
+	static uint64 TotalMisses;
+};
@@ -0,0 +1,131 @@
+// Copyright 2024 Marchetti S. César A. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineTypes.h"
+#include "CollisionShape.h"
+#include "Abilities/GameplayAbilityTargetDataFilter.h"
+
+struct FOverlapEventSnapshot;
+struct FOverlapEventEvaluation;
+
+/** A physics overlap query: shape, location, rotation and filters. Only identical queries share their results.*/
+struct FOverlapQueryParams
+{
+	FCollisionShape Shape;
+	FVector Location = FVector::ZeroVector;
+	FQuat Rotation = FQuat::Identity;
+	const UClass* ClassFilter = nullptr;
+
+	/** Bit per EObjectTypeQuery.*/
+	uint64 ObjectTypes = 0;
+
+	/** Whether or not this describes an actual query. Unknown shapes leave the line shape of a default FCollisionShape.*/
+	bool IsValid() const
+	{
+		return !Shape.IsLine();
+	}
+
+	bool operator==(const FOverlapQueryParams& Other) const
+	{
+		return Shape.ShapeType == Other.Shape.ShapeType && Shape.GetExtent() == Other.Shape.GetExtent() && Location == Other.Location && Rotation == Other.Rotation
+			&& ClassFilter == Other.ClassFilter && ObjectTypes == Other.ObjectTypes;
+	}
+
+	friend uint32 GetTypeHash(const FOverlapQueryParams& Query)
+	{
+		uint32 Hash = HashCombine(::GetTypeHash((uint8)Query.Shape.ShapeType), GetTypeHash(Query.Shape.GetExtent()));
+		Hash = HashCombine(Hash, GetTypeHash(Query.Location));
+		Hash = HashCombine(Hash, GetTypeHash(FVector4(Query.Rotation.X, Query.Rotation.Y, Query.Rotation.Z, Query.Rotation.W)));
+		Hash = HashCombine(Hash, PointerHash(Query.ClassFilter));
+		return HashCombine(Hash, ::GetTypeHash(Query.ObjectTypes));
+	}
+};
+
+/** Shape query and target filters of an overlap event, specialized per shape and per enabled check. See OverlapEventKernels.h.*/
+using FOverlapEventKernel = void(*)(const UObject* WorldContextObject, const FOverlapEventSnapshot& Snapshot, FOverlapEventEvaluation& Evaluation);
+
+/**
+*	Read-only phase of an overlap event.
+*	Filled on the game thread by UBaseOverlapAbility::PrepareOverlapEvaluation and completed by UBaseOverlapAbility::EvaluateOverlapEvent, which is safe to run off the game thread.
+*	Results are filtered and applied on the game thread by UBaseOverlapAbility::ApplyOverlapEvaluation.
+*/
+struct FOverlapEventEvaluation
+{
+	/** Avatar at the moment the event was prepared. Used as the ignored actor for line of sight checks, which run on the game thread.*/
+	AActor* Avatar = nullptr;
+
+	/** Scaled shape extent for this snapshot.*/
+	FVector Extent = FVector::ZeroVector;
+
+	/** Rotated yaw for this snapshot.*/
+	float Yaw = 0.f;
+
+	/** Inner radius. Targets closer than this to the center are discarded.*/
+	float MinDistance = 0.f;
+
+	/** Half angle of the cone. Values of 180 or more disable the check.*/
+	float AngleDeviation = 180.f;
+
+	/** Ability filter, built on the game thread since it can depend on the ability modified tags. Only used on the game thread, see OverlapEventKernels::FilterTargets.*/
+	FGameplayTargetDataFilterHandle Filter;
+
+	/** Kernel selected for this snapshot geometry.*/
+	FOverlapEventKernel Kernel = nullptr;
+
+	/** Sphere containing the shape, used to merge the queries of co-located events. Zero radius for shapes that never merge, see OverlapEventKernels::CanMergeQuery.*/
+	FSphere QueryBounds = FSphere(ForceInit);
+
+	/** Candidates of a merged or identical query shared with other events. When set, the kernel skips its own query and tests these against its shape.*/
+	const TArray<AActor*>* SharedCandidates = nullptr;
+
+	/** Query the kernel runs for its candidates. The overlap event subsystem runs it once for every event of the batch with the same query. See OverlapEventKernels::GetCandidateQuery.*/
+	FOverlapQueryParams CandidateQuery;
+
+	/** Actors returned by the shape query, before any filter. Used by the kernel stats and benchmark.*/
+	int32 NumCandidates = 0;
+
+	/** Targets that passed the shape query and the geometric checks. The filter, line of sight and ignored actors are applied to them on the game thread.*/
+	TArray<AActor*> Targets;
+};
+
+/** Geometry of an overlap event at a given elapsed time. Values already include the snapshotted area multiplier.*/
+struct FOverlapEventGeometryStep
+{
+	/** Time since the snapshot initial event time.*/
+	float ElapsedTime = 0.f;
+
+	FVector Extent = FVector::ZeroVector;
+
+	float InnerRadius = 0.f;
+
+	float HalfAngle = 180.f;
+
+	/** Yaw added to the snapshot yaw by the rotation rate.*/
+	float YawOffset = 0.f;
+
+	/** Kernel for the shape and the checks this step needs.*/
+	FOverlapEventKernel Kernel = nullptr;
+};
+
+/**
+*	Geometry table for an overlap event. Built once in UBaseOverlapAbility::ProcessOverlapEvent, every snapshot of the event indexes into it with GeometryIndex.
+*	Everything here depends only on the elapsed time and the snapshotted attributes, so it doesn't need to be evaluated per snapshot.
+*/
+struct FOverlapEventGeometry
+{
+	/** One entry per distinct elapsed time of the event snapshots.*/
+	TArray<FOverlapEventGeometryStep> Steps;
+
+	/** Geometry at the start of the event. Used by the activation delay cues.*/
+	FOverlapEventGeometryStep Initial;
+
+	/** Extent at the end of the lifetime, sent to the gameplay cues.*/
+	FVector FinalExtent = FVector::ZeroVector;
+
+	const FOverlapEventGeometryStep* GetStep(int32 Index) const
+	{
+		return Steps.IsValidIndex(Index) ? &Steps[Index] : nullptr;
+	}
+};
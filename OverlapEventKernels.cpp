@@ -0,0 +1,478 @@
+// Copyright 2024 Marchetti S. César A. All Rights Reserved.
+
+#include "AbilitySystem/Abilities/OverlapEventKernels.h"
+#include "Kismet/KismetSystemLibrary.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "Engine/World.h"
+#include "Engine/Engine.h"
+#include "Engine/OverlapResult.h"
+#include "AbilitySystem/BPL_AbilitySystem.h"
+#include "AbilitySystem/Targeting/TargetFunctionLibrary.h"
+#include "AbilitySystem/AbilitySystemStats.h"
+
+DECLARE_CYCLE_STAT(TEXT("Overlap Kernel"), STAT_OverlapKernel, STATGROUP_AbilitySystemPerf);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Overlap Kernel Candidates"), STAT_OverlapKernelCandidates, STATGROUP_AbilitySystemPerf);
+
+namespace OverlapEventKernels
+{
+	/** Shapes tested analytically against the target collision cylinder after a bounding query, instead of emulated with a sphere query and the distance and angle filters.*/
+	template<EOverlapAbilityShape InShape>
+	constexpr bool IsAnalyticShape()
+	{
+		return InShape == EOverlapAbilityShape::Cone || InShape == EOverlapAbilityShape::Ring || InShape == EOverlapAbilityShape::Sector;
+	}
+
+	/**
+	*	Annulus, sector or cone around the snapshot location, facing the evaluation yaw.
+	*	Ring and Sector are flat, limited vertically by the Z extent (the X extent when Z is 0). Cone is measured in 3D.
+	*	Targets pass if their collision cylinder touches the shape, not only their center.
+	*/
+	struct FAnalyticShape
+	{
+		FVector Origin;
+		FVector Direction;
+		float OuterRadius;
+		float InnerRadius;
+		float HalfHeight;
+		float CosHalfAngle;
+		float SinHalfAngle;
+
+		FAnalyticShape(const FOverlapEventSnapshot& Snapshot, const FOverlapEventEvaluation& Evaluation)
+		{
+			const float HalfAngle = FMath::DegreesToRadians(FMath::Clamp(Evaluation.AngleDeviation, 0.f, 180.f));
+			Origin = Snapshot.Location;
+			Direction = FRotator(0.f, Evaluation.Yaw, 0.f).Vector();
+			OuterRadius = Evaluation.Extent.X;
+			InnerRadius = Evaluation.MinDistance;
+			HalfHeight = Evaluation.Extent.Z > 0.f ? Evaluation.Extent.Z : Evaluation.Extent.X;
+			FMath::SinCos(&SinHalfAngle, &CosHalfAngle, HalfAngle);
+		}
+
+		template<bool b3D, bool bMinDistance, bool bAngleDeviation>
+		bool Overlaps(const AActor* Target) const
+		{
+			float TargetRadius = 0.f;
+			float TargetHalfHeight = 0.f;
+			Target->GetSimpleCollisionCylinder(TargetRadius, TargetHalfHeight);
+
+			const FVector Delta = Target->GetActorLocation() - Origin;
+			float Forward = 0.f;
+			float Lateral = 0.f;
+			float Distance = 0.f;
+
+			if constexpr (b3D)
+			{
+				Forward = Delta | Direction;
+				Distance = Delta.Size();
+				Lateral = FMath::Sqrt(FMath::Max(0.f, Distance * Distance - Forward * Forward));
+			}
+			else
+			{
+				if (FMath::Abs(Delta.Z) > HalfHeight + TargetHalfHeight)
+				{
+					return false;
+				}
+
+				Forward = Delta.X * Direction.X + Delta.Y * Direction.Y;
+				Lateral = FMath::Abs(Delta.X * Direction.Y - Delta.Y * Direction.X);
+				Distance = Delta.Size2D();
+			}
+
+			if (Distance > OuterRadius + TargetRadius)
+			{
+				return false;
+			}
+
+			if constexpr (bMinDistance)
+			{
+				if (Distance < InnerRadius - TargetRadius)
+				{
+					return false;
+				}
+			}
+
+			if constexpr (bAngleDeviation)
+			{
+				//Negative when the center is outside the half angle. The target still overlaps if its radius reaches the edge.
+				const float Side = Forward * SinHalfAngle - Lateral * CosHalfAngle;
+				if (Side < 0.f)
+				{
+					const float AlongEdge = Forward * CosHalfAngle + Lateral * SinHalfAngle;
+					const float EdgeDistance = AlongEdge > 0.f ? -Side : Distance;
+					if (EdgeDistance > TargetRadius)
+					{
+						return false;
+					}
+				}
+			}
+
+			return true;
+		}
+	};
+
+	/** Pawns overlapping a capsule, with the object types of every kernel query.*/
+	static void CapsuleOverlapActors(const UObject* WorldContextObject, const FVector& Location, const FQuat& Rotation, float Radius, float HalfHeight, TArray<AActor*>& OutActors)
+	{
+		UWorld* const World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull);
+		if (!World)
+		{
+			return;
+		}
+
+		TArray<FOverlapResult> Overlaps;
+		World->OverlapMultiByObjectType(Overlaps, Location, Rotation, FCollisionObjectQueryParams(UEngineTypes::ConvertToCollisionChannel(EObjectTypeQuery::ObjectTypeQuery3)), FCollisionShape::MakeCapsule(Radius, HalfHeight), FCollisionQueryParams(SCENE_QUERY_STAT(OverlapKernelCapsule), false));
+
+		for (const FOverlapResult& Overlap : Overlaps)
+		{
+			AActor* const Actor = Overlap.GetActor();
+			if (Actor && Actor->IsA<APawn>())
+			{
+				OutActors.AddUnique(Actor);
+			}
+		}
+	}
+
+	/**
+	*	Smallest query that contains the shape. Narrow cones and sectors use a box around the wedge, flat rings a box around the disc.
+	*	Capsules lie along the yaw, their X extent is the half length, caps included, and the Y extent the radius.
+	*/
+	static FOverlapQueryParams GetCandidateQuery(EOverlapAbilityShape InShape, bool bMinDistance, bool bAngleDeviation, const FOverlapEventSnapshot& Snapshot, const FOverlapEventEvaluation& Evaluation)
+	{
+		FOverlapQueryParams Query;
+		Query.ClassFilter = APawn::StaticClass();
+		Query.ObjectTypes = 1ull << static_cast<uint8>(EObjectTypeQuery::ObjectTypeQuery3);
+		Query.Location = Snapshot.Location;
+		Query.Rotation = FRotator(0.f, Evaluation.Yaw, 0.f).Quaternion();
+
+		switch (InShape)
+		{
+		case EOverlapAbilityShape::Sphere:
+			Query.Shape = FCollisionShape::MakeSphere(Evaluation.Extent.X);
+			Query.Rotation = FQuat::Identity;
+			break;
+		case EOverlapAbilityShape::Box:
+			Query.Shape = FCollisionShape::MakeBox(Evaluation.Extent);
+			break;
+		case EOverlapAbilityShape::Capsule:
+			Query.Shape = FCollisionShape::MakeCapsule(Evaluation.Extent.Y, FMath::Max(Evaluation.Extent.X, Evaluation.Extent.Y));
+			Query.Rotation = FRotationMatrix::MakeFromZ(FRotator(0.f, Evaluation.Yaw, 0.f).Vector()).ToQuat();
+			break;
+		case EOverlapAbilityShape::Cone:
+		case EOverlapAbilityShape::Ring:
+		case EOverlapAbilityShape::Sector:
+		{
+			const FAnalyticShape Shape(Snapshot, Evaluation);
+			const float VerticalExtent = InShape == EOverlapAbilityShape::Cone ? Shape.OuterRadius : Shape.HalfHeight;
+
+			if (bAngleDeviation && Shape.CosHalfAngle > 0.f)
+			{
+				const float Near = bMinDistance ? Shape.InnerRadius * Shape.CosHalfAngle : 0.f;
+				const float Far = Shape.OuterRadius;
+				const float Side = Shape.OuterRadius * Shape.SinHalfAngle;
+				Query.Location = Shape.Origin + Shape.Direction * ((Near + Far) * .5f);
+				Query.Shape = FCollisionShape::MakeBox(FVector((Far - Near) * .5f, Side, InShape == EOverlapAbilityShape::Cone ? Side : VerticalExtent));
+			}
+			else if (VerticalExtent < Shape.OuterRadius)
+			{
+				Query.Shape = FCollisionShape::MakeBox(FVector(Shape.OuterRadius, Shape.OuterRadius, VerticalExtent));
+			}
+			else
+			{
+				Query.Shape = FCollisionShape::MakeSphere(Shape.OuterRadius);
+				Query.Rotation = FQuat::Identity;
+			}
+			break;
+		}
+		default:
+			break;
+		}
+
+		return Query;
+	}
+
+	void QueryCandidates(const UObject* WorldContextObject, const FOverlapQueryParams& Query, TArray<AActor*>& OutActors)
+	{
+		const TArray<AActor*, FDefaultAllocator> IgnoreActors;
+		const TArray<TEnumAsByte<EObjectTypeQuery>> ObjectTypes{ EObjectTypeQuery::ObjectTypeQuery3 };
+
+		if (Query.Shape.IsSphere())
+		{
+			UKismetSystemLibrary::SphereOverlapActors(WorldContextObject, Query.Location, Query.Shape.GetSphereRadius(), ObjectTypes, APawn::StaticClass(), IgnoreActors, OutActors);
+		}
+		else if (Query.Shape.IsBox())
+		{
+			UBPL_AbilitySystem::RotatedBoxOverlapActors(WorldContextObject, Query.Location, Query.Rotation.Rotator(), Query.Shape.GetBox(), ObjectTypes, APawn::StaticClass(), IgnoreActors, OutActors);
+		}
+		else if (Query.Shape.IsCapsule())
+		{
+			CapsuleOverlapActors(WorldContextObject, Query.Location, Query.Rotation, Query.Shape.GetCapsuleRadius(), Query.Shape.GetCapsuleHalfHeight(), OutActors);
+		}
+	}
+
+	template<EOverlapAbilityShape InShape, bool bMinDistance, bool bAngleDeviation>
+	void Run(const UObject* WorldContextObject, const FOverlapEventSnapshot& Snapshot, FOverlapEventEvaluation& Evaluation)
+	{
+		SCOPE_CYCLE_COUNTER(STAT_OverlapKernel);
+
+		TArray<AActor*, FDefaultAllocator>& Targets = Evaluation.Targets;
+		//Analytic shapes can be given the candidates of a merged query, see CanMergeQuery, the others only those of an identical query. The test below is the same either way.
+		if (Evaluation.SharedCandidates)
+		{
+			Targets = *Evaluation.SharedCandidates;
+		}
+		else
+		{
+			QueryCandidates(WorldContextObject, GetCandidateQuery(InShape, bMinDistance, bAngleDeviation, Snapshot, Evaluation), Targets);
+		}
+
+		Evaluation.NumCandidates = Targets.Num();
+		INC_DWORD_STAT_BY(STAT_OverlapKernelCandidates, Targets.Num());
+
+		if (Targets.IsEmpty())
+		{
+			return;
+		}
+
+		//Only geometry here. The filter and line of sight run on the game thread, see FilterTargets.
+		if constexpr (IsAnalyticShape<InShape>())
+		{
+			const FAnalyticShape Shape(Snapshot, Evaluation);
+			Targets.RemoveAll([&Shape](AActor* it)
+			{
+				return !Shape.Overlaps<InShape == EOverlapAbilityShape::Cone, bMinDistance, bAngleDeviation>(it);
+			});
+		}
+		else if constexpr (bMinDistance || bAngleDeviation)
+		{
+			Targets.RemoveAll([&Snapshot, &Evaluation](AActor* it)
+			{
+				if constexpr (bMinDistance)
+				{
+					if (!UTargetFunctionLibrary::IsTargetInMinimalDistance(Snapshot.Location, it, Evaluation.MinDistance))
+					{
+						return true;
+					}
+				}
+
+				if constexpr (bAngleDeviation)
+				{
+					if (!UTargetFunctionLibrary::IsTargetBetweenAngleDeviation(Snapshot.Location, it, Evaluation.Yaw, Evaluation.AngleDeviation))
+					{
+						return true;
+					}
+				}
+
+				return false;
+			});
+		}
+	}
+
+	void RunEmpty(const UObject* WorldContextObject, const FOverlapEventSnapshot& Snapshot, FOverlapEventEvaluation& Evaluation)
+	{
+		Evaluation.Targets.Reset();
+	}
+
+	template<EOverlapAbilityShape InShape>
+	FOverlapEventKernel SelectForShape(bool bMinDistance, bool bAngleDeviation)
+	{
+		static const FOverlapEventKernel Kernels[4] =
+		{
+			&Run<InShape, false, false>,
+			&Run<InShape, false, true>,
+			&Run<InShape, true, false>,
+			&Run<InShape, true, true>
+		};
+
+		return Kernels[(bMinDistance ? 2 : 0) | (bAngleDeviation ? 1 : 0)];
+	}
+
+	FOverlapEventKernel Select(EOverlapAbilityShape Shape, bool bMinDistance, bool bAngleDeviation)
+	{
+		switch (Shape)
+		{
+		case EOverlapAbilityShape::Sphere:
+			return SelectForShape<EOverlapAbilityShape::Sphere>(bMinDistance, bAngleDeviation);
+		case EOverlapAbilityShape::Box:
+			return SelectForShape<EOverlapAbilityShape::Box>(bMinDistance, bAngleDeviation);
+		case EOverlapAbilityShape::Capsule:
+			return SelectForShape<EOverlapAbilityShape::Capsule>(bMinDistance, bAngleDeviation);
+		case EOverlapAbilityShape::Cone:
+			return SelectForShape<EOverlapAbilityShape::Cone>(bMinDistance, bAngleDeviation);
+		case EOverlapAbilityShape::Ring:
+			return SelectForShape<EOverlapAbilityShape::Ring>(bMinDistance, false);
+		case EOverlapAbilityShape::Sector:
+			return SelectForShape<EOverlapAbilityShape::Sector>(bMinDistance, bAngleDeviation);
+		default:
+			return &RunEmpty;
+		}
+	}
+
+	FOverlapEventKernel Select(EOverlapAbilityShape Shape, const FOverlapEventEvaluation& Evaluation)
+	{
+		return Select(Shape, Evaluation.MinDistance > 0.f, Evaluation.AngleDeviation < 180.f);
+	}
+
+	void FilterTargets(const UObject* WorldContextObject, const FOverlapEventSnapshot& Snapshot, bool bLineOfSight, FOverlapEventEvaluation& Evaluation)
+	{
+		check(IsInGameThread());
+
+		//Line of sight is a trace per target, it goes last.
+		Evaluation.Targets.RemoveAll([WorldContextObject, &Snapshot, &Evaluation, bLineOfSight](AActor* it)
+		{
+			if (!Evaluation.Filter.FilterPassesForActor(it))
+			{
+				return true;
+			}
+
+			return bLineOfSight && !UTargetFunctionLibrary::HasLineOfSightToTarget(WorldContextObject, Snapshot.Location, it, Evaluation.Avatar);
+		});
+	}
+
+	bool CanMergeQuery(EOverlapAbilityShape Shape)
+	{
+		return Shape == EOverlapAbilityShape::Cone || Shape == EOverlapAbilityShape::Ring || Shape == EOverlapAbilityShape::Sector;
+	}
+
+	FOverlapQueryParams GetCandidateQuery(EOverlapAbilityShape Shape, const FOverlapEventSnapshot& Snapshot, const FOverlapEventEvaluation& Evaluation)
+	{
+		//Same checks as the kernel Select picks for this evaluation.
+		return GetCandidateQuery(Shape, Evaluation.MinDistance > 0.f, Shape != EOverlapAbilityShape::Ring && Evaluation.AngleDeviation < 180.f, Snapshot, Evaluation);
+	}
+
+	FSphere GetQueryBounds(EOverlapAbilityShape Shape, const FOverlapEventSnapshot& Snapshot, const FOverlapEventEvaluation& Evaluation)
+	{
+		const FVector& Extent = Evaluation.Extent;
+		switch (Shape)
+		{
+		case EOverlapAbilityShape::Sphere:
+		case EOverlapAbilityShape::Cone:
+			return FSphere(Snapshot.Location, Extent.X);
+		case EOverlapAbilityShape::Box:
+			return FSphere(Snapshot.Location, Extent.Size());
+		case EOverlapAbilityShape::Capsule:
+			return FSphere(Snapshot.Location, FMath::Max(Extent.X, Extent.Y));
+		case EOverlapAbilityShape::Ring:
+		case EOverlapAbilityShape::Sector:
+			return FSphere(Snapshot.Location, FVector(Extent.X, 0.f, Extent.Z > 0.f ? Extent.Z : Extent.X).Size());
+		default:
+			return FSphere(Snapshot.Location, 0.f);
+		}
+	}
+
+	void QueryCandidatesInBounds(const UObject* WorldContextObject, const FSphere& Bounds, TArray<AActor*>& OutActors)
+	{
+		SCOPE_CYCLE_COUNTER(STAT_OverlapKernel);
+
+		const TArray<AActor*, FDefaultAllocator> IgnoreActors;
+		const TArray<TEnumAsByte<EObjectTypeQuery>> Query{ EObjectTypeQuery::ObjectTypeQuery3 };
+		UKismetSystemLibrary::SphereOverlapActors(WorldContextObject, Bounds.Center, Bounds.W, Query, APawn::StaticClass(), IgnoreActors, OutActors);
+	}
+
+	/** Runs the kernel and the target filters the given amount of times and returns the average cost per snapshot, in microseconds.*/
+	static double MeasureKernel(UWorld* World, const FOverlapEventSnapshot& Snapshot, FOverlapEventKernel Kernel, FOverlapEventEvaluation& Evaluation, int32 Iterations, bool bLineOfSight = false)
+	{
+		const double StartTime = FPlatformTime::Seconds();
+		for (int32 i = 0; i < Iterations; i++)
+		{
+			Evaluation.Targets.Reset();
+			Kernel(World, Snapshot, Evaluation);
+			FilterTargets(World, Snapshot, bLineOfSight, Evaluation);
+		}
+		return (FPlatformTime::Seconds() - StartTime) * 1000000.0 / Iterations;
+	}
+
+	/** Runs every specialization at the location of the first player pawn and logs the average cost per snapshot, then compares the native wide ring and narrow cone shapes with their sphere emulation.*/
+	static void Benchmark(const TArray<FString>& Args, UWorld* World)
+	{
+		const APawn* Pawn = World && World->GetFirstPlayerController() ? World->GetFirstPlayerController()->GetPawn() : nullptr;
+		if (!Pawn)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("OverlapEventKernels::Benchmark: Needs a world with a player pawn."));
+			return;
+		}
+
+		const int32 Iterations = Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 1000;
+		const float Radius = Args.Num() > 1 ? FCString::Atof(*Args[1]) : 1000.f;
+
+		FOverlapEventSnapshot Snapshot;
+		Snapshot.Location = Pawn->GetActorLocation();
+
+		FOverlapEventEvaluation BaseEvaluation;
+		BaseEvaluation.Avatar = const_cast<APawn*>(Pawn);
+		BaseEvaluation.Extent = FVector(Radius);
+		BaseEvaluation.Yaw = Pawn->GetActorRotation().Yaw;
+
+		const EOverlapAbilityShape Shapes[] = { EOverlapAbilityShape::Sphere, EOverlapAbilityShape::Box, EOverlapAbilityShape::Capsule, EOverlapAbilityShape::Cone, EOverlapAbilityShape::Ring, EOverlapAbilityShape::Sector };
+		for (const EOverlapAbilityShape Shape : Shapes)
+		{
+			for (int32 Flags = 0; Flags < 8; Flags++)
+			{
+				const bool bLineOfSight = Flags & 4;
+				const bool bMinDistance = Flags & 2;
+				const bool bAngleDeviation = Flags & 1;
+				const FOverlapEventKernel Kernel = Select(Shape, bMinDistance, bAngleDeviation);
+
+				FOverlapEventEvaluation Evaluation = BaseEvaluation;
+				Evaluation.MinDistance = bMinDistance ? Radius * .25f : 0.f;
+				Evaluation.AngleDeviation = bAngleDeviation ? 45.f : 180.f;
+
+				const double Microseconds = MeasureKernel(World, Snapshot, Kernel, Evaluation, Iterations, bLineOfSight);
+
+				UE_LOG(LogTemp, Log, TEXT("Overlap kernel %s LOS:%d MinDistance:%d Angle:%d - %.2f us per snapshot, %d candidates, %d targets."),
+					*UEnum::GetValueAsString(Shape), bLineOfSight, bMinDistance, bAngleDeviation, Microseconds, Evaluation.NumCandidates, Evaluation.Targets.Num());
+			}
+		}
+
+		struct FComparison
+		{
+			const TCHAR* Name;
+			EOverlapAbilityShape Shape;
+			float MinDistance;
+			float AngleDeviation;
+		};
+
+		const FComparison Comparisons[] =
+		{
+			{ TEXT("Wide ring"), EOverlapAbilityShape::Ring, Radius * .8f, 180.f },
+			{ TEXT("Narrow cone"), EOverlapAbilityShape::Cone, 0.f, 15.f },
+			{ TEXT("Narrow sector"), EOverlapAbilityShape::Sector, Radius * .5f, 15.f }
+		};
+
+		for (const FComparison& Comparison : Comparisons)
+		{
+			FOverlapEventEvaluation Evaluation = BaseEvaluation;
+			Evaluation.MinDistance = Comparison.MinDistance;
+			Evaluation.AngleDeviation = Comparison.AngleDeviation;
+
+			const double EmulatedMicroseconds = MeasureKernel(World, Snapshot, Select(EOverlapAbilityShape::Sphere, Evaluation), Evaluation, Iterations);
+			const int32 EmulatedCandidates = Evaluation.NumCandidates;
+			const int32 EmulatedTargets = Evaluation.Targets.Num();
+
+			const double NativeMicroseconds = MeasureKernel(World, Snapshot, Select(Comparison.Shape, Evaluation), Evaluation, Iterations);
+
+			UE_LOG(LogTemp, Log, TEXT("%s: sphere emulation %.2f us, %d candidates, %d targets. %s %.2f us, %d candidates, %d targets."),
+				Comparison.Name, EmulatedMicroseconds, EmulatedCandidates, EmulatedTargets, *UEnum::GetValueAsString(Comparison.Shape), NativeMicroseconds, Evaluation.NumCandidates, Evaluation.Targets.Num());
+		}
+
+		//Repeated queries, like stacked traps or several casts on the same spot. Events of a batch with the same query share its candidates.
+		for (const EOverlapAbilityShape Shape : { EOverlapAbilityShape::Sphere, EOverlapAbilityShape::Box, EOverlapAbilityShape::Capsule })
+		{
+			FOverlapEventEvaluation Evaluation = BaseEvaluation;
+			const FOverlapEventKernel Kernel = Select(Shape, Evaluation);
+
+			const double NativeMicroseconds = MeasureKernel(World, Snapshot, Kernel, Evaluation, Iterations);
+			const int32 NativeTargets = Evaluation.Targets.Num();
+
+			TArray<AActor*> Candidates;
+			QueryCandidates(World, GetCandidateQuery(Shape, Snapshot, Evaluation), Candidates);
+			Evaluation.SharedCandidates = &Candidates;
+			const double SharedMicroseconds = MeasureKernel(World, Snapshot, Kernel, Evaluation, Iterations);
+
+			UE_LOG(LogTemp, Log, TEXT("Repeated %s query: native %.2f us, %d targets. Shared %.2f us, %d targets."),
+				*UEnum::GetValueAsString(Shape), NativeMicroseconds, NativeTargets, SharedMicroseconds, Evaluation.Targets.Num());
+		}
+	}
+
+	static FAutoConsoleCommandWithWorldAndArgs BenchmarkCommand(TEXT("AbilitySystem.BenchmarkOverlapKernels"), TEXT("Runs every overlap kernel specialization at the player location and logs its cost. Arguments: Iterations (1000), Radius (1000)."), FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&Benchmark));
+}
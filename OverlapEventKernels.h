@@ -0,0 +1,45 @@
+// Copyright 2024 Marchetti S. César A. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AbilitySystem/Abilities/BaseOverlapAbility.h"
+#include "AbilitySystem/Abilities/OverlapEventEvaluation.h"
+
+/**
+*	Overlap kernels run the shape query and the geometric checks of an overlap event in a single pass.
+*	There is one specialization per shape and per combination of inner radius and angle checks, so the per target loop has no dead branches.
+*	Cone, Ring and Sector are native shapes: a bounding query followed by an analytic test against the target collision cylinder.
+*	Kernels only read the snapshot, actor transforms and the physics scene, and write the evaluation targets, so they can run off the game thread.
+*	The target filter and the line of sight traces can run script and read gameplay state, FilterTargets runs them on the game thread once the kernel is done.
+*/
+namespace OverlapEventKernels
+{
+	/** Returns the kernel for this shape and set of checks. Unknown shapes get a kernel that finds no targets.*/
+	CAMERAPLAY_API FOverlapEventKernel Select(EOverlapAbilityShape Shape, bool bMinDistance, bool bAngleDeviation);
+
+	/** Returns the kernel for an evaluation that was already prepared.*/
+	CAMERAPLAY_API FOverlapEventKernel Select(EOverlapAbilityShape Shape, const FOverlapEventEvaluation& Evaluation);
+
+	/** Removes the kernel targets that don't pass the evaluation filter, or that aren't in line of sight of the snapshot location. Game thread only.*/
+	CAMERAPLAY_API void FilterTargets(const UObject* WorldContextObject, const FOverlapEventSnapshot& Snapshot, bool bLineOfSight, FOverlapEventEvaluation& Evaluation);
+
+	/** Physics query the kernel of a prepared evaluation runs for its candidates. Invalid for unknown shapes. Equal queries return the same candidates.*/
+	CAMERAPLAY_API FOverlapQueryParams GetCandidateQuery(EOverlapAbilityShape Shape, const FOverlapEventSnapshot& Snapshot, const FOverlapEventEvaluation& Evaluation);
+
+	/** Runs a query built by GetCandidateQuery. Events with the same query can share the result as their candidates.*/
+	CAMERAPLAY_API void QueryCandidates(const UObject* WorldContextObject, const FOverlapQueryParams& Query, TArray<AActor*>& OutActors);
+
+	/**
+	*	Whether or not events of this shape can take their candidates from a merged query.
+	*	Only the analytic shapes: their own query is a bounding query too, and both paths end with the same test against the target collision cylinder.
+	*	Sphere, Box and Capsule rely on the exact physics overlap of their shape, which a cylinder test can't reproduce for every target collision.
+	*/
+	CAMERAPLAY_API bool CanMergeQuery(EOverlapAbilityShape Shape);
+
+	/** Sphere that contains the shape of a prepared evaluation. Zero radius for unknown shapes.*/
+	CAMERAPLAY_API FSphere GetQueryBounds(EOverlapAbilityShape Shape, const FOverlapEventSnapshot& Snapshot, const FOverlapEventEvaluation& Evaluation);
+
+	/** Pawn candidates of a merged query. Kernels given these as shared candidates split them with an exact test of their own shape.*/
+	CAMERAPLAY_API void QueryCandidatesInBounds(const UObject* WorldContextObject, const FSphere& Bounds, TArray<AActor*>& OutActors);
+}
@@ -0,0 +1,290 @@
+// Copyright 2024 Marchetti S. César A. All Rights Reserved.
+
+#include "AbilitySystem/Abilities/OverlapEventSubsystem.h"
+#include "Async/ParallelFor.h"
+#include "AbilitySystem/AbilitySystemStats.h"
+#include "AbilitySystem/Abilities/OverlapEventKernels.h"
+
+DECLARE_CYCLE_STAT(TEXT("Overlap Events Flush"), STAT_OverlapEventsFlush, STATGROUP_AbilitySystemPerf);
+DECLARE_CYCLE_STAT(TEXT("Overlap Events Evaluate"), STAT_OverlapEventsEvaluate, STATGROUP_AbilitySystemPerf);
+DECLARE_CYCLE_STAT(TEXT("Overlap Events Apply"), STAT_OverlapEventsApply, STATGROUP_AbilitySystemPerf);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Overlap Events Per Frame"), STAT_OverlapEventsPerFrame, STATGROUP_AbilitySystemPerf);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Overlap Queries Per Frame"), STAT_OverlapQueriesPerFrame, STATGROUP_AbilitySystemPerf);
+
+int32 ParallelOverlapEvaluation = 1;
+static FAutoConsoleVariableRef CVarParallelOverlapEvaluation(TEXT("AbilitySystem.ParallelOverlapEvaluation"), ParallelOverlapEvaluation, TEXT("Evaluate overlap events that are due in the same frame in parallel. Values are 0 or 1. Both paths produce the same targets."), ECVF_Default);
+
+int32 ParallelOverlapEvaluationMinBatch = 4;
+static FAutoConsoleVariableRef CVarParallelOverlapEvaluationMinBatch(TEXT("AbilitySystem.ParallelOverlapEvaluation.MinBatch"), ParallelOverlapEvaluationMinBatch, TEXT("Minimum amount of overlap events in a frame to go wide. Smaller batches are evaluated on the game thread."), ECVF_Default);
+
+int32 VerifyParallelOverlapEvaluation = 0;
+static FAutoConsoleVariableRef CVarVerifyParallelOverlapEvaluation(TEXT("AbilitySystem.ParallelOverlapEvaluation.Verify"), VerifyParallelOverlapEvaluation, TEXT("Debug. Evaluate every batched overlap event again on the game thread with its own query, and log a warning when the targets differ from the batched result. Values are 0 or 1."), ECVF_Default);
+
+int32 MergeOverlapQueries = 1;
+static FAutoConsoleVariableRef CVarMergeOverlapQueries(TEXT("AbilitySystem.MergeOverlapQueries"), MergeOverlapQueries, TEXT("Cone, Ring and Sector overlap events due in the same frame with overlapping bounds share a single broadphase query. Values are 0 or 1. Check with AbilitySystem.ParallelOverlapEvaluation.Verify."), ECVF_Default);
+
+float MergeOverlapQueriesMaxVolumeRatio = 2.f;
+static FAutoConsoleVariableRef CVarMergeOverlapQueriesMaxVolumeRatio(TEXT("AbilitySystem.MergeOverlapQueries.MaxVolumeRatio"), MergeOverlapQueriesMaxVolumeRatio, TEXT("Maximum volume of a merged query relative to the summed volume of the queries it replaces. Keeps far apart events from being merged through a chain of neighbours."), ECVF_Default);
+
+void UOverlapEventSubsystem::Deinitialize()
+{
+	PendingEvents.Empty();
+	ActiveBatch.Empty();
+	QueryClusters.Empty();
+	ActiveBatchIndex = 0;
+
+	Super::Deinitialize();
+}
+
+void UOverlapEventSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	FlushOverlapEvents();
+}
+
+TStatId UOverlapEventSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UOverlapEventSubsystem, STATGROUP_Tickables);
+}
+
+void UOverlapEventSubsystem::QueueOverlapEvent(UBaseOverlapAbility* Ability, const FOverlapEventSnapshot& Snapshot)
+{
+	FPendingOverlapEvent& Entry = PendingEvents.AddDefaulted_GetRef();
+	Entry.Ability = Ability;
+	Entry.Snapshot = Snapshot;
+}
+
+void UOverlapEventSubsystem::FlushOverlapEvents()
+{
+	if (PendingEvents.IsEmpty())
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_OverlapEventsFlush);
+	INC_DWORD_STAT_BY(STAT_OverlapEventsPerFrame, PendingEvents.Num());
+
+	//Applying events can queue new ones (retriggers, events fired from hit reactions), those go to the next flush.
+	ActiveBatch = MoveTemp(PendingEvents);
+	PendingEvents.Reset();
+	ActiveBatchIndex = 0;
+
+	//Prepare on the game thread, abilities resolve their event tags and filters here. Events of abilities that ended since they were queued are dropped.
+	for (FPendingOverlapEvent& Entry : ActiveBatch)
+	{
+		UBaseOverlapAbility* Ability = Entry.Ability.Get();
+		if (Ability && Ability->IsActive())
+		{
+			Ability->PrepareBatchedOverlapEvent(Entry.Snapshot, Entry.Evaluation);
+			Entry.PreparedAbility = Ability;
+			Entry.bValid = true;
+		}
+	}
+
+	BuildQueryClusters();
+	INC_DWORD_STAT_BY(STAT_OverlapQueriesPerFrame, QueryClusters.Num());
+
+	//Read-only phase. Each cluster runs its merged or shared query once, each entry only writes to its own evaluation.
+	//Only shape queries and geometry run here, the filters and line of sight run on the game thread when the events are applied.
+	{
+		SCOPE_CYCLE_COUNTER(STAT_OverlapEventsEvaluate);
+		const bool bSingleThread = !ParallelOverlapEvaluation || ActiveBatch.Num() < ParallelOverlapEvaluationMinBatch;
+		const UWorld* World = GetWorld();
+		ParallelFor(QueryClusters.Num(), [this, World](int32 Index)
+		{
+			FOverlapQueryCluster& Cluster = QueryClusters[Index];
+			const bool bMerged = Cluster.Members.Num() > 1;
+			if (bMerged && Cluster.Query.IsValid())
+			{
+				OverlapEventKernels::QueryCandidates(World, Cluster.Query, Cluster.Candidates);
+			}
+			else if (bMerged)
+			{
+				OverlapEventKernels::QueryCandidatesInBounds(World, Cluster.Bounds, Cluster.Candidates);
+			}
+
+			for (const int32 Member : Cluster.Members)
+			{
+				FPendingOverlapEvent& Entry = ActiveBatch[Member];
+				Entry.Evaluation.SharedCandidates = bMerged ? &Cluster.Candidates : nullptr;
+				Entry.PreparedAbility->EvaluateOverlapEvent(Entry.Snapshot, Entry.Evaluation);
+				Entry.Evaluation.SharedCandidates = nullptr;
+			}
+		}, bSingleThread);
+	}
+
+	if (VerifyParallelOverlapEvaluation)
+	{
+		VerifyBatchEvaluation();
+	}
+
+	//Apply in queue order so the results don't depend on how the work was split. Applying an event can end the ability of later ones.
+	{
+		SCOPE_CYCLE_COUNTER(STAT_OverlapEventsApply);
+		for (; ActiveBatchIndex < ActiveBatch.Num(); ActiveBatchIndex++)
+		{
+			FPendingOverlapEvent& Entry = ActiveBatch[ActiveBatchIndex];
+			UBaseOverlapAbility* Ability = Entry.Ability.Get();
+			if (Entry.bValid && Ability && Ability->IsActive())
+			{
+				Ability->ExecuteBatchedOverlapEvent(Entry.Snapshot, Entry.Evaluation);
+			}
+		}
+	}
+
+	ActiveBatch.Reset();
+	ActiveBatchIndex = 0;
+}
+
+void UOverlapEventSubsystem::BuildQueryClusters()
+{
+	for (FOverlapQueryCluster& Cluster : QueryClusters)
+	{
+		Cluster.Members.Reset();
+		Cluster.Query = FOverlapQueryParams();
+		Cluster.Candidates.Reset();
+	}
+
+	//Events that don't merge by bounds only share a query with events that run the exact same one.
+	TMap<FOverlapQueryParams, int32> ClusterByQuery;
+	int32 NumClusters = 0;
+	for (int32 Index = 0; Index < ActiveBatch.Num(); Index++)
+	{
+		const FPendingOverlapEvent& Entry = ActiveBatch[Index];
+		if (!Entry.bValid)
+		{
+			continue;
+		}
+
+		const FSphere& Bounds = Entry.Evaluation.QueryBounds;
+		const float Volume = FMath::Cube(Bounds.W);
+		FOverlapQueryCluster* Cluster = nullptr;
+
+		//Shapes that need their exact physics query have no bounds and never merge.
+		const bool bMergeByBounds = MergeOverlapQueries && Bounds.W > 0.f;
+		const FOverlapQueryParams& Query = Entry.Evaluation.CandidateQuery;
+		if (bMergeByBounds)
+		{
+			for (int32 ClusterIndex = 0; ClusterIndex < NumClusters; ClusterIndex++)
+			{
+				FOverlapQueryCluster& Candidate = QueryClusters[ClusterIndex];
+				if (Candidate.Bounds.W <= 0.f || Candidate.Query.IsValid() || !Candidate.Bounds.Intersects(Bounds))
+				{
+					continue;
+				}
+
+				FSphere Merged = Candidate.Bounds;
+				Merged += Bounds;
+				if (FMath::Cube(Merged.W) <= MergeOverlapQueriesMaxVolumeRatio * (Candidate.MemberVolume + Volume))
+				{
+					Candidate.Bounds = Merged;
+					Candidate.MemberVolume += Volume;
+					Cluster = &Candidate;
+					break;
+				}
+			}
+		}
+		else if (Query.IsValid())
+		{
+			if (const int32* ClusterIndex = ClusterByQuery.Find(Query))
+			{
+				Cluster = &QueryClusters[*ClusterIndex];
+				Cluster->Query = Query;
+			}
+			else
+			{
+				ClusterByQuery.Add(Query, NumClusters);
+			}
+		}
+
+		if (!Cluster)
+		{
+			if (NumClusters == QueryClusters.Num())
+			{
+				QueryClusters.AddDefaulted();
+			}
+
+			Cluster = &QueryClusters[NumClusters++];
+			Cluster->Bounds = Bounds;
+			Cluster->MemberVolume = Volume;
+		}
+
+		Cluster->Members.Add(Index);
+	}
+
+	QueryClusters.SetNum(NumClusters);
+}
+
+void UOverlapEventSubsystem::VerifyBatchEvaluation()
+{
+	//The reference path: serial, no merged or shared candidates.
+	const bool bParallel = ParallelOverlapEvaluation && ActiveBatch.Num() >= ParallelOverlapEvaluationMinBatch;
+
+	for (const FPendingOverlapEvent& Entry : ActiveBatch)
+	{
+		const UBaseOverlapAbility* Ability = Entry.Ability.Get();
+		if (!Entry.bValid || !Ability)
+		{
+			continue;
+		}
+
+		FOverlapEventEvaluation Reference = Entry.Evaluation;
+		Reference.SharedCandidates = nullptr;
+		Reference.Targets.Reset();
+		Ability->EvaluateOverlapEvent(Entry.Snapshot, Reference);
+
+		const TArray<AActor*>& Targets = Entry.Evaluation.Targets;
+		const bool bSameTargets = Reference.Targets.Num() == Targets.Num() && !Reference.Targets.ContainsByPredicate([&Targets](const AActor* Target) { return !Targets.Contains(Target); });
+		if (!bSameTargets)
+		{
+			NumVerifyMismatches++;
+			UE_LOG(LogTemp, Warning, TEXT("UOverlapEventSubsystem::VerifyBatchEvaluation: %s event %d overlap %d found %d targets batched and %d alone (Parallel:%d, %d mismatches so far)."),
+				*Ability->GetName(), Entry.Snapshot.EventID, Entry.Snapshot.OverlapID, Targets.Num(), Reference.Targets.Num(), bParallel, NumVerifyMismatches);
+		}
+	}
+}
+
+bool UOverlapEventSubsystem::HasPendingOverlapEvents(const UBaseOverlapAbility* Ability) const
+{
+	for (const FPendingOverlapEvent& Entry : PendingEvents)
+	{
+		if (Entry.Ability.Get() == Ability)
+		{
+			return true;
+		}
+	}
+
+	//The entry being applied is not pending anymore.
+	for (int32 i = ActiveBatchIndex + 1; i < ActiveBatch.Num(); i++)
+	{
+		if (ActiveBatch[i].Ability.Get() == Ability)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool UOverlapEventSubsystem::HasPendingOverlapEvent(const UBaseOverlapAbility* Ability, int32 EventID) const
+{
+	for (const FPendingOverlapEvent& Entry : PendingEvents)
+	{
+		if (Entry.Snapshot.EventID == EventID && Entry.Ability.Get() == Ability)
+		{
+			return true;
+		}
+	}
+
+	//The entry being applied is not pending anymore.
+	for (int32 i = ActiveBatchIndex + 1; i < ActiveBatch.Num(); i++)
+	{
+		if (ActiveBatch[i].Snapshot.EventID == EventID && ActiveBatch[i].Ability.Get() == Ability)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
@@ -0,0 +1,92 @@
+// Copyright 2024 Marchetti S. César A. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "AbilitySystem/Abilities/BaseOverlapAbility.h"
+#include "AbilitySystem/Abilities/OverlapEventEvaluation.h"
+#include "OverlapEventSubsystem.generated.h"
+
+/**
+*	Gathers the overlap events that are due in the same frame, from every overlap ability in the world, and evaluates them together.
+*	The read-only phase (shape query and geometric checks) runs as a ParallelFor. Results are filtered and applied on the game thread in the order the events were queued.
+*	Events with overlapping bounds share a single broadphase query, each event then keeps the candidates inside its own shape.
+*	Events that can't merge but repeat the exact query of another event of the batch, like stacked traps, share that query instead.
+*/
+UCLASS()
+class CAMERAPLAY_API UOverlapEventSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/** Queues an overlap event to be evaluated and applied this frame.*/
+	void QueueOverlapEvent(UBaseOverlapAbility* Ability, const FOverlapEventSnapshot& Snapshot);
+
+	/** Evaluates and applies all queued events.*/
+	void FlushOverlapEvents();
+
+	/** Whether or not an event of this ability is waiting to be applied. Abilities must not clean up an event while this is true.*/
+	bool HasPendingOverlapEvent(const UBaseOverlapAbility* Ability, int32 EventID) const;
+
+	/** Whether or not any event of this ability is waiting to be applied. Abilities must not end while this is true.*/
+	bool HasPendingOverlapEvents(const UBaseOverlapAbility* Ability) const;
+
+private:
+
+	struct FPendingOverlapEvent
+	{
+		TWeakObjectPtr<UBaseOverlapAbility> Ability;
+
+		/** Ability resolved on the game thread when the batch is prepared, so the evaluation doesn't resolve the weak pointer off the game thread. Set for valid entries.*/
+		const UBaseOverlapAbility* PreparedAbility = nullptr;
+
+		FOverlapEventSnapshot Snapshot;
+		FOverlapEventEvaluation Evaluation;
+		bool bValid = false;
+	};
+
+	/** Events queued for the next flush.*/
+	TArray<FPendingOverlapEvent> PendingEvents;
+
+	/** Events of the active batch that share a single broadphase query. Single event clusters run their own query.*/
+	struct FOverlapQueryCluster
+	{
+		FSphere Bounds = FSphere(ForceInit);
+
+		/** Sum of the cubed radius of the members, to compare the merged volume with the volume of the separate queries.*/
+		float MemberVolume = 0.f;
+
+		TArray<int32, TInlineAllocator<4>> Members;
+
+		/** Exact query shared by every member, instead of a bounding query. Only valid for clusters of identical queries.*/
+		FOverlapQueryParams Query;
+
+		TArray<AActor*> Candidates;
+	};
+
+	/** Groups the valid events of the active batch by overlapping query bounds, or by identical query for those that can't merge.*/
+	void BuildQueryClusters();
+
+	/**
+	*	Evaluates every event of the active batch again on its own, on the game thread, with its own unshared query, and logs the events whose targets differ.
+	*	Enabled with AbilitySystem.ParallelOverlapEvaluation.Verify.
+	*/
+	void VerifyBatchEvaluation();
+
+	/** Events whose verification found different targets, since the start.*/
+	int32 NumVerifyMismatches = 0;
+
+	/** Events being flushed. Entries from ActiveBatchIndex onwards have not been applied yet.*/
+	TArray<FPendingOverlapEvent> ActiveBatch;
+
+	int32 ActiveBatchIndex = 0;
+
+	/** Query clusters of the active batch. Kept between flushes to reuse the allocations.*/
+	TArray<FOverlapQueryCluster> QueryClusters;
+};
@@ -0,0 +1,39 @@
+// Copyright 2024 Marchetti S. César A. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AbilitySystem/SharedGameplayTagContainer.h"
+
+/** Targeting visualization values of an overlap ability. Built by UBaseOverlapAbility::GetVisualizationDescriptor.*/
+struct FOverlapVisualizationDescriptor
+{
+	float OuterRadius = 0.f;
+	float InnerRadius = 0.f;
+	float HalfAngle = 0.f;
+	float Width = 0.f;
+	float Length = 0.f;
+	int32 TargetAmount = 0;
+
+	/** Params in the format of GetVisualizationParams, including the ones from the target distribution.*/
+	TMap<FString, float> Params;
+};
+
+/**
+*	Cached visualization descriptor. Aiming asks for it every frame, it's only rebuilt when the level, the ability tags or the attributes of the owner change.
+*	Attribute changes are detected with the FAttributeScalingCache epoch of the owner ASC.
+*/
+struct FOverlapVisualizationCache
+{
+	FOverlapVisualizationDescriptor Descriptor;
+
+	bool bValid = false;
+	int32 Level = INDEX_NONE;
+	uint32 AttributeEpoch = 0;
+	FSharedGameplayTagContainer AbilityTags;
+
+	bool Matches(int32 InLevel, uint32 InAttributeEpoch, const FSharedGameplayTagContainer& InAbilityTags) const
+	{
+		return bValid && Level == InLevel && AttributeEpoch == InAttributeEpoch && AbilityTags == InAbilityTags;
+	}
+};
@@ -0,0 +1,226 @@
+// Copyright 2024 Marchetti S. César A. All Rights Reserved.
+
+#include "AbilitySystem/PeriodicStaggerSubsystem.h"
+#include "AbilitySystem/AbilitySystemStats.h"
+#include "Engine/World.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogPeriodicStagger, Log, All);
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("AoE Period Ticks Per Frame"), STAT_AoEPeriodTicksPerFrame, STATGROUP_AbilitySystemPerf);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Staggered Periodic Series"), STAT_StaggeredPeriodicSeries, STATGROUP_AbilitySystemPerf);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Reserved Periodic Series"), STAT_ReservedPeriodicSeries, STATGROUP_AbilitySystemPerf);
+
+int32 EnablePeriodicStagger = 1;
+static FAutoConsoleVariableRef CVarEnablePeriodicStagger(TEXT("AbilitySystem.PeriodicStagger"), EnablePeriodicStagger, TEXT("Spread the period ticks of periodic collision actors and overlap events over nearby frames, within the PeriodStaggerFrames of their class. Values are 0 or 1, applied to series started afterwards."), ECVF_Default);
+
+float PeriodicStaggerFrameTime = 1.f / 30.f;
+static FAutoConsoleVariableRef CVarPeriodicStaggerFrameTime(TEXT("AbilitySystem.PeriodicStagger.FrameTime"), PeriodicStaggerFrameTime, TEXT("Length in seconds of the frames stagger tolerances are given in. Should match the server tick rate."), ECVF_Default);
+
+static FAutoConsoleCommandWithWorldAndArgs PeriodicStaggerHistogramCommand(
+	TEXT("AbilitySystem.PeriodicStagger.Histogram"),
+	TEXT("Logs how many frames ran each amount of AoE period ticks since the last call, then starts over."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (UPeriodicStaggerSubsystem* StaggerSubsystem = World ? World->GetSubsystem<UPeriodicStaggerSubsystem>() : nullptr)
+		{
+			StaggerSubsystem->LogWorkHistogram();
+		}
+	}));
+
+bool UPeriodicStaggerSubsystem::IsEnabled()
+{
+	return EnablePeriodicStagger != 0;
+}
+
+float UPeriodicStaggerSubsystem::GetFrameTime()
+{
+	return FMath::Max(PeriodicStaggerFrameTime, 0.001f);
+}
+
+void UPeriodicStaggerSubsystem::Deinitialize()
+{
+	PhaseLoads.Empty();
+	Reservations.Empty();
+	NextPurgeTime = -1.0;
+
+	Super::Deinitialize();
+}
+
+TStatId UPeriodicStaggerSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UPeriodicStaggerSubsystem, STATGROUP_Tickables);
+}
+
+void UPeriodicStaggerSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	//Ticks counted after this point, by tickables that run later in the frame, go to the next frame. Every frame is cut at the same place.
+	int32 Bin = 0;
+	while (Bin < NumHistogramBins - 1 && FrameWork > (Bin < 2 ? Bin : 1 << (Bin - 1)))
+	{
+		Bin++;
+	}
+	WorkHistogram[Bin]++;
+	HistogramWork += FrameWork;
+	HistogramPeakWork = FMath::Max(HistogramPeakWork, FrameWork);
+
+	SET_DWORD_STAT(STAT_AoEPeriodTicksPerFrame, FrameWork);
+	FrameWork = 0;
+
+	const UWorld* World = GetWorld();
+	if (World && NextPurgeTime >= 0.0 && World->GetTimeSeconds() >= NextPurgeTime)
+	{
+		PurgeReservations(World->GetTimeSeconds());
+	}
+}
+
+float UPeriodicStaggerSubsystem::StaggerPeriodicSeries(double FirstTickTime, float Period, float MinOffset, float MaxOffset, double EndTime, int32* OutReservationID)
+{
+	if (OutReservationID)
+	{
+		*OutReservationID = INDEX_NONE;
+	}
+
+	const float FrameTime = GetFrameTime();
+	const int32 PeriodFrames = FMath::RoundToInt32(Period / FrameTime);
+
+	//Periods of a frame or less tick every frame anyway.
+	if (PeriodFrames < 2 || PeriodFrames > MaxPeriodFrames)
+	{
+		return 0.f;
+	}
+
+	TArray<int32>& Loads = PhaseLoads.FindOrAdd(PeriodFrames);
+	if (Loads.IsEmpty())
+	{
+		Loads.SetNumZeroed(PeriodFrames);
+	}
+
+	//Periods that aren't a whole amount of frames drift a bit from their phase, the load is an estimate.
+	const int64 FirstFrame = FMath::FloorToInt64(FirstTickTime / FrameTime);
+	auto GetPhase = [FirstFrame, PeriodFrames](int32 Offset)
+	{
+		return (int32)(((FirstFrame + Offset) % PeriodFrames + PeriodFrames) % PeriodFrames);
+	};
+
+	//Nearest offsets first, so the original timing is kept unless another phase has strictly less load.
+	const int32 MinFrames = FMath::Max(FMath::CeilToInt32(MinOffset / FrameTime), 1 - PeriodFrames);
+	const int32 MaxFrames = FMath::Min(FMath::FloorToInt32(MaxOffset / FrameTime), PeriodFrames - 1);
+	int32 BestOffset = 0;
+	int32 BestLoad = Loads[GetPhase(0)];
+	for (int32 Distance = 1; BestLoad > 0 && Distance <= FMath::Max(-MinFrames, MaxFrames); Distance++)
+	{
+		for (const int32 Offset : { Distance, -Distance })
+		{
+			if (Offset < MinFrames || Offset > MaxFrames)
+			{
+				continue;
+			}
+
+			const int32 Load = Loads[GetPhase(Offset)];
+			if (Load < BestLoad)
+			{
+				BestLoad = Load;
+				BestOffset = Offset;
+			}
+		}
+	}
+
+	FPhaseReservation& Reservation = Reservations.AddDefaulted_GetRef();
+	Reservation.ID = NextReservationID++;
+	Reservation.PeriodFrames = PeriodFrames;
+	Reservation.Phase = GetPhase(BestOffset);
+	Reservation.EndTime = EndTime;
+	Loads[Reservation.Phase]++;
+
+	if (NextPurgeTime < 0.0 || EndTime < NextPurgeTime)
+	{
+		NextPurgeTime = EndTime;
+	}
+
+	SET_DWORD_STAT(STAT_ReservedPeriodicSeries, Reservations.Num());
+	if (BestOffset != 0)
+	{
+		INC_DWORD_STAT(STAT_StaggeredPeriodicSeries);
+	}
+
+	if (OutReservationID)
+	{
+		*OutReservationID = Reservation.ID;
+	}
+
+	return BestOffset * FrameTime;
+}
+
+void UPeriodicStaggerSubsystem::ReleasePeriodicSeries(int32 ReservationID)
+{
+	if (ReservationID == INDEX_NONE)
+	{
+		return;
+	}
+
+	const int32 Index = Reservations.IndexOfByPredicate([ReservationID](const FPhaseReservation& Reservation) { return Reservation.ID == ReservationID; });
+	if (Index != INDEX_NONE)
+	{
+		//NextPurgeTime may now be early, the purge finds the next one.
+		RemoveReservation(Index);
+		SET_DWORD_STAT(STAT_ReservedPeriodicSeries, Reservations.Num());
+	}
+}
+
+void UPeriodicStaggerSubsystem::PurgeReservations(double Now)
+{
+	NextPurgeTime = -1.0;
+	for (int32 i = Reservations.Num() - 1; i >= 0; i--)
+	{
+		const FPhaseReservation& Reservation = Reservations[i];
+		if (Reservation.EndTime <= Now)
+		{
+			RemoveReservation(i);
+		}
+		else if (NextPurgeTime < 0.0 || Reservation.EndTime < NextPurgeTime)
+		{
+			NextPurgeTime = Reservation.EndTime;
+		}
+	}
+
+	SET_DWORD_STAT(STAT_ReservedPeriodicSeries, Reservations.Num());
+}
+
+void UPeriodicStaggerSubsystem::RemoveReservation(int32 Index)
+{
+	const FPhaseReservation& Reservation = Reservations[Index];
+	if (TArray<int32>* Loads = PhaseLoads.Find(Reservation.PeriodFrames))
+	{
+		(*Loads)[Reservation.Phase]--;
+	}
+	Reservations.RemoveAtSwap(Index);
+}
+
+void UPeriodicStaggerSubsystem::AddPeriodicWork(int32 NumTicks)
+{
+	FrameWork += NumTicks;
+}
+
+void UPeriodicStaggerSubsystem::LogWorkHistogram()
+{
+	static const TCHAR* BinNames[NumHistogramBins] = { TEXT("0"), TEXT("1"), TEXT("2"), TEXT("3-4"), TEXT("5-8"), TEXT("9-16"), TEXT("17-32"), TEXT("33+") };
+
+	uint64 NumFrames = 0;
+	for (const uint64 Frames : WorkHistogram)
+	{
+		NumFrames += Frames;
+	}
+
+	UE_LOG(LogPeriodicStagger, Log, TEXT("AoE period ticks per frame over %llu frames (stagger %s): average %.2f, peak %d"),
+		NumFrames, IsEnabled() ? TEXT("on") : TEXT("off"), NumFrames ? (double)HistogramWork / NumFrames : 0.0, HistogramPeakWork);
+	for (int32 Bin = 0; Bin < NumHistogramBins; Bin++)
+	{
+		UE_LOG(LogPeriodicStagger, Log, TEXT("  %6s: %llu frames (%.1f%%)"), BinNames[Bin], WorkHistogram[Bin], NumFrames ? 100.0 * WorkHistogram[Bin] / NumFrames : 0.0);
+	}
+
+	FMemory::Memzero(WorkHistogram);
+	HistogramWork = 0;
+	HistogramPeakWork = 0;
+}
@@ -0,0 +1,85 @@
+// Copyright 2024 Marchetti S. César A. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "PeriodicStaggerSubsystem.generated.h"
+
+/**
+*	Spreads the period ticks of periodic areas over nearby frames, so series started by the same cast don't all land in one frame.
+*	Series are tracked by period length and phase, both in frames of AbilitySystem.PeriodicStagger.FrameTime. A new series is moved by whole frames, within the tolerance of its class,
+*	to the phase with the fewest series of the same period. Every tick of a series moves by the same offset, callers keep the offset window inside the activation and the lifespan so tick
+*	counts and lifetimes don't change.
+*	Also keeps a histogram of the period ticks run per frame, logged by AbilitySystem.PeriodicStagger.Histogram.
+*/
+UCLASS()
+class CAMERAPLAY_API UPeriodicStaggerSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Whether or not series are being staggered. The histogram is kept either way to compare.*/
+	static bool IsEnabled();
+
+	/** Length of the frames stagger tolerances are given in.*/
+	static float GetFrameTime();
+
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/**
+	*	Returns the offset, in whole frames within [MinOffset, MaxOffset], that moves the series to the least crowded phase, and reserves that phase until EndTime.
+	*	No offset is preferred on ties. MinOffset must not be positive and MaxOffset must not be negative.
+	*	OutReservationID is set to the reservation, or INDEX_NONE if the series isn't staggered. Series that can end before EndTime release it with ReleasePeriodicSeries.
+	*/
+	float StaggerPeriodicSeries(double FirstTickTime, float Period, float MinOffset, float MaxOffset, double EndTime, int32* OutReservationID = nullptr);
+
+	/** Frees the phase reserved by a series that ended early. Does nothing if the reservation was already dropped.*/
+	void ReleasePeriodicSeries(int32 ReservationID);
+
+	/** Counts period ticks run this frame for the work histogram.*/
+	void AddPeriodicWork(int32 NumTicks = 1);
+
+	/** Logs the histogram of period ticks per frame and starts a new one.*/
+	void LogWorkHistogram();
+
+private:
+
+	/** Periods longer than this many frames aren't staggered.*/
+	static constexpr int32 MaxPeriodFrames = 1024;
+
+	/** Frames with 0, 1, 2, 3-4, 5-8, 9-16, 17-32 and more period ticks.*/
+	static constexpr int32 NumHistogramBins = 8;
+
+	struct FPhaseReservation
+	{
+		int32 ID = INDEX_NONE;
+		int32 PeriodFrames = 0;
+		int32 Phase = 0;
+		double EndTime = 0.0;
+	};
+
+	/** Drops the reservations of series that ended.*/
+	void PurgeReservations(double Now);
+
+	void RemoveReservation(int32 Index);
+
+	/** Reserved series per phase, by period length in frames.*/
+	TMap<int32, TArray<int32>> PhaseLoads;
+
+	TArray<FPhaseReservation> Reservations;
+
+	int32 NextReservationID = 0;
+
+	/** Earliest end time of the reservations, negative if there are none.*/
+	double NextPurgeTime = -1.0;
+
+	int32 FrameWork = 0;
+
+	uint64 WorkHistogram[NumHistogramBins] = {};
+	uint64 HistogramWork = 0;
+	int32 HistogramPeakWork = 0;
+};
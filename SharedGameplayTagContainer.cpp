@@ -0,0 +1,150 @@
+// Copyright 2024 Marchetti S. César A. All Rights Reserved.
+
+#include "AbilitySystem/SharedGameplayTagContainer.h"
+#include "AbilitySystem/AbilitySystemStats.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Shared Tag Container Merges"), STAT_SharedTagContainerMerges, STATGROUP_AbilitySystemPerf);
+
+namespace SharedGameplayTagContainer
+{
+	using FContainerPtr = TSharedPtr<const FGameplayTagContainer>;
+	using FWeakContainerPtr = TWeakPtr<const FGameplayTagContainer>;
+
+	/**
+	*	Interned containers by tags hash. The table keeps them alive, so containers built for a single payload are reused by the next one.
+	*	Containers only referenced by the table are released by PurgeUnused.
+	*/
+	static TMap<uint32, TArray<FContainerPtr>> InternedContainers;
+
+	struct FUnionEntry
+	{
+		FWeakContainerPtr A;
+		FWeakContainerPtr B;
+		FWeakContainerPtr Result;
+	};
+
+	/** Memoized unions, keyed by the address of both inputs. Entries are validated against the weak pointers, addresses can be reused.*/
+	static TMap<TPair<const void*, const void*>, FUnionEntry> Unions;
+
+	/** Unused containers are purged every time this many new containers are interned.*/
+	static constexpr int32 PurgeInterval = 256;
+	static int32 InternedSincePurge = 0;
+
+	static uint32 GetTagsHash(const FGameplayTagContainer& Tags)
+	{
+		//Tag container equality doesn't depend on the order, so the hash can't either.
+		uint32 Hash = Tags.Num();
+		for (const FGameplayTag& Tag : Tags)
+		{
+			Hash += GetTypeHash(Tag);
+		}
+		return Hash;
+	}
+
+	static void PurgeUnused()
+	{
+		for (auto It = InternedContainers.CreateIterator(); It; ++It)
+		{
+			It.Value().RemoveAllSwap([](const FContainerPtr& Container)
+			{
+				return Container.GetSharedReferenceCount() == 1;
+			});
+
+			if (It.Value().IsEmpty())
+			{
+				It.RemoveCurrent();
+			}
+		}
+
+		for (auto It = Unions.CreateIterator(); It; ++It)
+		{
+			if (!It.Value().A.IsValid() || !It.Value().B.IsValid() || !It.Value().Result.IsValid())
+			{
+				It.RemoveCurrent();
+			}
+		}
+	}
+}
+
+FSharedGameplayTagContainer FSharedGameplayTagContainer::Intern(const FGameplayTagContainer& Tags)
+{
+	using namespace SharedGameplayTagContainer;
+	check(IsInGameThread());
+
+	if (Tags.IsEmpty())
+	{
+		return FSharedGameplayTagContainer();
+	}
+
+	const uint32 Hash = GetTagsHash(Tags);
+	if (const TArray<FContainerPtr>* Bucket = InternedContainers.Find(Hash))
+	{
+		for (const FContainerPtr& Existing : *Bucket)
+		{
+			if (*Existing == Tags)
+			{
+				return FSharedGameplayTagContainer(Existing);
+			}
+		}
+	}
+
+	if (++InternedSincePurge >= PurgeInterval)
+	{
+		InternedSincePurge = 0;
+		PurgeUnused();
+	}
+
+	FContainerPtr NewContainer = MakeShared<const FGameplayTagContainer>(Tags);
+	InternedContainers.FindOrAdd(Hash).Add(NewContainer);
+	return FSharedGameplayTagContainer(NewContainer);
+}
+
+FSharedGameplayTagContainer FSharedGameplayTagContainer::Union(const FSharedGameplayTagContainer& A, const FSharedGameplayTagContainer& B)
+{
+	using namespace SharedGameplayTagContainer;
+	check(IsInGameThread());
+
+	if (A.IsEmpty() || A == B)
+	{
+		return B;
+	}
+
+	if (B.IsEmpty())
+	{
+		return A;
+	}
+
+	//Unions are commutative, sort the key so both orders share the entry.
+	const void* AddressA = A.Container.Get();
+	const void* AddressB = B.Container.Get();
+	const TPair<const void*, const void*> Key = AddressA < AddressB ? MakeTuple(AddressA, AddressB) : MakeTuple(AddressB, AddressA);
+
+	if (FUnionEntry* Entry = Unions.Find(Key))
+	{
+		FContainerPtr Result = Entry->Result.Pin();
+		const bool bSameInputs = (Entry->A.Pin() == A.Container && Entry->B.Pin() == B.Container) || (Entry->A.Pin() == B.Container && Entry->B.Pin() == A.Container);
+		if (Result && bSameInputs)
+		{
+			return FSharedGameplayTagContainer(Result);
+		}
+	}
+
+	INC_DWORD_STAT(STAT_SharedTagContainerMerges);
+
+	FGameplayTagContainer Merged = A.Get();
+	Merged.AppendTags(B.Get());
+	FSharedGameplayTagContainer Result = Intern(Merged);
+
+	Unions.Add(Key, FUnionEntry{ A.Container, B.Container, Result.Container });
+	return Result;
+}
+
+int32 FSharedGameplayTagContainer::GetNumInterned()
+{
+	int32 Num = 0;
+	for (const auto& Pair : SharedGameplayTagContainer::InternedContainers)
+	{
+		Num += Pair.Value.Num();
+	}
+	return Num;
+}
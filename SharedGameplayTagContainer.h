@@ -0,0 +1,50 @@
+// Copyright 2024 Marchetti S. César A. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+
+/**
+*	Immutable, refcounted tag container. Identical containers are interned and share one instance, so passing them around copies a pointer.
+*	Unions of shared containers are memoized, building the tags of a payload or a cue from the same inputs only merges them once.
+*	Engine structs (FGameplayEventData, FGameplayCueParameters) still hold their own container, fill them with a single assignment from Get().
+*	Game thread only.
+*/
+class CAMERAPLAY_API FSharedGameplayTagContainer
+{
+public:
+
+	FSharedGameplayTagContainer() = default;
+
+	/** Returns the shared instance for these tags. Empty containers don't allocate.*/
+	static FSharedGameplayTagContainer Intern(const FGameplayTagContainer& Tags);
+
+	/** Returns the shared instance for the union of both containers.*/
+	static FSharedGameplayTagContainer Union(const FSharedGameplayTagContainer& A, const FSharedGameplayTagContainer& B);
+
+	const FGameplayTagContainer& Get() const
+	{
+		return Container.IsValid() ? *Container : FGameplayTagContainer::EmptyContainer;
+	}
+
+	bool IsEmpty() const
+	{
+		return !Container.IsValid();
+	}
+
+	/** Interned containers are equal only if they are the same instance.*/
+	bool operator==(const FSharedGameplayTagContainer& Other) const
+	{
+		return Container == Other.Container;
+	}
+
+	/** Amount of containers in the intern table.*/
+	static int32 GetNumInterned();
+
+private:
+
+	explicit FSharedGameplayTagContainer(const TSharedPtr<const FGameplayTagContainer>& InContainer) : Container(InContainer) {}
+
+	TSharedPtr<const FGameplayTagContainer> Container;
+};
@@ -0,0 +1,307 @@
+// Copyright 2024 Marchetti S. César A. All Rights Reserved.
+
+#include "AbilitySystem/Targeting/TargetAcquisitionSubsystem.h"
+#include "EngineUtils.h"
+#include "Algo/BinarySearch.h"
+#include "GameFramework/Pawn.h"
+#include "AbilitySystem/AbilitySystemStats.h"
+
+DECLARE_CYCLE_STAT(TEXT("Target Acquisition Grid"), STAT_TargetAcquisitionGrid, STATGROUP_AbilitySystemPerf);
+DECLARE_CYCLE_STAT(TEXT("Target Acquisition Query"), STAT_TargetAcquisitionQuery, STATGROUP_AbilitySystemPerf);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Target Acquisition Filtered Candidates"), STAT_TargetAcquisitionFiltered, STATGROUP_AbilitySystemPerf);
+
+float TargetAcquisitionCellSize = 500.f;
+static FAutoConsoleVariableRef CVarTargetAcquisitionCellSize(TEXT("AbilitySystem.TargetAcquisition.CellSize"), TargetAcquisitionCellSize, TEXT("Size of the grid cells used by the target acquisition queries, in unreal units. Applied on the next grid rebuild."), ECVF_Default);
+
+namespace
+{
+	/** Calls the visitor for every cell at exactly Ring cells of Chebyshev distance from the center.*/
+	template<typename VisitorType>
+	void ForEachCellInRing(const FIntPoint& Center, int32 Ring, VisitorType&& Visitor)
+	{
+		if (Ring == 0)
+		{
+			Visitor(Center);
+			return;
+		}
+
+		for (int32 X = -Ring; X <= Ring; X++)
+		{
+			Visitor(FIntPoint(Center.X + X, Center.Y - Ring));
+			Visitor(FIntPoint(Center.X + X, Center.Y + Ring));
+		}
+
+		for (int32 Y = -Ring + 1; Y < Ring; Y++)
+		{
+			Visitor(FIntPoint(Center.X - Ring, Center.Y + Y));
+			Visitor(FIntPoint(Center.X + Ring, Center.Y + Y));
+		}
+	}
+}
+
+void UTargetAcquisitionSubsystem::Deinitialize()
+{
+	Entries.Empty();
+	Cells.Empty();
+	GridFrame = MAX_uint64;
+
+	Super::Deinitialize();
+}
+
+int32 UTargetAcquisitionSubsystem::FindNearestTargets(const FVector& Origin, int32 Count, float MaxRadius, FTargetPredicate Predicate, TArray<AActor*>& OutTargets)
+{
+	return FindNearest(Origin, Count, MaxRadius, [](const FTargetEntry&) { return true; }, Predicate, OutTargets);
+}
+
+AActor* UTargetAcquisitionSubsystem::FindNearestTargetInCone(const FVector& Origin, const FVector& Direction, float HalfAngle, float MaxRadius, FTargetPredicate Predicate)
+{
+	const FVector ConeDirection = Direction.GetSafeNormal();
+	const float CosHalfAngle = FMath::Cos(FMath::DegreesToRadians(FMath::Clamp(HalfAngle, 0.f, 180.f)));
+
+	TArray<AActor*> Targets;
+	FindNearest(Origin, 1, MaxRadius, [&Origin, &ConeDirection, CosHalfAngle](const FTargetEntry& Entry)
+		{
+			return ((Entry.Location - Origin).GetSafeNormal() | ConeDirection) >= CosHalfAngle;
+		}, Predicate, Targets);
+
+	return Targets.IsEmpty() ? nullptr : Targets[0];
+}
+
+AActor* UTargetAcquisitionSubsystem::FindFirstTargetAlongRay(const FVector& Origin, const FVector& Direction, float MaxDistance, float Thickness, FTargetPredicate Predicate, float* OutDistance)
+{
+	SCOPE_CYCLE_COUNTER(STAT_TargetAcquisitionQuery);
+	UpdateGrid();
+
+	const FVector RayDirection = Direction.GetSafeNormal();
+	if (Entries.IsEmpty() || RayDirection.IsZero() || MaxDistance <= 0.f)
+	{
+		return nullptr;
+	}
+
+	//Cells are gathered around points of the ray, padded with the largest distance an entry can be from the ray and still be hit.
+	const float Reach = Thickness + MaxEntryRadius;
+	const int32 Padding = FMath::CeilToInt32(Reach / CellSize);
+	const float Step = CellSize * .5f;
+
+	TSet<FIntPoint> VisitedCells;
+	AActor* BestTarget = nullptr;
+	float BestDistance = MaxDistance;
+
+	for (float Traveled = 0.f; ; Traveled += Step)
+	{
+		const float Distance = FMath::Min(Traveled, MaxDistance);
+
+		//Cells from here on only hold entries that project further along the ray than the current hit.
+		if (BestTarget && Distance - (Padding + 1.5f) * CellSize > BestDistance)
+		{
+			break;
+		}
+
+		const FIntPoint Center = GetCell(Origin + RayDirection * Distance);
+		for (int32 X = -Padding; X <= Padding; X++)
+		{
+			for (int32 Y = -Padding; Y <= Padding; Y++)
+			{
+				const FIntPoint Cell(Center.X + X, Center.Y + Y);
+				bool bAlreadyVisited = false;
+				VisitedCells.Add(Cell, &bAlreadyVisited);
+				if (bAlreadyVisited)
+				{
+					continue;
+				}
+
+				for (const FTargetEntry& Entry : GetCellEntries(Cell))
+				{
+					const FVector ToTarget = Entry.Location - Origin;
+					const float Along = ToTarget | RayDirection;
+					const float HitRadius = Thickness + Entry.Radius;
+					const float LateralSquared = (ToTarget - RayDirection * Along).SizeSquared();
+					if (LateralSquared > HitRadius * HitRadius)
+					{
+						continue;
+					}
+
+					const float HitDistance = Along - FMath::Sqrt(HitRadius * HitRadius - LateralSquared);
+					if (HitDistance > BestDistance || Along < -HitRadius || (BestTarget && HitDistance >= BestDistance))
+					{
+						continue;
+					}
+
+					//Pawns destroyed this frame stay in the grid until the next rebuild.
+					if (!IsValid(Entry.Actor))
+					{
+						continue;
+					}
+
+					INC_DWORD_STAT(STAT_TargetAcquisitionFiltered);
+					if (Predicate(Entry.Actor))
+					{
+						BestTarget = Entry.Actor;
+						BestDistance = FMath::Max(0.f, HitDistance);
+					}
+				}
+			}
+		}
+
+		if (Distance >= MaxDistance)
+		{
+			break;
+		}
+	}
+
+	if (OutDistance && BestTarget)
+	{
+		*OutDistance = BestDistance;
+	}
+
+	return BestTarget;
+}
+
+int32 UTargetAcquisitionSubsystem::K2_FindNearestTargets(FVector Origin, int32 Count, float MaxRadius, const FGameplayTargetDataFilterHandle& Filter, TArray<AActor*>& OutTargets)
+{
+	return FindNearestTargets(Origin, Count, MaxRadius, [&Filter](const AActor* Actor) { return Filter.FilterPassesForActor(Actor); }, OutTargets);
+}
+
+AActor* UTargetAcquisitionSubsystem::K2_FindNearestTargetInCone(FVector Origin, FVector Direction, float HalfAngle, float MaxRadius, const FGameplayTargetDataFilterHandle& Filter)
+{
+	return FindNearestTargetInCone(Origin, Direction, HalfAngle, MaxRadius, [&Filter](const AActor* Actor) { return Filter.FilterPassesForActor(Actor); });
+}
+
+AActor* UTargetAcquisitionSubsystem::K2_FindFirstTargetAlongRay(FVector Origin, FVector Direction, float MaxDistance, float Thickness, const FGameplayTargetDataFilterHandle& Filter)
+{
+	return FindFirstTargetAlongRay(Origin, Direction, MaxDistance, Thickness, [&Filter](const AActor* Actor) { return Filter.FilterPassesForActor(Actor); });
+}
+
+void UTargetAcquisitionSubsystem::UpdateGrid()
+{
+	if (GridFrame == GFrameCounter)
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_TargetAcquisitionGrid);
+	GridFrame = GFrameCounter;
+	CellSize = FMath::Max(TargetAcquisitionCellSize, 50.f);
+	MaxEntryRadius = 0.f;
+	Entries.Reset();
+	Cells.Reset();
+
+	TArray<TPair<FIntPoint, FTargetEntry>> CellEntries;
+	for (TActorIterator<APawn> It(GetWorld()); It; ++It)
+	{
+		APawn* const Pawn = *It;
+		if (!IsValid(Pawn) || !Pawn->GetActorEnableCollision())
+		{
+			continue;
+		}
+
+		FTargetEntry Entry;
+		float HalfHeight = 0.f;
+		Entry.Actor = Pawn;
+		Entry.Location = Pawn->GetActorLocation();
+		Pawn->GetSimpleCollisionCylinder(Entry.Radius, HalfHeight);
+		MaxEntryRadius = FMath::Max(MaxEntryRadius, Entry.Radius);
+		CellEntries.Emplace(GetCell(Entry.Location), Entry);
+	}
+
+	CellEntries.Sort([](const TPair<FIntPoint, FTargetEntry>& A, const TPair<FIntPoint, FTargetEntry>& B)
+		{
+			return A.Key.X != B.Key.X ? A.Key.X < B.Key.X : A.Key.Y < B.Key.Y;
+		});
+
+	CellBounds = CellEntries.IsEmpty() ? FIntRect() : FIntRect(CellEntries[0].Key, CellEntries[0].Key);
+	Entries.Reserve(CellEntries.Num());
+	for (const TPair<FIntPoint, FTargetEntry>& it : CellEntries)
+	{
+		TPair<int32, int32>& Range = Cells.FindOrAdd(it.Key, TPair<int32, int32>(Entries.Num(), 0));
+		Range.Value++;
+		Entries.Add(it.Value);
+		CellBounds.Include(it.Key);
+	}
+}
+
+FIntPoint UTargetAcquisitionSubsystem::GetCell(const FVector& Location) const
+{
+	return FIntPoint(FMath::FloorToInt32(Location.X / CellSize), FMath::FloorToInt32(Location.Y / CellSize));
+}
+
+TArrayView<const UTargetAcquisitionSubsystem::FTargetEntry> UTargetAcquisitionSubsystem::GetCellEntries(const FIntPoint& Cell) const
+{
+	const TPair<int32, int32>* Range = Cells.Find(Cell);
+	return Range ? TArrayView<const FTargetEntry>(Entries.GetData() + Range->Key, Range->Value) : TArrayView<const FTargetEntry>();
+}
+
+int32 UTargetAcquisitionSubsystem::FindNearest(const FVector& Origin, int32 Count, float MaxRadius, TFunctionRef<bool(const FTargetEntry&)> Test, FTargetPredicate Predicate, TArray<AActor*>& OutTargets)
+{
+	SCOPE_CYCLE_COUNTER(STAT_TargetAcquisitionQuery);
+	UpdateGrid();
+
+	OutTargets.Reset();
+	if (Count <= 0 || Entries.IsEmpty())
+	{
+		return 0;
+	}
+
+	const FIntPoint OriginCell = GetCell(Origin);
+	const float MaxRadiusSquared = MaxRadius > 0.f ? MaxRadius * MaxRadius : MAX_flt;
+
+	//Never search past the occupied cells, or past the cells that can hold entries within the radius.
+	int32 MaxRing = FMath::Max(
+		FMath::Max(FMath::Abs(OriginCell.X - CellBounds.Min.X), FMath::Abs(CellBounds.Max.X - OriginCell.X)),
+		FMath::Max(FMath::Abs(OriginCell.Y - CellBounds.Min.Y), FMath::Abs(CellBounds.Max.Y - OriginCell.Y)));
+	if (MaxRadius > 0.f)
+	{
+		MaxRing = FMath::Min(MaxRing, FMath::FloorToInt32(MaxRadius / CellSize) + 1);
+	}
+
+	//Sorted by squared distance, nearest first.
+	TArray<TPair<float, AActor*>, TInlineAllocator<16>> Nearest;
+
+	for (int32 Ring = 0; Ring <= MaxRing; Ring++)
+	{
+		//Entries of this ring are at least Ring - 1 cells away.
+		const float RingDistance = (Ring - 1) * CellSize;
+		if (Nearest.Num() == Count && RingDistance > 0.f && RingDistance * RingDistance > Nearest.Last().Key)
+		{
+			break;
+		}
+
+		ForEachCellInRing(OriginCell, Ring, [&](const FIntPoint& Cell)
+			{
+				for (const FTargetEntry& Entry : GetCellEntries(Cell))
+				{
+					const float DistanceSquared = FVector::DistSquared(Origin, Entry.Location);
+					if (DistanceSquared > MaxRadiusSquared || (Nearest.Num() == Count && DistanceSquared >= Nearest.Last().Key))
+					{
+						continue;
+					}
+
+					if (!IsValid(Entry.Actor) || !Test(Entry))
+					{
+						continue;
+					}
+
+					INC_DWORD_STAT(STAT_TargetAcquisitionFiltered);
+					if (!Predicate(Entry.Actor))
+					{
+						continue;
+					}
+
+					const int32 InsertIndex = Algo::LowerBoundBy(Nearest, DistanceSquared, [](const TPair<float, AActor*>& it) { return it.Key; });
+					Nearest.Insert(TPair<float, AActor*>(DistanceSquared, Entry.Actor), InsertIndex);
+					if (Nearest.Num() > Count)
+					{
+						Nearest.RemoveAt(Count);
+					}
+				}
+			});
+	}
+
+	OutTargets.Reserve(Nearest.Num());
+	for (const TPair<float, AActor*>& it : Nearest)
+	{
+		OutTargets.Add(it.Value);
+	}
+
+	return OutTargets.Num();
+}
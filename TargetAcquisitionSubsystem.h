@@ -0,0 +1,86 @@
+// Copyright 2024 Marchetti S. César A. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Abilities/GameplayAbilityTargetDataFilter.h"
+#include "TargetAcquisitionSubsystem.generated.h"
+
+class APawn;
+
+/**
+*	Nearest target queries over the targetable pawns of the world, for target distributions and homing collision actors.
+*	Pawns are bucketed in a 2D grid rebuilt lazily once per frame, the first time a query runs. Distances are measured in 3D.
+*	Candidates are tested geometrically first, the target filter only runs on candidates that could make it into the result.
+*	Game thread only.
+*/
+UCLASS()
+class CAMERAPLAY_API UTargetAcquisitionSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Takes the actor mutable, so callers can run checks like IsAlreadyTargeted() on it.*/
+	using FTargetPredicate = TFunctionRef<bool(AActor*)>;
+
+	virtual void Deinitialize() override;
+
+	/** Up to Count targets within MaxRadius of the origin, nearest first. Returns the amount found.*/
+	int32 FindNearestTargets(const FVector& Origin, int32 Count, float MaxRadius, FTargetPredicate Predicate, TArray<AActor*>& OutTargets);
+
+	/** Nearest target within MaxRadius whose center is inside the cone. Null if there is none.*/
+	AActor* FindNearestTargetInCone(const FVector& Origin, const FVector& Direction, float HalfAngle, float MaxRadius, FTargetPredicate Predicate);
+
+	/** First target whose collision radius is touched by a ray of the given thickness. Null if there is none. OutDistance is the distance along the ray to the hit.*/
+	AActor* FindFirstTargetAlongRay(const FVector& Origin, const FVector& Direction, float MaxDistance, float Thickness, FTargetPredicate Predicate, float* OutDistance = nullptr);
+
+	UFUNCTION(BlueprintCallable, Category = "Targeting", meta = (DisplayName = "Find Nearest Targets"))
+	int32 K2_FindNearestTargets(FVector Origin, int32 Count, float MaxRadius, const FGameplayTargetDataFilterHandle& Filter, TArray<AActor*>& OutTargets);
+
+	UFUNCTION(BlueprintCallable, Category = "Targeting", meta = (DisplayName = "Find Nearest Target In Cone"))
+	AActor* K2_FindNearestTargetInCone(FVector Origin, FVector Direction, float HalfAngle, float MaxRadius, const FGameplayTargetDataFilterHandle& Filter);
+
+	UFUNCTION(BlueprintCallable, Category = "Targeting", meta = (DisplayName = "Find First Target Along Ray"))
+	AActor* K2_FindFirstTargetAlongRay(FVector Origin, FVector Direction, float MaxDistance, float Thickness, const FGameplayTargetDataFilterHandle& Filter);
+
+private:
+
+	struct FTargetEntry
+	{
+		AActor* Actor = nullptr;
+		FVector Location = FVector::ZeroVector;
+		float Radius = 0.f;
+	};
+
+	/** Rebuilds the grid if it was built on a previous frame.*/
+	void UpdateGrid();
+
+	FIntPoint GetCell(const FVector& Location) const;
+
+	/** Entries of a cell. Empty view if the cell has no pawns.*/
+	TArrayView<const FTargetEntry> GetCellEntries(const FIntPoint& Cell) const;
+
+	/**
+	*	Visits cells in rings of growing distance around the origin and keeps the Count nearest entries that pass the test and the predicate.
+	*	Stops once no entry of the remaining rings can be nearer than the current results.
+	*/
+	int32 FindNearest(const FVector& Origin, int32 Count, float MaxRadius, TFunctionRef<bool(const FTargetEntry&)> Test, FTargetPredicate Predicate, TArray<AActor*>& OutTargets);
+
+	/** Entries sorted by cell.*/
+	TArray<FTargetEntry> Entries;
+
+	/** First entry and amount of entries of each occupied cell.*/
+	TMap<FIntPoint, TPair<int32, int32>> Cells;
+
+	/** Bounds of the occupied cells, ring searches never go past them.*/
+	FIntRect CellBounds;
+
+	/** Largest collision radius of the entries, added to the ray thickness when gathering cells.*/
+	float MaxEntryRadius = 0.f;
+
+	float CellSize = 500.f;
+
+	uint64 GridFrame = MAX_uint64;
+};
@@ -0,0 +1,62 @@
+// Copyright 2024 Marchetti S. César A. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+
+/**
+*	Last hit time per target for one activation, and the amount of hits recorded.
+*	Periodic overlaps and collision actors use it to decide if a target can be hit again, instead of clearing and rebuilding their target lists every period.
+*	Channels split the history of a single activation, for example one per overlap so overlapping areas can hit the same target in the same period.
+*/
+struct FTargetHitHistory
+{
+	/** Minimum time between two hits on the same target and channel. 0 or less means a target can only be hit once.*/
+	float RetargetInterval = 0.f;
+
+	/** Whether or not the target can be hit at this time.*/
+	bool IsEligible(const AActor* Target, float Time, int32 Channel = INDEX_NONE) const
+	{
+		const FEntry* Entry = Entries.Find(FKey(Target, Channel));
+		return !Entry || (RetargetInterval > 0.f && Time - Entry->LastHitTime >= RetargetInterval * (1.f - RetargetTolerance));
+	}
+
+	void RecordHit(const AActor* Target, float Time, int32 Channel = INDEX_NONE)
+	{
+		FEntry& Entry = Entries.FindOrAdd(FKey(Target, Channel));
+		Entry.LastHitTime = Time;
+		NumHits++;
+	}
+
+	/** Hits recorded since the last reset, counting every retarget. The difference before and after recording a period is the amount of targets it hit.*/
+	int32 GetNumHits() const
+	{
+		return NumHits;
+	}
+
+	void Reset()
+	{
+		Entries.Reset();
+		NumHits = 0;
+	}
+
+private:
+
+	struct FEntry
+	{
+		float LastHitTime = 0.f;
+	};
+
+	using FKey = TPair<TObjectKey<AActor>, int32>;
+
+	TMap<FKey, FEntry> Entries;
+
+	int32 NumHits = 0;
+
+	/**
+	*	Hit times are scheduled times a whole interval apart, so this only absorbs float error. It is a fraction of the interval rather than a fixed time,
+	*	since times are absolute world times and their error grows with the uptime of the world.
+	*/
+	static constexpr float RetargetTolerance = .1f;
+};